@@ -217,12 +217,9 @@ template <typename T>
 size_t Codec<TYPE_INTEGER>::internal_from_bytes(bytes buf, T &val)
 {
   uint64_t val_tmp;
+  size_t sz = foundation::varint::decode(buf, val_tmp);
 
-  assert(buf.size() < (size_t)std::numeric_limits<int>::max());
-
-  google::protobuf::io::CodedInputStream input_buffer(buf.begin(), (int)buf.size());
-
-  if (!input_buffer.ReadVarint64(&val_tmp))
+  if (0 == sz)
   {
     throw Error(cdkerrc::conversion_error,
                 "Codec<TYPE_INTEGER>: integer conversion error");
@@ -233,13 +230,55 @@ size_t Codec<TYPE_INTEGER>::internal_from_bytes(bytes buf, T &val)
   else
     val = zigzag_decode_signed<T>(val_tmp);
 
-  assert(input_buffer.CurrentPosition() >= 0);
-  size_t sz = static_cast<size_t>(input_buffer.CurrentPosition());
-
   return sz;
 }
 
 
+template <typename T>
+void Codec<TYPE_INTEGER>::internal_from_bytes(
+  const bytes *bufs, size_t count, T *vals
+)
+{
+  static_assert(sizeof(T) == sizeof(uint64_t), "64-bit values expected");
+
+  /*
+    Varints are decoded in place and then converted, so that the format
+    check is done once for the whole batch and not for each value.
+  */
+
+  uint64_t *raw = reinterpret_cast<uint64_t*>(vals);
+
+  if (count != foundation::varint::decode(bufs, count, raw))
+  {
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_INTEGER>: integer conversion error");
+  }
+
+  if (m_fmt.is_unsigned())
+    for (size_t i = 0; i < count; ++i)
+      vals[i] = zigzag_decode_unsigned<T>(raw[i]);
+  else
+    for (size_t i = 0; i < count; ++i)
+      vals[i] = zigzag_decode_signed<T>(raw[i]);
+}
+
+
+void Codec<TYPE_INTEGER>::from_bytes(
+  const bytes *bufs, size_t count, int64_t *vals
+)
+{
+  internal_from_bytes(bufs, count, vals);
+}
+
+
+void Codec<TYPE_INTEGER>::from_bytes(
+  const bytes *bufs, size_t count, uint64_t *vals
+)
+{
+  internal_from_bytes(bufs, count, vals);
+}
+
+
 size_t Codec<TYPE_INTEGER>::from_bytes(bytes buf, int8_t &val)
 {
   return internal_from_bytes(buf, val);
@@ -419,6 +458,190 @@ std::string Codec<TYPE_FLOAT>::internal_decimal_to_string(bytes buf)
 }
 
 
+/*
+  Helpers for decoding DECIMAL values into 128-bit integers stored as two
+  64-bit halves.
+*/
+
+static const uint64_t pow10_64[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+  10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+
+// Multiply two 64-bit numbers giving 128-bit result.
+
+static inline
+void mul_64(uint64_t a, uint64_t b, uint64_t &high, uint64_t &low)
+{
+  uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+  uint64_t b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+
+  uint64_t p00 = a0 * b0;
+  uint64_t p01 = a0 * b1;
+  uint64_t p10 = a1 * b0;
+  uint64_t p11 = a1 * b1;
+
+  uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+
+  low  = (mid << 32) | (p00 & 0xFFFFFFFF);
+  high = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+
+/*
+  Replace 128-bit number (high, low) with (high, low) * mul + add. Returns
+  false on overflow.
+*/
+
+static inline
+bool mul_add_128(uint64_t &high, uint64_t &low, uint64_t mul, uint64_t add)
+{
+  uint64_t hh, hl, lh, ll;
+
+  mul_64(high, mul, hh, hl);
+  if (0 != hh)
+    return false;
+
+  mul_64(low, mul, lh, ll);
+
+  uint64_t new_high = hl + lh;
+  if (new_high < hl)
+    return false;
+
+  uint64_t new_low = ll + add;
+  if (new_low < ll && 0 == ++new_high)
+    return false;
+
+  high = new_high;
+  low = new_low;
+  return true;
+}
+
+
+bool Codec<TYPE_FLOAT>::Decimal::set_scale(unsigned scale)
+{
+  if (scale < m_scale)
+    return false;
+
+  while (m_scale < scale)
+  {
+    unsigned digits = std::min(scale - m_scale, 19U);
+    if (!mul_add_128(m_high, m_low, pow10_64[digits], 0))
+      return false;
+    m_scale += digits;
+  }
+
+  return true;
+}
+
+
+size_t Codec<TYPE_FLOAT>::from_bytes(bytes buf, Decimal &val)
+{
+  if (m_fmt.type() != cdk::Format<cdk::TYPE_FLOAT>::DECIMAL)
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_FLOAT>: value is not a DECIMAL number");
+
+  if (buf.size() < 2)
+    THROW("Invalid DECIMAL buffer");
+
+  const byte *pos = buf.begin();
+  const byte *last = buf.end() - 1;
+  byte sign_byte = *last;
+
+  unsigned scale = *pos++;
+  bool is_negative;
+  bool last_digit;
+
+  // See internal_decimal_to_string() for the format of the sign byte.
+
+  if ((sign_byte & 0x0C) == 0x0C)
+  {
+    last_digit = true;
+    is_negative = (sign_byte & 0x0D) == 0x0D;
+  }
+  else if ((sign_byte & 0xC0) == 0xC0)
+  {
+    last_digit = false;
+    is_negative = (sign_byte & 0xD0) == 0xD0;
+  }
+  else
+    THROW("Invalid DECIMAL buffer");
+
+  size_t total_digits = 2*(size_t)(last - pos) + (last_digit ? 1 : 0);
+  if (total_digits <= scale)
+    THROW("Invalid DECIMAL buffer");
+
+  /*
+    Digits are collected in a 64-bit chunk and added to the 128-bit result
+    once 19 of them are collected (the most that always fit in 64 bits).
+    Thus values with up to 19 digits never use 128-bit arithmetic.
+  */
+
+  uint64_t high = 0;
+  uint64_t low = 0;
+  uint64_t chunk = 0;
+  unsigned chunk_len = 0;
+  bool     valid = true;
+
+  auto flush = [&]() -> bool
+  {
+    if (!mul_add_128(high, low, pow10_64[chunk_len], chunk))
+      return false;
+    chunk = 0;
+    chunk_len = 0;
+    return true;
+  };
+
+  for (; pos < last; ++pos)
+  {
+    unsigned d1 = *pos >> 4;
+    unsigned d2 = *pos & 0x0F;
+
+    valid = valid && d1 < 10 && d2 < 10;
+
+    if (chunk_len > 17 && !flush())
+      return 0;
+
+    chunk = chunk * 100 + d1 * 10 + d2;
+    chunk_len += 2;
+  }
+
+  if (last_digit)
+  {
+    unsigned d = sign_byte >> 4;
+    valid = valid && d < 10;
+
+    if (chunk_len > 18 && !flush())
+      return 0;
+
+    chunk = chunk * 10 + d;
+    chunk_len++;
+  }
+
+  if (!valid)
+    THROW("Invalid DECIMAL buffer");
+
+  if (!flush())
+    return 0;
+
+  /*
+    Note: 38 digits always fit in 128 bits, but we also accept values with
+    more digits if they fit (e.g., with leading zeros).
+  */
+
+  val.m_high = high;
+  val.m_low = low;
+  val.m_scale = scale;
+  val.m_negative = is_negative;
+
+  return buf.size();
+}
+
+
 size_t Codec<TYPE_FLOAT>::from_bytes(bytes buf, float &val)
 {
   if (m_fmt.type() == cdk::Format<cdk::TYPE_FLOAT>::DECIMAL)
@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include <mysql/cdk.h>
+#include <mysql/cdk/foundation/cdk_time.h>
 
 
 using ::std::cout;
@@ -190,6 +191,74 @@ TEST_F(Session_core, default_schema)
 }
 
 
+/*
+  Resetting session clears its state but the session stays usable and
+  its current schema is the default one.
+*/
+
+TEST_F(Session_core, reset)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  try
+  {
+    ds::TCPIP ds("localhost", m_port);
+    ds::TCPIP::Options options("root");
+    options.set_database("test");
+
+    cdk::Session s(ds, options);
+
+    {
+      Reply r(s.sql(L"SET @var = 1"));
+      r.wait();
+      Reply r1(s.sql(L"USE mysql"));
+      r1.wait();
+    }
+
+    s.reset();
+
+    if (!s.is_valid())
+      FAIL() << "Invalid Session after reset()";
+
+    EXPECT_EQ(string("test"), s.current_schema());
+
+    struct : cdk::Row_processor
+    {
+      unsigned m_rows = 0;
+
+      bool row_begin(row_count_t)
+      {
+        m_rows++;
+        return true;
+      }
+      void row_end(row_count_t) {}
+      void field_null(col_count_t) {}
+      size_t field_begin(col_count_t, size_t) { return 0; }
+      size_t field_data(col_count_t, bytes) { return 0; }
+      void field_end(col_count_t) {}
+      void end_of_data() {}
+    }
+    prc;
+
+    // User variable set before reset is gone.
+
+    Reply r(s.sql(L"SELECT 1 FROM DUAL WHERE @var IS NULL"));
+    r.wait();
+    ASSERT_EQ(0U, r.entry_count());
+
+    Cursor c(r);
+    c.get_rows(prc);
+    c.wait();
+
+    EXPECT_EQ(1U, prc.m_rows);
+  }
+  catch (Error &e)
+  {
+    FAIL() << "CDK error: " << e << endl;
+  }
+}
+
+
 TEST_F(Session_core, sql_basic)
 {
   try {
@@ -600,6 +669,110 @@ TEST_F(Session_core, affected)
 }
 
 
+/*
+  Test sending several commands before consuming replies to earlier ones.
+*/
+
+TEST_F(Session_core, pipeline)
+{
+  try {
+    SKIP_IF_NO_XPLUGIN;
+
+    Session s(this);
+
+    if (!s.is_valid())
+      FAIL() << "Invalid Session!";
+
+    do_sql(s, L"DROP TABLE IF EXISTS test.pipeline");
+    do_sql(s, L"CREATE TABLE test.pipeline (c0 INT)");
+
+    {
+      cout << "sending commands" << endl;
+
+      Reply r1(s.sql(L"INSERT INTO test.pipeline VALUES (1),(2),(3)"));
+      Reply r2(s.sql(L"SELECT c0 FROM test.pipeline"));
+      Reply r3(s.sql(L"SELECT 'foo'"));
+
+      EXPECT_FALSE(r2.is_completed());
+      EXPECT_FALSE(r3.is_completed());
+
+      // Replies are consumed in the order in which commands were sent.
+
+      r1.wait();
+      EXPECT_EQ(0, r1.entry_count());
+      EXPECT_FALSE(r1.has_results());
+
+      EXPECT_TRUE(r2.has_results());
+      {
+        Cursor c(r2);
+        set_meta_data(c);
+        c.get_rows(*this);
+        c.wait();
+        EXPECT_EQ(cdk::TYPE_INTEGER, c.type(0));
+      }
+      EXPECT_FALSE(r2.has_results());
+
+      // Statistics of r1 are still available.
+
+      EXPECT_EQ(3, r1.affected_rows());
+
+      EXPECT_TRUE(r3.has_results());
+      {
+        Cursor c(r3);
+        set_meta_data(c);
+        c.get_rows(*this);
+        c.wait();
+        EXPECT_EQ(cdk::TYPE_STRING, c.type(0));
+      }
+    }
+
+    {
+      cout << "discarding reply before reading it" << endl;
+
+      Reply r1(s.sql(L"SELECT c0 FROM test.pipeline"));
+
+      {
+        Reply r2(s.sql(L"SELECT no_such_column FROM test.pipeline"));
+      }
+
+      Reply r3(s.sql(L"DELETE FROM test.pipeline"));
+
+      EXPECT_TRUE(r1.has_results());
+      {
+        Cursor c(r1);
+        set_meta_data(c);
+        c.get_rows(*this);
+        c.wait();
+      }
+
+      // Error from discarded reply r2 is not reported by r3.
+
+      r3.wait();
+      EXPECT_EQ(0, r3.entry_count());
+      EXPECT_EQ(3, r3.affected_rows());
+    }
+
+    {
+      cout << "reading later reply first" << endl;
+
+      Reply r1(s.sql(L"SELECT 1"));
+      Reply r2(s.sql(L"SELECT 2"));
+
+      // Reply r1 is skipped when reading r2.
+
+      EXPECT_TRUE(r2.has_results());
+      EXPECT_FALSE(r1.has_results());
+    }
+
+    do_sql(s, L"DROP TABLE IF EXISTS test.pipeline");
+
+    cout << "Done!" << endl;
+
+  }
+  CATCH_TEST_GENERIC
+}
+
+
 /*
   Test handling of multi-result-sets
 */
@@ -1504,3 +1677,139 @@ TEST_F(Session_core, external_auth)
 
 }
 
+
+
+/*
+  Drive replies of several sessions from a single event loop. Queries that
+  take less time should complete first and all of them should be executed
+  concurrently.
+*/
+
+TEST_F(Session_core, event_loop)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  using cdk::foundation::get_time;
+
+  try {
+
+    const unsigned N = 3;
+    const char *queries[N] = {
+      "SELECT SLEEP(0.6)",
+      "SELECT SLEEP(0.2)",
+      "SELECT SLEEP(0.4)"
+    };
+
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::vector<std::unique_ptr<Reply>> replies;
+    std::vector<unsigned> done;
+    Event_loop loop;
+
+    for (unsigned i = 0; i < N; ++i)
+      sessions.emplace_back(new Session(this));
+
+    auto start = get_time();
+
+    for (unsigned i = 0; i < N; ++i)
+    {
+      replies.emplace_back(new Reply(sessions[i]->sql(queries[i])));
+      loop.add(*replies.back(), [i, &done](std::exception_ptr err) {
+        EXPECT_FALSE(err);
+        done.push_back(i);
+      });
+    }
+
+    loop.run();
+
+    auto stop = get_time();
+    cout << "Queries completed in " << (stop - start) << "ms" << endl;
+
+    ASSERT_EQ(N, done.size());
+    EXPECT_EQ(1U, done[0]);
+    EXPECT_EQ(2U, done[1]);
+    EXPECT_EQ(0U, done[2]);
+
+    // Queries were executed concurrently, not one after another.
+
+    EXPECT_GT(1100, stop - start);
+
+    for (unsigned i = 0; i < N; ++i)
+    {
+      EXPECT_EQ(0U, replies[i]->entry_count());
+      EXPECT_TRUE(replies[i]->has_results());
+      replies[i]->discard();
+    }
+  }
+  CATCH_TEST_GENERIC
+}
+
+
+#ifdef WITH_SSL
+
+/*
+  The same over TLS connections. TLS I/O operations should not block the
+  event loop and data already buffered by the TLS layer should be processed
+  without waiting for the socket.
+*/
+
+TEST_F(Session_core, event_loop_tls)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  using cdk::foundation::get_time;
+
+  try {
+
+    const unsigned N = 3;
+    const char *queries[N] = {
+      "SELECT SLEEP(0.6), REPEAT('a', 100000)",
+      "SELECT SLEEP(0.2), REPEAT('b', 100000)",
+      "SELECT SLEEP(0.4), REPEAT('c', 100000)"
+    };
+
+    ds::TCPIP::Options options(get_opts());
+    options.set_tls(
+      connection::TLS::Options(connection::TLS::Options::SSL_MODE::REQUIRED)
+    );
+
+    std::vector<std::unique_ptr<cdk::Session>> sessions;
+    std::vector<std::unique_ptr<Reply>> replies;
+    std::vector<unsigned> done;
+    Event_loop loop;
+
+    for (unsigned i = 0; i < N; ++i)
+      sessions.emplace_back(new cdk::Session(get_ds(), options));
+
+    auto start = get_time();
+
+    for (unsigned i = 0; i < N; ++i)
+    {
+      replies.emplace_back(new Reply(sessions[i]->sql(queries[i])));
+      loop.add(*replies.back(), [i, &done](std::exception_ptr err) {
+        EXPECT_FALSE(err);
+        done.push_back(i);
+      });
+    }
+
+    loop.run();
+
+    auto stop = get_time();
+    cout << "Queries completed in " << (stop - start) << "ms" << endl;
+
+    ASSERT_EQ(N, done.size());
+    EXPECT_EQ(1U, done[0]);
+    EXPECT_EQ(2U, done[1]);
+    EXPECT_EQ(0U, done[2]);
+
+    EXPECT_GT(1100, stop - start);
+
+    for (unsigned i = 0; i < N; ++i)
+    {
+      EXPECT_TRUE(replies[i]->has_results());
+      replies[i]->discard();
+    }
+  }
+  CATCH_TEST_GENERIC
+}
+
+#endif
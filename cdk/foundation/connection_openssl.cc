@@ -247,6 +247,12 @@ void connection_TLS_impl::do_connect()
 
     unsigned int fd = m_tcpip->get_fd();
 
+    /*
+      The TLS handshake is done in blocking mode. After that the socket is
+      switched to non-blocking mode so that TLS I/O operations do not block
+      in their cont() method (see TLS::IO_op).
+    */
+
     cdk::foundation::connection::detail::set_nonblocking(fd, false);
 
 #ifdef WITH_SSL_YASSL
@@ -264,6 +270,8 @@ void connection_TLS_impl::do_connect()
         )
       verify_server_cert();
 
+    cdk::foundation::connection::detail::set_nonblocking(fd, true);
+
   }
   catch (...)
   {
@@ -428,9 +436,77 @@ Socket_base::Impl& TLS::get_base_impl()
 }
 
 
-TLS::Read_op::Read_op(TLS &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
+unsigned int TLS::get_fd() const
+{
+  return get_impl().m_tcpip->get_fd();
+}
+
+
+TLS::IO_op::IO_op(TLS &conn, const buffers &bufs,
+                  api::Event_info::event_type type, time_t deadline)
+  : Socket_base::IO_op(conn, bufs, type, deadline)
   , m_tls(conn)
+  , m_type(type)
+{}
+
+
+size_t TLS::IO_op::check_result(int result)
+{
+  if (result > 0)
+  {
+    m_event.set_type(m_type);
+    return static_cast<size_t>(result);
+  }
+
+  connection_TLS_impl& impl = m_tls.get_impl();
+
+  switch (SSL_get_error(impl.m_tls, result))
+  {
+  case SSL_ERROR_WANT_READ:
+    m_event.set_type(api::Event_info::SOCKET_RD);
+    return 0;
+
+  case SSL_ERROR_WANT_WRITE:
+    m_event.set_type(api::Event_info::SOCKET_WR);
+    return 0;
+
+  case SSL_ERROR_ZERO_RETURN:
+    throw Error_eos();
+
+  default:
+    throw IO_error(SSL_get_error(impl.m_tls, result));
+  }
+}
+
+
+void TLS::IO_op::wait_socket()
+{
+  if (!get_event_info())
+    return;
+
+  detail::poll_one(
+    m_tls.get_fd(),
+    api::Event_info::SOCKET_RD == m_event.type() ?
+      detail::POLL_MODE_READ : detail::POLL_MODE_WRITE,
+    true
+  );
+}
+
+
+const api::Event_info* TLS::IO_op::get_event_info() const
+{
+  // Data buffered in the TLS layer can be read without waiting.
+
+  if (api::Event_info::SOCKET_RD == m_type
+      && 0 < SSL_pending(m_tls.get_impl().m_tls))
+    return NULL;
+
+  return &m_event;
+}
+
+
+TLS::Read_op::Read_op(TLS &conn, const buffers &bufs, time_t deadline)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_RD, deadline)
   , m_currentBufferIdx(0)
   , m_currentBufferOffset(0)
 {
@@ -449,8 +525,8 @@ bool TLS::Read_op::do_cont()
 
 void TLS::Read_op::do_wait()
 {
-  while (!is_completed())
-    common_read();
+  while (!common_read())
+    wait_socket();
 }
 
 
@@ -465,24 +541,19 @@ bool TLS::Read_op::common_read()
   byte* data =buffer.begin() + m_currentBufferOffset;
   int buffer_size = static_cast<int>(buffer.size() - m_currentBufferOffset);
 
-  int result = SSL_read(impl.m_tls, data, buffer_size);
+  m_currentBufferOffset += check_result(
+    SSL_read(impl.m_tls, data, buffer_size)
+  );
 
-  if (result == -1)
-    throw IO_error(SSL_get_error(impl.m_tls,0));
-
-  if (result > 0)
+  if (m_currentBufferOffset == buffer.size())
   {
-    m_currentBufferOffset += result;
+    ++m_currentBufferIdx;
+    m_currentBufferOffset = 0;
 
-    if (m_currentBufferOffset == buffer.size())
+    if (m_currentBufferIdx == m_bufs.buf_count())
     {
-      ++m_currentBufferIdx;
-
-      if (m_currentBufferIdx == m_bufs.buf_count())
-      {
-        set_completed(m_bufs.length());
-        return true;
-      }
+      set_completed(m_bufs.length());
+      return true;
     }
   }
 
@@ -491,8 +562,7 @@ bool TLS::Read_op::common_read()
 
 
 TLS::Read_some_op::Read_some_op(TLS &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
-  , m_tls(conn)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_RD, deadline)
 {
   connection_TLS_impl& impl = m_tls.get_impl();
 
@@ -509,8 +579,8 @@ bool TLS::Read_some_op::do_cont()
 
 void TLS::Read_some_op::do_wait()
 {
-  while (!is_completed())
-    common_read();
+  while (!common_read())
+    wait_socket();
 }
 
 
@@ -523,21 +593,20 @@ bool TLS::Read_some_op::common_read()
 
   const bytes& buffer = m_bufs.get_buffer(0);
 
-  int result = SSL_read(impl.m_tls, buffer.begin(), (int)buffer.size());
+  size_t count = check_result(
+    SSL_read(impl.m_tls, buffer.begin(), (int)buffer.size())
+  );
 
-  if (result > 0)
-  {
-    set_completed(static_cast<size_t>(result));
-    return true;
-  }
+  if (0 == count)
+    return false;
 
-  return false;
+  set_completed(count);
+  return true;
 }
 
 
 TLS::Write_op::Write_op(TLS &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
-  , m_tls(conn)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_WR, deadline)
   , m_currentBufferIdx(0)
   , m_currentBufferOffset(0)
 {
@@ -556,8 +625,8 @@ bool TLS::Write_op::do_cont()
 
 void TLS::Write_op::do_wait()
 {
-  while (!is_completed())
-    common_write();
+  while (!common_write())
+    wait_socket();
 }
 
 
@@ -572,21 +641,19 @@ bool TLS::Write_op::common_write()
   byte* data = buffer.begin() + m_currentBufferOffset;
   int buffer_size = static_cast<int>(buffer.size() - m_currentBufferOffset);
 
-  int result = SSL_write(impl.m_tls, data, buffer_size);
+  m_currentBufferOffset += check_result(
+    SSL_write(impl.m_tls, data, buffer_size)
+  );
 
-  if (result > 0)
+  if (m_currentBufferOffset == buffer.size())
   {
-    m_currentBufferOffset += result;
+    ++m_currentBufferIdx;
+    m_currentBufferOffset = 0;
 
-    if (m_currentBufferOffset == buffer.size())
+    if (m_currentBufferIdx == m_bufs.buf_count())
     {
-      ++m_currentBufferIdx;
-
-      if (m_currentBufferIdx == m_bufs.buf_count())
-      {
-        set_completed(m_bufs.length());
-        return true;
-      }
+      set_completed(m_bufs.length());
+      return true;
     }
   }
 
@@ -595,8 +662,7 @@ bool TLS::Write_op::common_write()
 
 
 TLS::Write_some_op::Write_some_op(TLS &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
-  , m_tls(conn)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_WR, deadline)
 {
   connection_TLS_impl& impl = m_tls.get_impl();
 
@@ -613,8 +679,8 @@ bool TLS::Write_some_op::do_cont()
 
 void TLS::Write_some_op::do_wait()
 {
-  while (!is_completed())
-    common_write();
+  while (!common_write())
+    wait_socket();
 }
 
 
@@ -627,15 +693,15 @@ bool TLS::Write_some_op::common_write()
 
   const bytes& buffer = m_bufs.get_buffer(0);
 
-  int result = SSL_write(impl.m_tls, buffer.begin(), (int)buffer.size());
+  size_t count = check_result(
+    SSL_write(impl.m_tls, buffer.begin(), (int)buffer.size())
+  );
 
-  if (result > 0)
-  {
-    set_completed(static_cast<size_t>(result));
-    return true;
-  }
+  if (0 == count)
+    return false;
 
-  return false;
+  set_completed(count);
+  return true;
 }
 
 
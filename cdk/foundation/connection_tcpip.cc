@@ -150,7 +150,7 @@ void Socket_base::IO_op::do_cancel()
 
 
 Socket_base::Read_op::Read_op(Socket_base &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_RD, deadline)
   , m_currentBufferIdx(0)
   , m_currentBufferOffset(0)
 {
@@ -212,7 +212,7 @@ void Socket_base::Read_op::do_wait()
 
 
 Socket_base::Read_some_op::Read_some_op(Socket_base &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_RD, deadline)
 {
   Impl &impl = conn.get_base_impl();
 
@@ -250,7 +250,7 @@ void Socket_base::Read_some_op::common_read(bool wait)
 
 
 Socket_base::Write_op::Write_op(Socket_base &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_WR, deadline)
   , m_currentBufferIdx(0)
   , m_currentBufferOffset(0)
 {
@@ -312,7 +312,7 @@ void Socket_base::Write_op::do_wait()
 
 
 Socket_base::Write_some_op::Write_some_op(Socket_base &conn, const buffers &bufs, time_t deadline)
-  : IO_op(conn, bufs, deadline)
+  : IO_op(conn, bufs, api::Event_info::SOCKET_WR, deadline)
 {
   Impl &impl = conn.get_base_impl();
 
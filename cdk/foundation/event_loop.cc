@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <mysql/cdk/foundation/common.h>
+#include <mysql/cdk/foundation/event_loop.h>
+#include <mysql/cdk/foundation/connection_tcpip.h>
+#include <mysql/cdk/foundation/error.h>
+#include <mysql/cdk/foundation/opaque_impl.i>
+#include <mysql/cdk/config.h>
+#include "socket_detail.h"
+
+PUSH_SYS_WARNINGS
+#include <list>
+#include <map>
+#include <vector>
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#include <errno.h>
+#endif
+POP_SYS_WARNINGS
+
+
+using namespace cdk::foundation;
+using cdk::foundation::connection::Socket_base;
+using cdk::foundation::connection::detail::Socket;
+
+
+namespace {
+
+enum { EV_READ = 1, EV_WRITE = 2 };
+
+/*
+  Operation registered with the loop. If m_ready is true, the operation
+  will be given cont() call in the next iteration of the loop. Otherwise
+  it waits for socket m_fd to become readable or writable, as indicated by
+  m_events. Entries of operations removed from the loop have m_op set to
+  NULL and are erased later.
+*/
+
+struct Entry
+{
+  api::Async_op_base *m_op;
+  Event_loop::Callback m_cb;
+  bool     m_ready;
+  Socket   m_fd;
+  unsigned m_events;
+
+  Entry(api::Async_op_base &op, const Event_loop::Callback &cb)
+    : m_op(&op), m_cb(cb), m_ready(true)
+    , m_fd(connection::detail::NULL_SOCKET), m_events(0)
+  {}
+};
+
+typedef std::map<Socket, unsigned> Fd_map;
+
+}  // anonymous namespace
+
+
+/*
+  Implementation of the loop. Socket events are waited for using epoll
+  if available or poll() (WSAPoll() on Windows) otherwise.
+*/
+
+class Event_loop_impl
+{
+public:
+
+  std::list<Entry> m_ops;
+
+  Event_loop_impl();
+  ~Event_loop_impl();
+
+  bool run_once(int timeout);
+
+private:
+
+  /*
+    Wait for events on given sockets, at most `timeout` milliseconds.
+    Sockets which are ready are stored in `ready` map, together with
+    events that happened on them.
+  */
+
+  void wait(const Fd_map &wanted, int timeout, Fd_map &ready);
+
+#ifdef HAVE_SYS_EPOLL_H
+
+  int    m_epoll;
+  Fd_map m_registered;
+  std::vector<epoll_event> m_events;
+
+  void epoll_update(const Fd_map &wanted);
+
+#else
+
+  std::vector<pollfd> m_fds;
+
+#endif
+};
+
+
+IMPL_TYPE(cdk::foundation::Event_loop, Event_loop_impl);
+IMPL_DEFAULT(cdk::foundation::Event_loop);
+
+
+Event_loop_impl::Event_loop_impl()
+{
+#ifdef HAVE_SYS_EPOLL_H
+  m_epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (0 > m_epoll)
+    throw_posix_error("Event loop");
+#endif
+}
+
+
+Event_loop_impl::~Event_loop_impl()
+{
+#ifdef HAVE_SYS_EPOLL_H
+  ::close(m_epoll);
+#endif
+}
+
+
+bool Event_loop_impl::run_once(int timeout)
+{
+  /*
+    Push forward operations that are ready. Completed operations are removed
+    from the list before calling their callbacks, so that callbacks can
+    add or remove operations.
+  */
+
+  bool busy = false;
+
+  for (auto it = m_ops.begin(); it != m_ops.end();)
+  {
+    Entry &entry = *it;
+
+    if (!entry.m_op)
+    {
+      it = m_ops.erase(it);
+      continue;
+    }
+
+    if (!entry.m_ready)
+    {
+      ++it;
+      continue;
+    }
+
+    std::exception_ptr error;
+
+    try {
+      entry.m_op->cont();
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    if (error || entry.m_op->is_completed())
+    {
+      Event_loop::Callback cb = entry.m_cb;
+      it = m_ops.erase(it);
+      if (cb)
+        cb(error);
+      continue;
+    }
+
+    const api::Event_info *info = entry.m_op->waits_for();
+
+    if (info && (api::Event_info::SOCKET_RD == info->type()
+                 || api::Event_info::SOCKET_WR == info->type()))
+    {
+      const Socket_base::Event_info *sock_info
+        = static_cast<const Socket_base::Event_info*>(info);
+
+      entry.m_ready = false;
+      entry.m_fd = (Socket)sock_info->get_fd();
+      entry.m_events
+        = api::Event_info::SOCKET_RD == info->type() ? EV_READ : EV_WRITE;
+    }
+    else
+    {
+      // Operation does not tell what it waits for, try again next time.
+      busy = true;
+    }
+
+    ++it;
+  }
+
+  // Collect sockets of waiting operations.
+
+  Fd_map wanted;
+
+  for (Entry &entry : m_ops)
+  {
+    if (entry.m_op && !entry.m_ready)
+      wanted[entry.m_fd] |= entry.m_events;
+  }
+
+  if (wanted.empty() && !busy)
+    return !m_ops.empty();
+
+  Fd_map ready;
+  wait(wanted, busy ? 0 : timeout, ready);
+
+  /*
+    Mark operations whose sockets are ready. Note that errors and hang-ups
+    are reported with all events set so that the operation can see them.
+  */
+
+  for (Entry &entry : m_ops)
+  {
+    if (!entry.m_op || entry.m_ready)
+      continue;
+
+    Fd_map::const_iterator ev = ready.find(entry.m_fd);
+    if (ev != ready.end() && (ev->second & entry.m_events))
+      entry.m_ready = true;
+  }
+
+  return !m_ops.empty();
+}
+
+
+#ifdef HAVE_SYS_EPOLL_H
+
+/*
+  Bring the interest set of the epoll instance in sync with sockets we
+  want to wait for.
+
+  Note: A socket that was closed is automatically removed from the epoll
+  interest set and its descriptor can be re-used for a new socket. This is
+  why EPOLL_CTL_MOD failing with ENOENT is followed by EPOLL_CTL_ADD.
+*/
+
+void Event_loop_impl::epoll_update(const Fd_map &wanted)
+{
+  for (auto it = m_registered.begin(); it != m_registered.end();)
+  {
+    if (wanted.count(it->first))
+    {
+      ++it;
+      continue;
+    }
+
+    // Errors are ignored: socket could have been closed already.
+
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, it->first, NULL);
+    it = m_registered.erase(it);
+  }
+
+  for (const auto &fd : wanted)
+  {
+    auto reg = m_registered.find(fd.first);
+
+    if (reg != m_registered.end() && reg->second == fd.second)
+      continue;
+
+    epoll_event ev = {};
+    ev.data.fd = fd.first;
+    ev.events = (fd.second & EV_READ ? EPOLLIN : 0u)
+              | (fd.second & EV_WRITE ? EPOLLOUT : 0u);
+
+    int op = (reg != m_registered.end() ? EPOLL_CTL_MOD : EPOLL_CTL_ADD);
+    int rc = epoll_ctl(m_epoll, op, fd.first, &ev);
+
+    if (0 > rc && EPOLL_CTL_MOD == op && ENOENT == errno)
+      rc = epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd.first, &ev);
+    else if (0 > rc && EPOLL_CTL_ADD == op && EEXIST == errno)
+      rc = epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd.first, &ev);
+
+    if (0 > rc)
+      throw_posix_error("Event loop");
+
+    m_registered[fd.first] = fd.second;
+  }
+}
+
+
+void Event_loop_impl::wait(const Fd_map &wanted, int timeout, Fd_map &ready)
+{
+  epoll_update(wanted);
+
+  if (wanted.empty())
+    return;
+
+  m_events.resize(wanted.size());
+
+  int cnt = epoll_wait(m_epoll, m_events.data(), (int)m_events.size(),
+                       timeout);
+
+  if (0 > cnt)
+  {
+    if (EINTR == errno)
+      return;
+    throw_posix_error("Event loop");
+  }
+
+  for (int i = 0; i < cnt; ++i)
+  {
+    const epoll_event &ev = m_events[i];
+    unsigned events = 0;
+
+    if (ev.events & (EPOLLERR | EPOLLHUP))
+      events = EV_READ | EV_WRITE;
+    if (ev.events & EPOLLIN)
+      events |= EV_READ;
+    if (ev.events & EPOLLOUT)
+      events |= EV_WRITE;
+
+    ready[ev.data.fd] = events;
+  }
+}
+
+#else
+
+void Event_loop_impl::wait(const Fd_map &wanted, int timeout, Fd_map &ready)
+{
+  if (wanted.empty())
+    return;
+
+  m_fds.clear();
+
+  for (const auto &fd : wanted)
+  {
+    pollfd pfd = {};
+    pfd.fd = fd.first;
+    pfd.events = (fd.second & EV_READ ? POLLIN : 0)
+               | (fd.second & EV_WRITE ? POLLOUT : 0);
+    m_fds.push_back(pfd);
+  }
+
+#ifdef _WIN32
+  int cnt = ::WSAPoll(m_fds.data(), (ULONG)m_fds.size(), timeout);
+#else
+  int cnt = ::poll(m_fds.data(), (nfds_t)m_fds.size(), timeout);
+#endif
+
+  if (0 > cnt)
+  {
+#ifndef _WIN32
+    if (EINTR == errno)
+      return;
+#endif
+    throw_system_error("Event loop");
+  }
+
+  for (const pollfd &pfd : m_fds)
+  {
+    unsigned events = 0;
+
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+      events = EV_READ | EV_WRITE;
+    if (pfd.revents & POLLIN)
+      events |= EV_READ;
+    if (pfd.revents & POLLOUT)
+      events |= EV_WRITE;
+
+    if (events)
+      ready[pfd.fd] = events;
+  }
+}
+
+#endif
+
+
+/*
+  Event_loop
+*/
+
+namespace cdk {
+namespace foundation {
+
+
+Event_loop::Event_loop()
+{}
+
+
+void Event_loop::add(api::Async_op_base &op, const Callback &callback)
+{
+  get_impl().m_ops.emplace_back(op, callback);
+}
+
+
+bool Event_loop::remove(api::Async_op_base &op)
+{
+  for (Entry &entry : get_impl().m_ops)
+  {
+    if (entry.m_op == &op)
+    {
+      entry.m_op = NULL;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+size_t Event_loop::size() const
+{
+  size_t count = 0;
+  for (const Entry &entry : get_impl().m_ops)
+    if (entry.m_op)
+      ++count;
+  return count;
+}
+
+
+bool Event_loop::run_once(int timeout)
+{
+  return get_impl().run_once(timeout);
+}
+
+
+void Event_loop::run()
+{
+  while (run_once())
+  {}
+}
+
+
+}}  // cdk::foundation
@@ -284,6 +284,47 @@ static void throw_socket_error()
 }
 
 
+/**
+  Tells if the last socket operation failed because it would block.
+*/
+static bool would_block()
+{
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+
+/**
+  Tells if the last socket operation was interrupted by a signal and should
+  be retried.
+*/
+static bool interrupted()
+{
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEINTR;
+#else
+  return errno == EINTR;
+#endif
+}
+
+
+/*
+  Flags passed to recv() and send(). Where available, MSG_DONTWAIT ensures
+  that a single call never blocks, regardless of the blocking mode of the
+  socket. This lets recv_some() and send_some() try the I/O first and wait
+  for socket readiness only if it would block.
+*/
+
+#ifdef MSG_DONTWAIT
+static const int io_flags = MSG_DONTWAIT;
+#else
+static const int io_flags = 0;
+#endif
+
+
 /**
   Checks socket's state for errors. If an error is encountered, the appropriate
   exception is thrown.
@@ -588,9 +629,9 @@ Socket connect(const char *host_name, unsigned short port)
         if (connect_result == SOCKET_ERROR && errno == EINPROGRESS)
       #endif
         {
-          int select_result = select_one(socket, SELECT_MODE_WRITE, true);
+          int poll_result = poll_one(socket, POLL_MODE_WRITE, true);
 
-          if (select_result < 0)
+          if (poll_result < 0)
             throw_socket_error();
           else
             check_socket_error(socket);
@@ -613,6 +654,17 @@ Socket connect(const char *host_name, unsigned short port)
     }
   }
 
+  /*
+    Disable Nagle's algorithm. Messages sent together are already written
+    to the socket in one go by the protocol layer and delaying small
+    writes only adds latency to request-reply exchanges. Errors are ignored
+    as this is only an optimization.
+  */
+
+  int nodelay = 1;
+  ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY,
+               (const char*)&nodelay, sizeof(nodelay));
+
   return socket;
 }
 
@@ -643,9 +695,9 @@ Socket connect(const char *path)
     {
       if (connect_result == SOCKET_ERROR && errno == EINPROGRESS)
       {
-        int select_result = select_one(socket, SELECT_MODE_WRITE, true);
+        int poll_result = poll_one(socket, POLL_MODE_WRITE, true);
 
-        if (select_result < 0)
+        if (poll_result < 0)
           throw_socket_error();
         else
           check_socket_error(socket);
@@ -686,9 +738,9 @@ Socket listen_and_accept(unsigned short port)
       throw_socket_error();
     }
 
-    int select_result = select_one(acceptor, SELECT_MODE_READ, true);
+    int poll_result = poll_one(acceptor, POLL_MODE_READ, true);
 
-    if (select_result > 0)
+    if (poll_result > 0)
     {
       sockaddr_in cli_addr = {};
       socklen_t cli_addr_length = sizeof(cli_addr);
@@ -698,7 +750,7 @@ Socket listen_and_accept(unsigned short port)
       if (client == NULL_SOCKET)
         throw_socket_error();
     }
-    else if (select_result == 0)
+    else if (poll_result == 0)
     {
       check_socket_error(acceptor);
     }
@@ -719,17 +771,25 @@ Socket listen_and_accept(unsigned short port)
 }
 
 
-int select_one(Socket socket, Select_mode mode, bool wait)
+int poll_one(Socket socket, Poll_mode mode, bool wait)
 {
+  int result;
+
+#ifdef _WIN32
+
+  /*
+    On Windows fd_set is an array of socket handles and is not limited by
+    the values of these handles. We use select() here because WSAPoll()
+    does not report failed connection attempts on some Windows versions.
+  */
+
   timeval zero_timeout = {};
 
 DIAGNOSTIC_PUSH
 
-#ifdef _WIN32
   // 4548 = expression has no effect
   // This warning is generated by FD_SET
   DISABLE_WARNING(4548)
-#endif
 
   fd_set socket_set;
   FD_ZERO(&socket_set);
@@ -741,14 +801,33 @@ DIAGNOSTIC_PUSH
 
 DIAGNOSTIC_POP
 
-  int result = ::select(FD_SETSIZE,
-    mode == SELECT_MODE_READ ? &socket_set : NULL,
-    mode == SELECT_MODE_WRITE ? &socket_set : NULL,
-    &except_set, wait ? NULL : &zero_timeout);
+  do {
+    result = ::select(0,
+      mode == POLL_MODE_READ ? &socket_set : NULL,
+      mode == POLL_MODE_WRITE ? &socket_set : NULL,
+      &except_set, wait ? NULL : &zero_timeout);
+  }
+  while (result == SOCKET_ERROR && interrupted());
 
   if (result > 0 && FD_ISSET(socket, &except_set))
     check_socket_error(socket);
 
+#else
+
+  pollfd fds = {};
+  fds.fd = socket;
+  fds.events = (mode == POLL_MODE_READ ? POLLIN : POLLOUT);
+
+  do {
+    result = ::poll(&fds, 1, wait ? -1 : 0);
+  }
+  while (result == SOCKET_ERROR && interrupted());
+
+  if (result > 0 && (fds.revents & (POLLERR | POLLNVAL)))
+    check_socket_error(socket);
+
+#endif
+
   return result;
 }
 
@@ -808,50 +887,43 @@ size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait)
   assert(buffer_size > 0);
   assert(buffer_size < (size_t)std::numeric_limits<int>::max());
 
-  size_t bytes_received = 0;
+#ifndef MSG_DONTWAIT
+
+  /*
+    Without MSG_DONTWAIT recv() could block if socket is in blocking mode.
+    Check that data is available if we are not allowed to wait.
+  */
 
-  int select_result = select_one(socket, SELECT_MODE_READ, wait);
+  if (!wait && poll_one(socket, POLL_MODE_READ, false) == 0)
+    return 0;
 
-  if (select_result > 0)
+#endif
+
+  for (;;)
   {
     int recv_result = ::recv(socket, reinterpret_cast<char *>(buffer),
-                             static_cast<int>(buffer_size), 0);
+                             static_cast<int>(buffer_size), io_flags);
+
+    if (recv_result > 0)
+      return static_cast<size_t>(recv_result);
 
     if (recv_result == 0)
-    {
       throw connection::Error_eos();
-    }
-    else if (recv_result == SOCKET_ERROR)
-    {
-#ifdef _WIN32
-      if (WSAGetLastError() == WSAEWOULDBLOCK)
-#else
-      if (errno == EAGAIN || errno == EWOULDBLOCK)
-#endif
-      {
-        bytes_received = 0;
-      }
-      else
-      {
-        throw_socket_error();
-      }
-    }
-    else
-    {
-      assert(recv_result > 0);
-      bytes_received = static_cast<size_t>(recv_result);
-    }
-  }
-  else if (select_result == 0)
-  {
-    return 0;
-  }
-  else
-  {
-    throw_socket_error();
-  }
 
-  return bytes_received;
+    if (interrupted())
+      continue;
+
+    if (!would_block())
+      throw_socket_error();
+
+    if (!wait)
+      return 0;
+
+    // No data has arrived yet - wait for it.
+
+    if (poll_one(socket, POLL_MODE_READ, true) < 0)
+      throw_socket_error();
+  }
 }
 
 
@@ -867,46 +939,35 @@ size_t send_some(Socket socket, const byte *buffer, size_t buffer_size, bool wai
   assert(buffer_size > 0);
   assert(buffer_size < (size_t)std::numeric_limits<int>::max());
 
-  size_t bytes_sent = 0;
+#ifndef MSG_DONTWAIT
 
-  int select_result = select_one(socket, SELECT_MODE_WRITE, wait);
+  if (!wait && poll_one(socket, POLL_MODE_WRITE, false) == 0)
+    return 0;
+
+#endif
 
-  if (select_result > 0)
+  for (;;)
   {
     int send_result = ::send(socket, reinterpret_cast<const char *>(buffer),
-                             static_cast<int>(buffer_size), 0);
+                             static_cast<int>(buffer_size), io_flags);
 
-    if (send_result == SOCKET_ERROR)
-    {
-#ifdef _WIN32
-      if (WSAGetLastError() == WSAEWOULDBLOCK)
-#else
-      if (errno == EAGAIN || errno == EWOULDBLOCK)
-#endif
-      {
-        bytes_sent = 0;
-      }
-      else
-      {
-        throw_socket_error();
-      }
-    }
-    else
-    {
-      assert(send_result >= 0);
-      bytes_sent = static_cast<size_t>(send_result);
-    }
-  }
-  else if (select_result == 0)
-  {
-    return 0;
-  }
-  else
-  {
-    throw_socket_error();
-  }
+    if (send_result >= 0)
+      return static_cast<size_t>(send_result);
 
-  return bytes_sent;
+    if (interrupted())
+      continue;
+
+    if (!would_block())
+      throw_socket_error();
+
+    if (!wait)
+      return 0;
+
+    // Socket buffer is full - wait until there is space in it.
+
+    if (poll_one(socket, POLL_MODE_WRITE, true) < 0)
+      throw_socket_error();
+  }
 }
 
 
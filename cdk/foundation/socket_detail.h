@@ -45,10 +45,11 @@ PUSH_SYS_WARNINGS
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
+#include <poll.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <fcntl.h>
 #include <netdb.h>
 
@@ -86,10 +87,10 @@ enum Shutdown_mode
 };
 
 
-enum Select_mode
+enum Poll_mode
 {
-  SELECT_MODE_READ,
-  SELECT_MODE_WRITE
+  POLL_MODE_READ,
+  POLL_MODE_WRITE
 };
 
 
@@ -298,6 +299,9 @@ Socket listen_and_accept(unsigned short port);
   Test socket's I/O state.
 
   Tests if data can be read from or written to a socket without blocking.
+  On POSIX systems uses `poll` so that, unlike `select`, it works for any
+  descriptor value, including ones above `FD_SETSIZE`. On Windows `select`
+  is used, whose `fd_set` is not limited by socket handle values.
 
   @param[in] socket
     Socket to be tested.
@@ -307,13 +311,13 @@ Socket listen_and_accept(unsigned short port);
     If `true`, function will block. Otherwise, it will return immediately.
 
   @return
-    Same as POSIX `select` function.
+    Same as POSIX `poll` function.
 
   @throw cdk::foundation::Error
     If after testing socket is in an erroneous state, function throws.
 */
 
-int select_one(Socket socket, Select_mode mode, bool wait);
+int poll_one(Socket socket, Poll_mode mode, bool wait);
 
 
 /**
@@ -402,6 +406,11 @@ void send(Socket socket, const byte *buffer, size_t buffer_size);
   @return
     The number of bytes read from a socket.
 
+  @note
+    Reading is attempted first and socket readiness is checked only if no
+    data is available, so that reading data which has already arrived costs
+    a single system call.
+
   @throw cdk::foundation::connection::Error_eos
     End-of-stream encountered.
   @throw cdk::foundation::Error
@@ -429,6 +438,10 @@ size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait);
   @return
     The number of bytes sent to a socket.
 
+  @note
+    As with `recv_some`, sending is attempted first and socket readiness is
+    checked only if socket buffer is full.
+
   @throw cdk::foundation::Error
     Socket write failed.
 */
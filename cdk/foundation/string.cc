@@ -31,6 +31,10 @@
 #include <mysql/cdk/foundation/types.h>
 #include <mysql/cdk/foundation/codec.h>
 
+PUSH_SYS_WARNINGS
+#include <algorithm>
+POP_SYS_WARNINGS
+
 
 namespace cdk {
 namespace foundation {
@@ -46,12 +50,9 @@ string& string::set_utf8(const std::string &str)
 string::operator std::string() const
 {
   Codec<Type::STRING> codec;
-  size_t len = 4*length() + 1;
-  char *buf = new char[4*length() + 1];
-  len= codec.to_bytes(*this, bytes((byte*)buf, len));
-  buf[len] = '\0';
-  const std::string out(buf, buf+len);
-  delete[] buf;
+  std::string out(codec.measure(*this), '\0');
+  if (!out.empty())
+    codec.to_bytes(*this, bytes((byte*)&out[0], out.size()));
   return out;
 }
 
@@ -59,6 +60,639 @@ string::operator std::string() const
 }}  // cdk::foundation
 
 
+/*
+  UTF8 codec
+  ==========
+
+  Strings are processed in blocks of BLOCK_SIZE bytes (or wide characters).
+  A block which contains only ASCII characters is converted by one of the
+  ascii_in()/ascii_out() functions below. These use SIMD instructions: SSE2
+  is assumed to be always present on x86, AVX2 variants are used if the CPU
+  supports them (this is checked at run time). The generic variants, used
+  on other platforms, check 8 bytes at a time.
+
+  Blocks with non-ASCII characters are converted by scalar code which also
+  validates the UTF8 encoding: overlong sequences, surrogates and code
+  points above 0x10FFFF are rejected.
+*/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && defined(__SSE2__)
+  #define UTF8_SSE2
+  #define UTF8_AVX2
+  #define TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) \
+      || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define UTF8_SSE2
+  #define UTF8_AVX2
+  #define TARGET_AVX2
+#endif
+
+PUSH_SYS_WARNINGS
+#ifdef UTF8_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef UTF8_AVX2
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+POP_SYS_WARNINGS
+
+
+namespace {
+
+using cdk::foundation::byte;
+using cdk::foundation::char_t;
+
+
+/*
+  Functions that convert blocks of ASCII characters.
+
+  They process consecutive blocks of the input, as long as a block contains
+  only ASCII characters and there are at least BLOCK_SIZE characters left.
+  Return the number of characters converted.
+*/
+
+const size_t BLOCK_SIZE = 32;
+
+struct Ascii_funcs
+{
+  size_t (*prefix)(const byte*, size_t);
+  size_t (*in)(const byte*, size_t, char_t*);
+  size_t (*out)(const char_t*, size_t, byte*);
+};
+
+
+// Generic variants, used when SSE2 is not available.
+
+#if !defined(UTF8_SSE2)
+
+const uint64_t high_bits = 0x8080808080808080ULL;
+
+size_t ascii_prefix_generic(const byte *from, size_t len)
+{
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    uint64_t w[4];
+    memcpy(w, from + pos, BLOCK_SIZE);
+    if ((w[0] | w[1] | w[2] | w[3]) & high_bits)
+      break;
+  }
+
+  return pos;
+}
+
+size_t ascii_in_generic(const byte *from, size_t len, char_t *to)
+{
+  size_t pos = ascii_prefix_generic(from, len);
+
+  for (size_t i = 0; i < pos; ++i)
+    to[i] = from[i];
+
+  return pos;
+}
+
+size_t ascii_out_generic(const char_t *from, size_t len, byte *to)
+{
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    uint32_t bits = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i)
+      bits |= (uint32_t)from[pos + i];
+    if (bits & ~0x7FU)
+      break;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i)
+      to[pos + i] = (byte)from[pos + i];
+  }
+
+  return pos;
+}
+
+#endif  // !UTF8_SSE2
+
+
+#ifdef UTF8_SSE2
+
+size_t ascii_prefix_sse2(const byte *from, size_t len)
+{
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(from + pos));
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(from + pos + 16));
+    if (_mm_movemask_epi8(_mm_or_si128(v0, v1)))
+      break;
+  }
+
+  return pos;
+}
+
+size_t ascii_in_sse2(const byte *from, size_t len, char_t *to)
+{
+  const __m128i zero = _mm_setzero_si128();
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    __m128i v[2];
+    v[0] = _mm_loadu_si128((const __m128i*)(from + pos));
+    v[1] = _mm_loadu_si128((const __m128i*)(from + pos + 16));
+    if (_mm_movemask_epi8(_mm_or_si128(v[0], v[1])))
+      break;
+
+    __m128i *out = (__m128i*)(to + pos);
+
+    for (unsigned i = 0; i < 2; ++i)
+    {
+      __m128i lo = _mm_unpacklo_epi8(v[i], zero);
+      __m128i hi = _mm_unpackhi_epi8(v[i], zero);
+
+      if (2 == sizeof(char_t))
+      {
+        _mm_storeu_si128(out++, lo);
+        _mm_storeu_si128(out++, hi);
+      }
+      else
+      {
+        _mm_storeu_si128(out++, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out++, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out++, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out++, _mm_unpackhi_epi16(hi, zero));
+      }
+    }
+  }
+
+  return pos;
+}
+
+size_t ascii_out_sse2(const char_t *from, size_t len, byte *to)
+{
+  const size_t n = 16 / sizeof(char_t);  // characters in one register
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i mask = (2 == sizeof(char_t) ?
+                        _mm_set1_epi16(~0x7F) : _mm_set1_epi32(~0x7F));
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    const __m128i *in = (const __m128i*)(from + pos);
+    __m128i v[BLOCK_SIZE / 4];
+    __m128i bits = zero;
+
+    for (unsigned i = 0; i < BLOCK_SIZE / n; ++i)
+    {
+      v[i] = _mm_loadu_si128(in + i);
+      bits = _mm_or_si128(bits, v[i]);
+    }
+
+    bits = _mm_and_si128(bits, mask);
+    if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(bits, zero)))
+      break;
+
+    __m128i *out = (__m128i*)(to + pos);
+
+    for (unsigned i = 0; i < BLOCK_SIZE / n; i += 16 / n)
+    {
+      if (2 == sizeof(char_t))
+        _mm_storeu_si128(out++, _mm_packus_epi16(v[i], v[i + 1]));
+      else
+        _mm_storeu_si128(out++, _mm_packus_epi16(
+          _mm_packs_epi32(v[i], v[i + 1]), _mm_packs_epi32(v[i + 2], v[i + 3])
+        ));
+    }
+  }
+
+  return pos;
+}
+
+#endif  // UTF8_SSE2
+
+
+#ifdef UTF8_AVX2
+
+TARGET_AVX2
+size_t ascii_prefix_avx2(const byte *from, size_t len)
+{
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    __m256i v = _mm256_loadu_si256((const __m256i*)(from + pos));
+    if (_mm256_movemask_epi8(v))
+      break;
+  }
+
+  return pos;
+}
+
+TARGET_AVX2
+size_t ascii_in_avx2(const byte *from, size_t len, char_t *to)
+{
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    __m256i v = _mm256_loadu_si256((const __m256i*)(from + pos));
+    if (_mm256_movemask_epi8(v))
+      break;
+
+    __m256i *out = (__m256i*)(to + pos);
+
+    if (2 == sizeof(char_t))
+    {
+      for (unsigned i = 0; i < 2; ++i)
+        _mm256_storeu_si256(out++, _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i*)(from + pos + 16*i))
+        ));
+    }
+    else
+    {
+      for (unsigned i = 0; i < 4; ++i)
+        _mm256_storeu_si256(out++, _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64((const __m128i*)(from + pos + 8*i))
+        ));
+    }
+  }
+
+  return pos;
+}
+
+TARGET_AVX2
+size_t ascii_out_avx2(const char_t *from, size_t len, byte *to)
+{
+  const size_t n = 32 / sizeof(char_t);  // characters in one register
+  const __m256i mask = (2 == sizeof(char_t) ?
+                        _mm256_set1_epi16(~0x7F) : _mm256_set1_epi32(~0x7F));
+  size_t pos = 0;
+
+  for (; pos + BLOCK_SIZE <= len; pos += BLOCK_SIZE)
+  {
+    const __m256i *in = (const __m256i*)(from + pos);
+    __m256i v[BLOCK_SIZE / 8];
+    __m256i bits = _mm256_setzero_si256();
+
+    for (unsigned i = 0; i < BLOCK_SIZE / n; ++i)
+    {
+      v[i] = _mm256_loadu_si256(in + i);
+      bits = _mm256_or_si256(bits, v[i]);
+    }
+
+    if (!_mm256_testz_si256(bits, mask))
+      break;
+
+    /*
+      Note: AVX2 pack instructions work within 128-bit lanes, so the packed
+      data must be permuted to get characters in the original order.
+    */
+
+    __m256i res;
+
+    if (2 == sizeof(char_t))
+      res = _mm256_permute4x64_epi64(_mm256_packus_epi16(v[0], v[1]), 0xD8);
+    else
+      res = _mm256_permutevar8x32_epi32(
+        _mm256_packus_epi16(
+          _mm256_packs_epi32(v[0], v[1]), _mm256_packs_epi32(v[2], v[3])
+        ),
+        _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)
+      );
+
+    _mm256_storeu_si256((__m256i*)(to + pos), res);
+  }
+
+  return pos;
+}
+
+bool have_avx2()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  // OSXSAVE and AVX bits
+  if ((info[2] & (1 << 27 | 1 << 28)) != (1 << 27 | 1 << 28))
+    return false;
+  // OS saves YMM registers
+  if ((_xgetbv(0) & 6) != 6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return 0 != (info[1] & (1 << 5));
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // UTF8_AVX2
+
+
+const Ascii_funcs& ascii()
+{
+  static const Ascii_funcs funcs =
+#if defined(UTF8_AVX2)
+    have_avx2() ?
+      Ascii_funcs{ ascii_prefix_avx2, ascii_in_avx2, ascii_out_avx2 } :
+      Ascii_funcs{ ascii_prefix_sse2, ascii_in_sse2, ascii_out_sse2 };
+#elif defined(UTF8_SSE2)
+    Ascii_funcs{ ascii_prefix_sse2, ascii_in_sse2, ascii_out_sse2 };
+#else
+    Ascii_funcs{ ascii_prefix_generic, ascii_in_generic, ascii_out_generic };
+#endif
+  return funcs;
+}
+
+
+/*
+  Decode UTF8 sequence starting at `pos` and move `pos` past it. Returns
+  the decoded code point or -1 if the sequence is not valid.
+*/
+
+inline
+int32_t decode_char(const byte *&pos, const byte *end)
+{
+  uint32_t c = *pos;
+
+  if (c < 0x80)
+  {
+    ++pos;
+    return (int32_t)c;
+  }
+
+  size_t   len;
+  uint32_t min;
+
+  if (0xC0 == (c & 0xE0))
+  {
+    len = 2; min = 0x80; c &= 0x1F;
+  }
+  else if (0xE0 == (c & 0xF0))
+  {
+    len = 3; min = 0x800; c &= 0x0F;
+  }
+  else if (0xF0 == (c & 0xF8))
+  {
+    len = 4; min = 0x10000; c &= 0x07;
+  }
+  else
+    return -1;
+
+  if ((size_t)(end - pos) < len)
+    return -1;
+
+  for (size_t i = 1; i < len; ++i)
+  {
+    if (0x80 != (pos[i] & 0xC0))
+      return -1;
+    c = (c << 6) | (pos[i] & 0x3F);
+  }
+
+  if (c < min || c > 0x10FFFF || (0xD800 <= c && c <= 0xDFFF))
+    return -1;
+
+  pos += len;
+  return (int32_t)c;
+}
+
+
+/*
+  Encode code point as UTF8 sequence. Returns number of bytes written or
+  0 if there is not enough space in the output buffer.
+*/
+
+inline
+size_t encode_char(uint32_t c, byte *to, byte *end)
+{
+  size_t len = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+
+  if ((size_t)(end - to) < len)
+    return 0;
+
+  switch (len)
+  {
+  case 1:
+    to[0] = (byte)c;
+    break;
+  case 2:
+    to[0] = (byte)(0xC0 | (c >> 6));
+    to[1] = (byte)(0x80 | (c & 0x3F));
+    break;
+  case 3:
+    to[0] = (byte)(0xE0 | (c >> 12));
+    to[1] = (byte)(0x80 | ((c >> 6) & 0x3F));
+    to[2] = (byte)(0x80 | (c & 0x3F));
+    break;
+  case 4:
+    to[0] = (byte)(0xF0 | (c >> 18));
+    to[1] = (byte)(0x80 | ((c >> 12) & 0x3F));
+    to[2] = (byte)(0x80 | ((c >> 6) & 0x3F));
+    to[3] = (byte)(0x80 | (c & 0x3F));
+    break;
+  }
+
+  return len;
+}
+
+
+/*
+  Store code point in a wide string (as surrogate pair if char_t is
+  16-bit and the code point does not fit).
+*/
+
+inline
+void put_wchar(uint32_t c, char_t *&to)
+{
+  if (2 == sizeof(char_t) && c > 0xFFFF)
+  {
+    c -= 0x10000;
+    *to++ = (char_t)(0xD800 + (c >> 10));
+    *to++ = (char_t)(0xDC00 + (c & 0x3FF));
+    return;
+  }
+
+  *to++ = (char_t)c;
+}
+
+
+/*
+  Read code point from a wide string, moving `pos` past it. Returns -1
+  if the string does not contain a valid code point at this position.
+*/
+
+inline
+int32_t get_wchar(const char_t *&pos, const char_t *end)
+{
+  uint32_t c = (uint32_t)*pos++;
+
+  if (c > 0x10FFFF)
+    return -1;
+
+  if (c < 0xD800 || c > 0xDFFF)
+    return (int32_t)c;
+
+  // Only a high surrogate followed by a low one is valid.
+
+  if (2 != sizeof(char_t) || c > 0xDBFF || pos == end)
+    return -1;
+
+  uint32_t c2 = (uint32_t)*pos;
+
+  if (c2 < 0xDC00 || c2 > 0xDFFF)
+    return -1;
+
+  ++pos;
+  return (int32_t)(0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00));
+}
+
+}  // anonymous namespace
+
+
+namespace cdk {
+namespace foundation {
+
+
+size_t String_codec<codecvt_utf8>::measure(const string &str)
+{
+  size_t len = 0;
+
+  for (auto it = str.begin(); it != str.end(); ++it)
+  {
+    uint32_t c = (uint32_t)*it;
+
+    if (c < 0x80)
+      len += 1;
+    else if (c < 0x800)
+      len += 2;
+    else if (2 == sizeof(char_t) && 0xD800 <= c && c <= 0xDBFF)
+    {
+      // surrogate pair encodes a 4 byte sequence
+      len += 4;
+      if (it + 1 != str.end())
+        ++it;
+    }
+    else if (c < 0x10000)
+      len += 3;
+    else
+      len += 4;
+  }
+
+  return len;
+}
+
+
+size_t String_codec<codecvt_utf8>::from_bytes(bytes in, string &out)
+{
+  if (0 == in.size())
+  {
+    out.clear();
+    return 0;
+  }
+
+  /*
+    Note: Number of wide characters is not bigger than number of bytes,
+    also when 4 byte sequence is stored as surrogate pair.
+  */
+
+  out.resize(in.size());
+
+  const Ascii_funcs &ascii = ::ascii();
+  const byte *pos = in.begin();
+  const byte *end = in.end();
+  char_t     *to = &out[0];
+
+  while (pos < end)
+  {
+    size_t len = ascii.in(pos, (size_t)(end - pos), to);
+    pos += len;
+    to += len;
+
+    // Convert the remaining characters of the current block.
+
+    const byte *block_end = std::min(pos + BLOCK_SIZE, end);
+
+    while (pos < block_end)
+    {
+      int32_t c = decode_char(pos, end);
+      if (c < 0)
+        throw_error("string conversion error");
+      put_wchar((uint32_t)c, to);
+    }
+  }
+
+  out.resize((size_t)(to - &out[0]));
+  return in.size();
+}
+
+
+size_t String_codec<codecvt_utf8>::to_bytes(const string &in, bytes out)
+{
+  if (0 == in.size())
+    return 0;
+
+  const Ascii_funcs &ascii = ::ascii();
+  const char_t *pos = &in[0];
+  const char_t *end = pos + in.length();
+  byte *to = out.begin();
+
+  while (pos < end)
+  {
+    size_t len = ascii.out(pos,
+      std::min((size_t)(end - pos), (size_t)(out.end() - to)), to
+    );
+    pos += len;
+    to += len;
+
+    const char_t *block_end = std::min(pos + BLOCK_SIZE, end);
+
+    while (pos < block_end)
+    {
+      int32_t c = get_wchar(pos, end);
+      size_t  len1 = c < 0 ? 0 : encode_char((uint32_t)c, to, out.end());
+      if (0 == len1)
+        throw_error("string conversion error");
+      to += len1;
+    }
+  }
+
+  return (size_t)(to - out.begin());
+}
+
+
+size_t utf8::valid_prefix(bytes str)
+{
+  const Ascii_funcs &ascii = ::ascii();
+  const byte *pos = str.begin();
+  const byte *end = str.end();
+
+  while (pos < end)
+  {
+    pos += ascii.prefix(pos, (size_t)(end - pos));
+
+    const byte *block_end = std::min(pos + BLOCK_SIZE, end);
+
+    while (pos < block_end)
+    {
+      const byte *next = pos;
+      if (0 > decode_char(next, end))
+        return (size_t)(pos - str.begin());
+      pos = next;
+    }
+  }
+
+  return str.size();
+}
+
+
+}}  // cdk::foundation
+
+
 #ifndef HAVE_CODECVT_UTF8
 
 /*
@@ -104,6 +104,101 @@ TEST(Foundation, string)
 }
 
 
+TEST(Foundation, string_utf8)
+{
+  using cdk::foundation::string;
+
+  Codec<Type::STRING> codec;
+
+  /*
+    Long strings, so that both block conversion of ASCII characters and
+    conversion of other characters is used. Non-ASCII characters are placed
+    at different positions, also on block boundaries.
+  */
+
+  for (unsigned i = 0; i < 70; ++i)
+  {
+    string wide(std::wstring(200, L'a'));
+    std::string narrow(200, 'a');
+
+    wide[i] = L'\u0119';
+    narrow.replace(i, 1, "\xC4\x99");
+
+    wide[i + 64] = L'\u79C1';
+    narrow.replace(i + 65, 1, "\xE7\xA7\x81");
+
+    wide[199] = (char_t)0x10348;
+    narrow.replace(narrow.length() - 1, 1, "\xF0\x90\x8D\x88");
+
+    if (2 == sizeof(char_t))
+    {
+      // Wide string uses UTF16 encoding.
+      wide[199] = (char_t)0xD800;
+      wide.push_back((char_t)0xDF48);
+    }
+
+    EXPECT_EQ(narrow.length(), codec.measure(wide));
+
+    std::string out(narrow.length(), '\0');
+    EXPECT_EQ(narrow.length(),
+              codec.to_bytes(wide, bytes((byte*)&out[0], out.length())));
+    EXPECT_EQ(narrow, out);
+
+    string back;
+    codec.from_bytes(bytes((byte*)&narrow[0], narrow.length()), back);
+    EXPECT_EQ(wide, back);
+
+    EXPECT_TRUE(utf8::is_valid(bytes((byte*)&narrow[0], narrow.length())));
+
+    // Output buffer too small.
+
+    EXPECT_THROW(
+      codec.to_bytes(wide, bytes((byte*)&out[0], out.length() - 1)),
+      Error
+    );
+  }
+
+  // Invalid UTF8 sequences.
+
+  const char *invalid[] = {
+    "\x80",                   // continuation byte
+    "\xC4",                   // incomplete sequence
+    "\xC4\x20",               // missing continuation byte
+    "\xC0\xAF",               // overlong encoding
+    "\xE0\x80\xAF",           // overlong encoding
+    "\xED\xA0\x80",           // surrogate
+    "\xF4\x90\x80\x80",       // code point above 0x10FFFF
+    "\xFF",
+  };
+
+  for (const char *seq : invalid)
+  {
+    // Invalid sequence placed after block of ASCII characters.
+
+    std::string str(40, 'x');
+    str.append(seq);
+    str.append("yz");
+
+    string out;
+    EXPECT_THROW(
+      codec.from_bytes(bytes((byte*)&str[0], str.length()), out),
+      Error
+    );
+
+    EXPECT_EQ(40U, utf8::valid_prefix(bytes((byte*)&str[0], str.length())));
+  }
+
+  // Invalid characters in wide string.
+
+  string wide(std::wstring(40, L'x'));
+  wide.push_back((char_t)0xDC00);
+  std::string out(200, '\0');
+
+  EXPECT_THROW(codec.to_bytes(wide, bytes((byte*)&out[0], out.length())),
+               Error);
+}
+
+
 /*
   Number Codecs
   =============
@@ -405,3 +500,87 @@ TEST(Foundation, number)
   EXPECT_EQ(2U,howmuch);
 
 }
+
+
+/*
+  Encode value in varint format (reference implementation for testing
+  the decoder).
+*/
+
+static size_t varint_encode(uint64_t val, byte *buf)
+{
+  size_t len = 0;
+  while (val >= 0x80)
+  {
+    buf[len++] = (byte)(val | 0x80);
+    val >>= 7;
+  }
+  buf[len++] = (byte)val;
+  return len;
+}
+
+
+TEST(Foundation, varint)
+{
+  byte buf[16];
+  uint64_t val;
+
+  // Values with all possible lengths of the encoding, from 1 to 10 bytes.
+
+  for (unsigned bits = 0; bits <= 64; ++bits)
+  {
+    uint64_t vals[] = {
+      bits < 64 ? (uint64_t)1 << bits : 0,
+      bits < 64 ? ((uint64_t)1 << bits) - 1 : ~(uint64_t)0,
+      bits < 64 ? ((uint64_t)1 << bits) + 0x5A : 0x123456789ABCDEF0ULL
+    };
+
+    for (uint64_t expected : vals)
+    {
+      size_t len = varint_encode(expected, buf);
+
+      // Extra bytes after the value should be ignored.
+
+      memset(buf + len, 0xFF, sizeof(buf) - len);
+
+      EXPECT_EQ(len, varint::decode(bytes(buf, len), val));
+      EXPECT_EQ(expected, val);
+      EXPECT_EQ(len, varint::decode(bytes(buf, sizeof(buf)), val));
+      EXPECT_EQ(expected, val);
+
+      // Truncated value.
+
+      EXPECT_EQ(0U, varint::decode(bytes(buf, len - 1), val));
+    }
+  }
+
+  // More than 10 bytes is not a valid varint.
+
+  memset(buf, 0x80, sizeof(buf));
+  EXPECT_EQ(0U, varint::decode(bytes(buf, sizeof(buf)), val));
+
+  // Batch decoding, empty buffer decodes as 0.
+
+  byte data[32];
+  size_t pos = 0;
+  bytes bufs[4];
+  uint64_t expected[] = { 7, 0, 300, 0xFFFFFFFFFFULL };
+
+  for (unsigned i = 0; i < 4; ++i)
+  {
+    size_t len = (1 == i) ? 0 : varint_encode(expected[i], data + pos);
+    bufs[i] = bytes(data + pos, len);
+    pos += len;
+  }
+
+  uint64_t vals[4];
+  EXPECT_EQ(4U, varint::decode(bufs, 4, vals));
+  for (unsigned i = 0; i < 4; ++i)
+    EXPECT_EQ(expected[i], vals[i]);
+
+  // Decoding stops at first invalid value.
+
+  byte bad = 0x80;
+  bufs[2] = bytes(&bad, 1);
+  EXPECT_EQ(2U, varint::decode(bufs, 4, vals));
+}
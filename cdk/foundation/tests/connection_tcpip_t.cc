@@ -45,6 +45,14 @@
 #include <iostream>
 #include <mysql/cdk/foundation/connection_tcpip.h>
 #include <mysql/cdk/foundation/error.h>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#endif
 
 #define PORT 9876
 
@@ -490,3 +498,88 @@ TEST_F(Foundation_connection_tcpip, closed)
 }
 
 
+
+
+#ifndef _WIN32
+
+/*
+  Test that I/O works for a socket whose descriptor value is above
+  FD_SETSIZE. Such descriptors can not be used with select().
+
+  Note: Test server should be started before running this test.
+*/
+
+TEST_F(Foundation_connection_tcpip, high_fd)
+{
+  using cdk::foundation::byte;
+  using connection::TCPIP;
+
+  const rlim_t needed = FD_SETSIZE + 16;
+
+  rlimit lim;
+  if (0 != getrlimit(RLIMIT_NOFILE, &lim))
+    FAIL() << "Could not get descriptor limit" << endl;
+
+  const rlimit saved_lim = lim;
+
+  if (lim.rlim_cur != RLIM_INFINITY && lim.rlim_cur < needed)
+  {
+    if (lim.rlim_max != RLIM_INFINITY && lim.rlim_max < needed)
+    {
+      cout << "SKIPPED: descriptor limit too low" << endl;
+      return;
+    }
+    lim.rlim_cur = needed;
+    if (0 != setrlimit(RLIMIT_NOFILE, &lim))
+    {
+      cout << "SKIPPED: could not raise descriptor limit" << endl;
+      return;
+    }
+  }
+
+  // Use up low descriptor values.
+
+  std::vector<int> fds;
+  int fd;
+  while ((fd = ::open("/dev/null", O_RDONLY)) >= 0)
+  {
+    fds.push_back(fd);
+    if (fd >= FD_SETSIZE)
+      break;
+  }
+
+  TCPIP conn("localhost", PORT);
+
+  try {
+    conn.connect();
+
+    cout << "Connected using descriptor " << conn.get_fd() << endl;
+    EXPECT_LE(FD_SETSIZE, (int)conn.get_fd());
+
+    byte output[]= "Hello World!";
+    buffers bufs(output, sizeof(output));
+    TCPIP::Write_op write_op(conn, bufs);
+    write_op.wait();
+
+    char inbuf_raw[13];
+    buffers inbuf((byte*)inbuf_raw, sizeof(inbuf_raw)-1);
+    TCPIP::Read_op read_op(conn, inbuf);
+    read_op.wait();
+
+    inbuf_raw[read_op.get_result()]= 0;
+    cout << "Read " << read_op.get_result() << " bytes: " << inbuf_raw << endl;
+  }
+  catch (Error &e)
+  {
+    ADD_FAILURE() << "Unexpected error: " << e << endl;
+  }
+
+  conn.close();
+
+  for (size_t i = 0; i < fds.size(); ++i)
+    ::close(fds[i]);
+
+  setrlimit(RLIMIT_NOFILE, &saved_lim);
+}
+
+#endif
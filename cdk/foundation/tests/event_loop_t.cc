@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+  Unit tests for CDK event loop.
+*/
+
+#include "test.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mysql/cdk/foundation.h>
+#include <mysql/cdk/foundation/cdk_time.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+using ::std::cout;
+using ::std::endl;
+using namespace cdk::foundation;
+using cdk::foundation::connection::Socket_base;
+
+
+/*
+  Operation which waits for a byte to arrive on a non-blocking pipe.
+*/
+
+#ifndef _WIN32
+
+class Pipe_op : public api::Async_op<void>
+{
+  int  m_fd;
+  bool m_done;
+  Socket_base::Event_info m_event;
+
+public:
+
+  unsigned m_conts;
+
+  Pipe_op(int fd)
+    : m_fd(fd), m_done(false)
+    , m_event(api::Event_info::SOCKET_RD, (unsigned)fd)
+    , m_conts(0)
+  {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+
+  bool is_completed() const { return m_done; }
+
+  bool do_cont()
+  {
+    m_conts++;
+    char c;
+    if (1 == ::read(m_fd, &c, 1))
+      m_done = true;
+    return m_done;
+  }
+
+  void do_wait()
+  {
+    while (!do_cont())
+      cdk::foundation::sleep(10);
+  }
+
+  void do_cancel() {}
+
+  const api::Event_info* get_event_info() const
+  {
+    return m_done ? NULL : &m_event;
+  }
+
+  void do_get_result() {}
+};
+
+#endif
+
+
+/*
+  Operation which completes after given number of cont() calls, or throws
+  error if `fail` is true. It does not report any events.
+*/
+
+class Count_op : public api::Async_op<void>
+{
+  unsigned m_left;
+  bool     m_fail;
+
+public:
+
+  Count_op(unsigned count, bool fail = false)
+    : m_left(count), m_fail(fail)
+  {}
+
+  bool is_completed() const { return 0 == m_left; }
+
+  bool do_cont()
+  {
+    if (0 < m_left)
+      --m_left;
+    if (m_fail && 0 == m_left)
+      throw_error("Count_op failed");
+    return 0 == m_left;
+  }
+
+  void do_wait()
+  {
+    while (!do_cont());
+  }
+
+  void do_cancel() {}
+
+  const api::Event_info* get_event_info() const { return NULL; }
+
+  void do_get_result() {}
+};
+
+
+TEST(Foundation, event_loop_basic)
+{
+  Event_loop loop;
+  std::vector<int> done;
+
+  Count_op op1(3), op2(1), op3(2, true);
+
+  loop.add(op1, [&done](std::exception_ptr err) {
+    EXPECT_FALSE(err);
+    done.push_back(1);
+  });
+
+  loop.add(op2, [&done](std::exception_ptr err) {
+    EXPECT_FALSE(err);
+    done.push_back(2);
+  });
+
+  loop.add(op3, [&done](std::exception_ptr err) {
+    EXPECT_TRUE(err);
+    try {
+      std::rethrow_exception(err);
+    }
+    catch (const Error &e)
+    {
+      cout << "Expected error: " << e << endl;
+    }
+    done.push_back(3);
+  });
+
+  EXPECT_EQ(3U, loop.size());
+
+  loop.run();
+
+  EXPECT_EQ(0U, loop.size());
+  ASSERT_EQ(3U, done.size());
+  EXPECT_EQ(2, done[0]);
+  EXPECT_EQ(3, done[1]);
+  EXPECT_EQ(1, done[2]);
+
+  // Removed operations are not completed and their callbacks are not called.
+
+  Count_op op4(10);
+  bool called = false;
+
+  loop.add(op4, [&called](std::exception_ptr) { called = true; });
+  EXPECT_TRUE(loop.run_once());
+  EXPECT_TRUE(loop.remove(op4));
+  EXPECT_FALSE(loop.remove(op4));
+  EXPECT_EQ(0U, loop.size());
+  EXPECT_FALSE(loop.run_once());
+  EXPECT_FALSE(called);
+  EXPECT_FALSE(op4.is_completed());
+
+  // Callbacks can add new operations to the loop.
+
+  Count_op op5(2), op6(2);
+  done.clear();
+
+  loop.add(op5, [&](std::exception_ptr) {
+    done.push_back(5);
+    loop.add(op6, [&done](std::exception_ptr) { done.push_back(6); });
+  });
+
+  loop.run();
+
+  ASSERT_EQ(2U, done.size());
+  EXPECT_EQ(5, done[0]);
+  EXPECT_EQ(6, done[1]);
+}
+
+
+#ifndef _WIN32
+
+TEST(Foundation, event_loop_sockets)
+{
+  const unsigned N = 4;
+  int fds[N][2];
+
+  for (unsigned i = 0; i < N; ++i)
+    ASSERT_EQ(0, ::pipe(fds[i]));
+
+  std::vector<std::unique_ptr<Pipe_op>> ops;
+  std::vector<unsigned> done;
+  Event_loop loop;
+
+  for (unsigned i = 0; i < N; ++i)
+  {
+    ops.emplace_back(new Pipe_op(fds[i][0]));
+    loop.add(*ops.back(), [i, &done](std::exception_ptr err) {
+      EXPECT_FALSE(err);
+      done.push_back(i);
+    });
+  }
+
+  // Nothing happens on the pipes, the loop should time out.
+
+  EXPECT_TRUE(loop.run_once(0));
+  EXPECT_TRUE(loop.run_once(100));
+  EXPECT_EQ(N, loop.size());
+
+  // Write to the pipes in reverse order, with delays.
+
+  std::thread writer([&fds]() {
+    for (unsigned i = N; i > 0; --i)
+    {
+      cdk::foundation::sleep(50);
+      EXPECT_EQ(1, ::write(fds[i-1][1], "x", 1));
+    }
+  });
+
+  loop.run();
+  writer.join();
+
+  ASSERT_EQ(N, done.size());
+  for (unsigned i = 0; i < N; ++i)
+  {
+    EXPECT_EQ(N - i - 1, done[i]);
+
+    /*
+      An operation is given one cont() call when it is added to the loop
+      and then only when there is data in the pipe.
+    */
+
+    cout << "op " << i << ": " << ops[i]->m_conts << " cont() calls" << endl;
+    EXPECT_EQ(2U, ops[i]->m_conts);
+  }
+
+  for (unsigned i = 0; i < N; ++i)
+  {
+    ::close(fds[i][0]);
+    ::close(fds[i][1]);
+  }
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+  Decoding of varint encoded integers (see codec.h).
+*/
+
+#include <mysql/cdk/foundation/types.h>
+#include <mysql/cdk/foundation/codec.h>
+
+
+namespace cdk {
+namespace foundation {
+namespace varint {
+
+namespace {
+
+const uint64_t high_bits = 0x8080808080808080ULL;
+
+
+/*
+  Put together 7-bit groups stored in the bytes of the given word, least
+  significant group in the lowest byte. High bits of the bytes are ignored.
+*/
+
+inline
+uint64_t pack_groups(uint64_t word)
+{
+  word &= 0x7F7F7F7F7F7F7F7FULL;
+  word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+  word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+  word = (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+  return word;
+}
+
+
+inline
+size_t decode_one(const byte *pos, size_t avail, uint64_t &val)
+{
+  if (0 == avail)
+    return 0;
+
+  // Fast path for values below 128.
+
+  if (pos[0] < 0x80)
+  {
+    val = pos[0];
+    return 1;
+  }
+
+  /*
+    Load up to 8 bytes into a word, first byte in the lowest position
+    regardless of the endianess of the platform.
+  */
+
+  size_t cnt = avail < 8 ? avail : 8;
+  uint64_t word = 0;
+
+  for (size_t i = 0; i < cnt; ++i)
+    word |= (uint64_t)pos[i] << (8*i);
+
+  /*
+    The terminating byte is the first one with high bit cleared. Bytes that
+    were not loaded are 0 and would also look like a terminating byte - this
+    is detected by comparing the length of the value with the number of
+    loaded bytes.
+  */
+
+  uint64_t stop = ~word & high_bits;
+
+  if (stop)
+  {
+    uint64_t last = stop & (~stop + 1);
+    uint64_t mask = (last << 1) - 1;  // all ones if last byte is 8th one
+
+    // Count high bits in the mask, using multiplication to add them up.
+
+    size_t len
+      = (size_t)((((mask & high_bits) >> 7) * 0x0101010101010101ULL) >> 56);
+
+    if (len > cnt)
+      return 0;
+
+    val = pack_groups(word & mask);
+    return len;
+  }
+
+  // Values longer than 8 bytes (at most 10 bytes).
+
+  val = pack_groups(word);
+
+  for (size_t i = 8; i < avail && i < 10; ++i)
+  {
+    val |= (uint64_t)(pos[i] & 0x7F) << (7*i);
+    if (!(pos[i] & 0x80))
+      return i + 1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+
+size_t decode(bytes buf, uint64_t &val)
+{
+  return decode_one(buf.begin(), buf.size(), val);
+}
+
+
+size_t decode(const bytes *bufs, size_t count, uint64_t *vals)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    vals[i] = 0;
+
+    if (0 == bufs[i].size())
+      continue;
+
+    if (0 == decode_one(bufs[i].begin(), bufs[i].size(), vals[i]))
+      return i;
+  }
+
+  return count;
+}
+
+}}}  // cdk::foundation::varint
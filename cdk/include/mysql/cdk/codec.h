@@ -125,11 +125,13 @@ public:
   Format(const Format_info &fi)
     : Format_base(TYPE_BYTES, fi)
     , m_width(0)
+    , m_bit(false)
   {
     fi.get_info(*this);
   }
 
   uint64_t pad_width() const { return m_width; }
+  bool     is_bit() const { return m_bit; }
 
 protected:
 
@@ -140,6 +142,12 @@ protected:
   */
   uint64_t m_width;
 
+  /*
+    If true, values are BIT values encoded as variable length
+    unsigned integers rather than sequences of bytes.
+  */
+  bool m_bit;
+
 public:
 
   struct Access;
@@ -332,6 +340,9 @@ class Codec<TYPE_INTEGER>
   template <typename T>
   size_t internal_to_bytes(T val, bytes buf);
 
+  template <typename T>
+  void internal_from_bytes(const bytes *bufs, size_t count, T *vals);
+
 public:
 
   Codec(const Format_info &fi) : Codec_base<TYPE_INTEGER>(fi) {}
@@ -354,6 +365,15 @@ public:
   virtual size_t to_bytes(uint16_t val, bytes buf);
   virtual size_t to_bytes(uint32_t val, bytes buf);
   virtual size_t to_bytes(uint64_t val, bytes buf);
+
+  /*
+    Decode a batch of `count` values, each stored in its own buffer, such as
+    values of one column in a set of rows. Empty buffers, which represent
+    null values, are decoded as 0.
+  */
+
+  void from_bytes(const bytes *bufs, size_t count, int64_t *vals);
+  void from_bytes(const bytes *bufs, size_t count, uint64_t *vals);
 };
 
 
@@ -378,6 +398,37 @@ public:
   virtual size_t to_bytes(float val, bytes buf);
   virtual size_t to_bytes(double val, bytes buf);
 
+  /*
+    Exact value of a DECIMAL number stored as a fixed-point number. The
+    value equals M * 10^(-m_scale), with sign given by m_negative, where M
+    is the unsigned 128-bit integer with 64-bit halves m_high and m_low.
+  */
+
+  struct Decimal
+  {
+    uint64_t m_high;
+    uint64_t m_low;
+    unsigned m_scale;
+    bool     m_negative;
+
+    /*
+      Change scale of the value to the given one without changing the
+      value. Returns false if this is not possible because the new scale is
+      smaller than the current one or M would not fit in 128 bits.
+    */
+
+    bool set_scale(unsigned scale);
+  };
+
+  /*
+    Decode DECIMAL value directly from its packed BCD digits, without
+    converting it to a string first. Returns 0 if the value does not fit
+    in 128 bits (DECIMAL values can have up to 65 digits), otherwise the
+    number of bytes used.
+  */
+
+  size_t from_bytes(bytes buf, Decimal &val);
+
 };
 
 
@@ -146,6 +146,21 @@ class Protocol_options
 
   virtual auth_method_t auth_method() const = 0;
 
+  /*
+    Whether compression of protocol messages should be negotiated with
+    the server. If PREFERRED and the server does not support compression,
+    the session continues without it. If REQUIRED, session creation fails
+    in that case.
+  */
+
+  enum compression_mode_t {
+    COMPRESSION_DISABLED,
+    COMPRESSION_PREFERRED,
+    COMPRESSION_REQUIRED
+  };
+
+  virtual compression_mode_t compression() const = 0;
+
 };
 
 
@@ -155,6 +170,7 @@ class Options
 protected:
 
   auth_method_t m_auth_method = DEFAULT;
+  compression_mode_t m_compression = COMPRESSION_DISABLED;
 
 public:
 
@@ -175,6 +191,16 @@ public:
     return m_auth_method;
   }
 
+  void set_compression(compression_mode_t mode)
+  {
+    m_compression = mode;
+  }
+
+  compression_mode_t compression() const
+  {
+    return m_compression;
+  }
+
 };
 
 
@@ -41,6 +41,7 @@
 #include "foundation/connection_openssl.h"
 #endif
 #include "foundation/diagnostics.h"
+#include "foundation/event_loop.h"
 #include "foundation/codec.h"
 //#include "foundation/socket.h"
 
@@ -73,6 +74,8 @@ namespace cdk {
   using foundation::Diagnostic_arena;
   using foundation::Diagnostic_iterator;
 
+  using foundation::Event_loop;
+
   namespace api {
 
     using namespace cdk::foundation::api;
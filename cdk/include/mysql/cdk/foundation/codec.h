@@ -246,6 +246,80 @@ public:
 };
 
 
+/*
+  UTF8 string codec.
+
+  This specialization does not use codecvt_utf8 facet but converts strings
+  directly (see string.cc). Blocks of ASCII characters are converted using
+  SIMD instructions where available, other characters are converted one by
+  one. Invalid UTF8 sequences are reported as errors. Depending on the size
+  of char_t, wide strings use UTF32 or UTF16 encoding.
+*/
+
+template<>
+class String_codec<codecvt_utf8> : public api::String_codec
+{
+public:
+
+  size_t measure(const string&);
+  size_t from_bytes(bytes, string&);
+  size_t to_bytes(const string&, bytes);
+};
+
+
+namespace utf8 {
+
+/*
+  Return length of the longest prefix of the given string which is valid
+  UTF8.
+*/
+
+size_t valid_prefix(bytes);
+
+inline
+bool is_valid(bytes str)
+{
+  return str.size() == valid_prefix(str);
+}
+
+}  // utf8
+
+
+/*
+  Variable length integers
+  ========================
+  Decoding of unsigned integers stored in the varint encoding used by
+  Protobuf: 7 bits of the value per byte, least significant group first,
+  with the high bit of each byte set if more bytes follow.
+
+  The decoder does not look at one byte at a time. Up to 8 bytes are loaded
+  into a single word, the terminating byte is found from its high bit and
+  the 7-bit groups are put together with a fixed number of mask and shift
+  operations, which do not depend on the length of the value. Only values
+  longer than 8 bytes (above 2^56) need extra steps.
+*/
+
+namespace varint {
+
+/*
+  Decode varint from the beginning of the given buffer. Returns the number
+  of bytes used by the value, or 0 if the buffer does not start with
+  a complete varint.
+*/
+
+size_t decode(bytes, uint64_t&);
+
+/*
+  Decode a batch of `count` values, each stored in its own buffer. Empty
+  buffers are decoded as 0. Returns the number of values decoded, which is
+  less than `count` if a buffer does not contain a valid varint.
+*/
+
+size_t decode(const bytes *bufs, size_t count, uint64_t *vals);
+
+}  // varint
+
+
 // String utf8 codec
 
 template<>
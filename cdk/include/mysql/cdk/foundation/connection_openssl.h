@@ -58,6 +58,9 @@ public:
     return true;
   }
 
+  unsigned int get_fd() const;
+
+  class IO_op;
   class Read_op;
   class Read_some_op;
   class Write_op;
@@ -146,7 +149,44 @@ protected:
 };
 
 
-class TLS::Read_op : public Socket_base::IO_op
+/*
+  Base for TLS I/O operations.
+
+  The socket of a TLS connection is in non-blocking mode. If SSL_read() or
+  SSL_write() can not proceed, the operation is not completed and m_event
+  tells whether it waits for the socket to become readable or writable --
+  note that reading can require writing to the socket and vice versa. If
+  decrypted data is already buffered inside the TLS layer, a read operation
+  does not wait for any socket event (get_event_info() returns NULL).
+*/
+
+class TLS::IO_op : public Socket_base::IO_op
+{
+protected:
+
+  IO_op(TLS &conn, const buffers &bufs,
+        api::Event_info::event_type type, time_t deadline = 0);
+
+  TLS& m_tls;
+  const api::Event_info::event_type m_type;
+
+  /*
+    Process value returned by SSL_read() or SSL_write(). Returns the number
+    of bytes transferred, or 0 if the operation must wait for the socket
+    (m_event is set accordingly). Throws error if the call failed.
+  */
+
+  size_t check_result(int result);
+
+  // Block until the socket is ready for the operation to proceed.
+
+  void wait_socket();
+
+  const api::Event_info* get_event_info() const;
+};
+
+
+class TLS::Read_op : public TLS::IO_op
 {
 public:
   Read_op(TLS &conn, const buffers &bufs, time_t deadline = 0);
@@ -155,7 +195,6 @@ public:
   virtual void do_wait();
 
 private:
-  TLS& m_tls;
   unsigned int m_currentBufferIdx;
   size_t m_currentBufferOffset;
 
@@ -163,7 +202,7 @@ private:
 };
 
 
-class TLS::Read_some_op : public Socket_base::IO_op
+class TLS::Read_some_op : public TLS::IO_op
 {
 public:
   Read_some_op(TLS &conn, const buffers &bufs, time_t deadline = 0);
@@ -172,13 +211,11 @@ public:
   virtual void do_wait();
 
 private:
-  TLS& m_tls;
-
   bool common_read();
 };
 
 
-class TLS::Write_op : public Socket_base::IO_op
+class TLS::Write_op : public TLS::IO_op
 {
 public:
   Write_op(TLS &conn, const buffers &bufs, time_t deadline = 0);
@@ -187,7 +224,6 @@ public:
   virtual void do_wait();
 
 private:
-  TLS& m_tls;
   unsigned int m_currentBufferIdx;
   size_t m_currentBufferOffset;
 
@@ -195,7 +231,7 @@ private:
 };
 
 
-class TLS::Write_some_op : public Socket_base::IO_op
+class TLS::Write_some_op : public TLS::IO_op
 {
 public:
   Write_some_op(TLS &conn, const buffers &bufs, time_t deadline = 0);
@@ -204,8 +240,6 @@ public:
   virtual void do_wait();
 
 private:
-  TLS& m_tls;
-
   bool common_write();
 };
 
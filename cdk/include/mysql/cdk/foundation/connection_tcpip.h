@@ -105,6 +105,7 @@ class Socket_base
 public:
 
   class Impl;
+  class Event_info;
   class IO_op;
   class Read_op;
   class Read_some_op;
@@ -185,14 +186,42 @@ private:
 
 // Socket_base
 
+/*
+  Socket event for which a socket I/O operation waits: the socket descriptor
+  and whether the operation waits for the socket to become readable
+  (SOCKET_RD) or writable (SOCKET_WR). It is returned by waits_for() method
+  of socket I/O operations. It allows waiting for many operations at once
+  (see Event_loop).
+*/
+
+class Socket_base::Event_info : public api::Event_info
+{
+  event_type   m_type;
+  unsigned int m_fd;
+
+public:
+
+  Event_info(event_type type, unsigned int fd)
+    : m_type(type), m_fd(fd)
+  {}
+
+  event_type type() const { return m_type; }
+  unsigned int get_fd() const { return m_fd; }
+
+  void set_type(event_type type) { m_type = type; }
+};
+
+
 class Socket_base::IO_op : public Base::IO_op
 {
 protected:
 
   typedef Socket_base::Impl Impl;
 
-  IO_op(Socket_base &str, const buffers &bufs, time_t deadline =0)
+  IO_op(Socket_base &str, const buffers &bufs,
+        api::Event_info::event_type type, time_t deadline =0)
     :  Base::IO_op(str, bufs, deadline)
+    , m_event(type, str.get_fd())
   {}
 
   // Async_op interface
@@ -203,7 +232,9 @@ protected:
   virtual void do_cancel();
   virtual void do_wait() = 0;
 
-  const api::Event_info* get_event_info() const { return  NULL; }
+  Event_info m_event;
+
+  const api::Event_info* get_event_info() const { return &m_event; }
 };
 
 
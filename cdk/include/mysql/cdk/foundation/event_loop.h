@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef CDK_FOUNDATION_EVENT_LOOP_H
+#define CDK_FOUNDATION_EVENT_LOOP_H
+
+/*
+  Event loop which drives many asynchronous operations from a single thread.
+
+  Usage
+  =====
+
+  ::
+
+    Event_loop loop;
+
+    loop.add(op1, [](std::exception_ptr err) { ... });
+    loop.add(op2, [](std::exception_ptr err) { ... });
+
+    loop.run();
+
+  Operations added to the loop are pushed forward with cont() calls. When an
+  operation is not completed, the loop asks it what it waits for using
+  waits_for(). If an operation waits for a socket event (see
+  connection::Socket_base::Event_info), the loop does not call cont() again
+  until that event happens. Events for all operations are waited for together,
+  using epoll where available and poll() otherwise. Operations which do not
+  report any socket event are assumed to be able to progress and are given
+  cont() calls in each iteration of the loop.
+
+  When an operation completes, it is removed from the loop and its callback
+  is called with null argument. If cont() throws error, the operation is also
+  removed and the callback gets pointer to the exception.
+
+  Operations are not owned by the loop and must stay valid until their
+  callbacks are called or until they are removed from the loop. Callbacks
+  can add new operations to the loop.
+
+  Note: Operations that share a single connection (such as replies to
+  commands sent in the same session) can not be driven independently. Such
+  operations should be added to the loop one after another, when the previous
+  one is completed.
+*/
+
+#include "common.h"
+#include "async.h"
+#include "opaque_impl.h"
+#include "types.h"
+
+PUSH_SYS_WARNINGS
+#include <functional>
+#include <exception>
+POP_SYS_WARNINGS
+
+
+namespace cdk {
+namespace foundation {
+
+
+class Event_loop
+  : opaque_impl<Event_loop>
+  , nocopy
+{
+public:
+
+  typedef std::function<void(std::exception_ptr)>  Callback;
+
+  Event_loop();
+
+  /*
+    Add operation to the loop. Given callback is called when the operation
+    completes (or throws error).
+  */
+
+  void add(api::Async_op_base &op, const Callback &callback);
+
+  /*
+    Remove operation from the loop without calling its callback. Returns
+    false if the operation was not found.
+  */
+
+  bool remove(api::Async_op_base &op);
+
+  /*
+    Number of operations in the loop which are not completed yet.
+  */
+
+  size_t size() const;
+
+  /*
+    Perform one iteration of the loop: wait at most `timeout` milliseconds
+    for socket events (-1 means no limit) and push forward operations that
+    can progress. Returns false if there are no more operations in the loop.
+  */
+
+  bool run_once(int timeout = -1);
+
+  /*
+    Run the loop until all operations are completed.
+  */
+
+  void run();
+};
+
+
+}}  // cdk::foundation
+
+#endif
@@ -56,6 +56,19 @@ protected:
   Diagnostic_arena m_da;
   bool             m_error;
 
+  /*
+    Statement statistics are copied from the session when reply is
+    detached from it, so that they are still available after session
+    moves on to processing replies to other commands.
+  */
+
+  Session::Stmt_stats m_stmt_stats;
+  bool             m_executed;
+
+  // Reply to a command which is answered with Ok (see Session::ok()).
+
+  bool             m_ok_reply = false;
+
   Session& get_session()
   {
     if (!m_session)
@@ -68,6 +81,7 @@ public:
   Reply()
     : m_session(NULL)
     , m_error(false)
+    , m_executed(false)
   {}
 
   Reply(Reply_init& _init)
@@ -107,16 +121,12 @@ public:
 
   virtual row_count_t affected_rows()
   {
-    if (!m_session || has_results() || !m_session->m_executed)
-      throw_error("Only available after end of query execute");
-    return m_session->m_stmt_stats.rows_affected;
+    return get_stmt_stats().rows_affected;
   }
 
   row_count_t last_insert_id()
   {
-    if (!m_session || has_results() || !m_session->m_executed)
-      throw_error("Only available after end of query execute");
-    return m_session->m_stmt_stats.last_insert_id;
+    return get_stmt_stats().last_insert_id;
   }
 
   virtual void discard();
@@ -124,6 +134,8 @@ public:
 protected:
 
   void close_cursor();
+  void detach();
+  const Session::Stmt_stats& get_stmt_stats();
 
 private:
 
@@ -67,6 +67,7 @@ struct cdk::Format<cdk::TYPE_BYTES>::Access
 {
   typedef cdk::Format<cdk::TYPE_BYTES> Format;
   static void set_width(Format &o, uint64_t width) { o.m_width= width; }
+  static void set_bit(Format &o) { o.m_bit= true; }
 };
 
 
@@ -332,6 +333,12 @@ class Col_metadata
 
   void get_info(Format<TYPE_BYTES> &fmt) const
   {
+    if (protocol::mysqlx::col_type::BIT == m_type)
+    {
+      Format<TYPE_BYTES>::Access::set_bit(fmt);
+      return;
+    }
+
     // Note: flag 0x01 means that bytes should be padded with 0x00
 
     if (m_flags & 0x01)
@@ -426,6 +433,13 @@ protected:
   shared_ptr<Proto_op> m_cmd;
   enum { CMD_SQL, CMD_ADMIN, CMD_COLL_ADD } m_cmd_type;
 
+  /*
+    Set if the server replies to m_cmd with a single Ok message, as it does
+    for statement prepare and deallocate commands.
+  */
+
+  bool m_cmd_ok_reply = false;
+
   string m_stmt;
   Doc_args m_cmd_args;
   const Table_ref *m_table;
@@ -435,7 +449,7 @@ protected:
   string m_cur_schema;
   uint64_t m_proto_fields = UINT64_MAX;
 
-  struct
+  struct Stmt_stats
   {
     row_count_t  last_insert_id;
     row_count_t  rows_affected;
@@ -454,6 +468,25 @@ protected:
 
   std::deque< shared_ptr<Proto_op> > m_op_queue;
   std::deque< shared_ptr<Proto_op> > m_reply_op_queue;
+
+  /*
+    Commands are sent to the server as soon as a reply object is created
+    for them, even if reply to an earlier command (m_current_reply) is
+    still being processed. Replies to such commands wait in this queue
+    until they become current, in the same order in which the server
+    sends them. An entry with NULL m_reply is a reply that was discarded
+    before it became current - server reply is skipped when its turn comes.
+    The m_ok_reply flag is kept in the entry so that the skipped reply is
+    processed correctly (see Session::ok()).
+  */
+
+  struct Pending_reply
+  {
+    Reply *m_reply;
+    bool   m_ok_reply;
+  };
+
+  std::deque<Pending_reply> m_pending_replies;
   Cursor*                 m_current_cursor;
 
   bool m_executed;
@@ -482,7 +515,15 @@ public:
     , m_nr_cols(0)
   {
     m_stmt_stats.clear();
-    authenticate(options, conn.is_secure());
+    m_secure_conn = conn.is_secure();
+    save_options(options);
+    negotiate_compression(options);
+    authenticate(options, m_secure_conn);
+    /*
+      Messages of commands sent in a row (such as pipelined commands) are
+      written to the connection together (see Protocol::set_batching()).
+    */
+    m_protocol.set_batching(true);
     // TODO: make "lazy" checks instead, deferring to the time when given
     // feature is used.
     check_protocol_fields();
@@ -519,6 +560,22 @@ public:
 
   void close();
 
+  /*
+    Reset session state on the server side. After reset the session behaves
+    as a freshly created one: session variables, temporary tables, open
+    transaction etc. are gone and the default schema is current again. This
+    is much cheaper than creating a new connection.
+
+    If the server supports it, the session is reset with keep_open flag so
+    that it stays authenticated. Otherwise it is re-authenticated using
+    the same credentials as when the session was created.
+
+    Note: all replies to previous commands must be consumed before
+    resetting the session.
+  */
+
+  void reset();
+
   /*
     Transactions
   */
@@ -533,7 +590,7 @@ public:
      SQL API
   */
 
-  Reply_init &sql(const string&, Any_list*);
+  Reply_init &sql(const string&, Any_list*, uint32_t stmt_id = 0);
 
   Reply_init &admin(const char*, const cdk::Any::Document&);
 
@@ -544,13 +601,15 @@ public:
   Reply_init &coll_add(const Table_ref&,
                        Doc_source&,
                        const Param_source *param = NULL,
-                       bool upsert = false);
+                       bool upsert = false,
+                       size_t max_size = 0);
 
   Reply_init &coll_remove(const Table_ref&,
                           const Expression *expr = NULL,
                           const Order_by *order_by = NULL,
                           const Limit *lim = NULL,
-                          const Param_source *param = NULL);
+                          const Param_source *param = NULL,
+                          uint32_t stmt_id = 0);
   Reply_init &coll_find(const Table_ref&,
                         const View_spec *view = NULL,
                         const Expression *expr = NULL,
@@ -560,19 +619,22 @@ public:
                         const Expression *having = NULL,
                         const Limit *lim = NULL,
                         const Param_source *param = NULL,
-                        const Lock_mode_value lock_mode = Lock_mode_value::NONE);
+                        const Lock_mode_value lock_mode = Lock_mode_value::NONE,
+                        uint32_t stmt_id = 0);
   Reply_init &coll_update(const api::Table_ref&,
                           const Expression*,
                           const Update_spec&,
                           const Order_by *order_by = NULL,
                           const Limit* = NULL,
-                          const Param_source * = NULL);
+                          const Param_source * = NULL,
+                          uint32_t stmt_id = 0);
 
   Reply_init &table_delete(const Table_ref&,
                            const Expression *expr = NULL,
                            const Order_by *order_by = NULL,
                            const Limit *lim = NULL,
-                           const Param_source *param = NULL);
+                           const Param_source *param = NULL,
+                           uint32_t stmt_id = 0);
   Reply_init &table_select(const Table_ref&,
                            const View_spec *view = NULL,
                            const Expression *expr = NULL,
@@ -582,20 +644,37 @@ public:
                            const Expression *having = NULL,
                            const Limit *lim = NULL,
                            const Param_source *param = NULL,
-                           const Lock_mode_value lock_mode = Lock_mode_value::NONE);
+                           const Lock_mode_value lock_mode = Lock_mode_value::NONE,
+                           uint32_t stmt_id = 0);
   Reply_init &table_insert(const Table_ref&,
                            Row_source&,
                            const api::Columns *cols,
-                           const Param_source *param = NULL);
+                           const Param_source *param = NULL,
+                           size_t max_size = 0);
   Reply_init &table_update(const api::Table_ref &coll,
                            const Expression *expr,
                            const Update_spec &us,
                            const Order_by *order_by = NULL,
                            const Limit *lim = NULL,
-                           const Param_source *param = NULL);
+                           const Param_source *param = NULL,
+                           uint32_t stmt_id = 0);
 
   Reply_init &view_drop(const api::Table_ref&, bool check_existence = false);
 
+  /*
+    Prepared statements
+
+    If non-zero stmt_id is passed to one of the methods above, the statement
+    is not executed but prepared on the server under this id. Reply to such
+    request has no results. Prepared statement is executed with
+    prepared_execute(), passing values of its parameters, and released with
+    prepared_deallocate().
+  */
+
+  Reply_init &prepared_execute(uint32_t stmt_id, const Param_source *param);
+  Reply_init &prepared_execute(uint32_t stmt_id, Any_list *args);
+  Reply_init &prepared_deallocate(uint32_t stmt_id);
+
 
   /*
       Async (cdk::api::Async_op)
@@ -624,7 +703,20 @@ public:
 
 private:
 
-  Reply_init &set_command(Proto_op *cmd);
+  Reply_init &set_command(Proto_op *cmd, bool ok_reply = false);
+
+  /*
+    Credentials used to authenticate the session, kept for re-authentication
+    after session reset.
+  */
+
+  ds::mysqlx::Options m_options;
+  bool m_secure_conn = false;
+
+  void save_options(const Options&);
+
+  // Enable compression of protocol messages, if requested in the options
+  void negotiate_compression(const Options&);
 
   // Authentication (cdk::protocol::mysqlx::Auth_processor)
   void authenticate(const Options &options, bool secure = false);
@@ -644,6 +736,13 @@ private:
   virtual void register_reply(Reply* reply);
   virtual void deregister_reply(Reply*);
 
+  /*
+    Make given reply the current one, skipping (remaining parts of) replies
+    to earlier commands. If reply is NULL, all pending replies are skipped.
+  */
+
+  void make_current(Reply*);
+
   /*
      Mdata_processor (cdk::protocol::mysqlx::Mdata_processor)
   */
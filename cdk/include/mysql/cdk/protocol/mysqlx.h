@@ -85,7 +85,11 @@ enum ClientMessages_Type {
   ClientMessages_Type_EXPECT_CLOSE = 25,
   ClientMessages_Type_CRUD_CREATE_VIEW = 30,
   ClientMessages_Type_CRUD_MODIFY_VIEW = 31,
-  ClientMessages_Type_CRUD_DROP_VIEW = 32
+  ClientMessages_Type_CRUD_DROP_VIEW = 32,
+  ClientMessages_Type_PREPARE_PREPARE = 40,
+  ClientMessages_Type_PREPARE_EXECUTE = 41,
+  ClientMessages_Type_PREPARE_DEALLOCATE = 42,
+  ClientMessages_Type_COMPRESSION = 46
 };
 
 enum ServerMessages_Type {
@@ -101,7 +105,8 @@ enum ServerMessages_Type {
   ServerMessages_Type_RESULTSET_FETCH_SUSPENDED = 15,
   ServerMessages_Type_RESULTSET_FETCH_DONE_MORE_RESULTSETS = 16,
   ServerMessages_Type_SQL_STMT_EXECUTE_OK = 17,
-  ServerMessages_Type_RESULTSET_FETCH_DONE_MORE_OUT_PARAMS = 18
+  ServerMessages_Type_RESULTSET_FETCH_DONE_MORE_OUT_PARAMS = 18,
+  ServerMessages_Type_COMPRESSION = 19
 };
 
 
@@ -159,6 +164,12 @@ enum ServerMessages_Type {
     MSG_CLIENT(X, Mysqlx::Crud::CreateView, CreateView, CRUD_CREATE_VIEW) \
     MSG_CLIENT(X, Mysqlx::Crud::ModifyView, ModifyView, CRUD_MODIFY_VIEW) \
     MSG_CLIENT(X, Mysqlx::Crud::DropView, DropView, CRUD_DROP_VIEW) \
+    MSG_CLIENT(X, Mysqlx::Prepare::Prepare, \
+               PreparePrepare, PREPARE_PREPARE) \
+    MSG_CLIENT(X, Mysqlx::Prepare::Execute, \
+               PrepareExecute, PREPARE_EXECUTE) \
+    MSG_CLIENT(X, Mysqlx::Prepare::Deallocate, \
+               PrepareDeallocate, PREPARE_DEALLOCATE) \
 \
     MSG_SERVER(X, Mysqlx::Ok, \
                Ok, OK) \
@@ -325,6 +336,18 @@ struct notice_scope
 };
 
 
+/*
+  Compression algorithms that can be used on the wire once negotiated
+  with the "compression" capability. Only DEFLATE ("deflate_stream") is
+  currently implemented.
+*/
+
+struct compression_type
+{
+  enum value { NONE = 0, DEFLATE = 1 };
+};
+
+
 /*
   A class to store SQL state values.
 */
@@ -447,7 +470,7 @@ struct Protocol_fields
     Enum values will be used as binary flags,
     so they must be as 2^N
   */
-  enum value { ROW_LOCKING = 1 , UPSERT = 2 };
+  enum value { ROW_LOCKING = 1 , UPSERT = 2, KEEP_OPEN = 4 };
 };
 
 }  // api namespace
@@ -512,10 +535,55 @@ public:
   template <class C> Protocol(C &conn);
 
   Op& snd_CapabilitiesSet(const api::Any::Document& caps);
+
+  /**
+    Enable compression of messages exchanged with the server.
+
+    This should be called after the server accepted compression settings
+    sent with `snd_CapabilitiesSet()`. From then on, messages of size
+    at least `threshold` bytes are sent inside compressed frames and
+    compressed frames received from the server are decompressed
+    transparently. Passing `compression_type::NONE` disables compression.
+  */
+
+  void set_compression(compression_type::value, size_t threshold = 1000);
+
+  /**
+    Enable or disable batching of outgoing messages.
+
+    When batching is enabled, messages sent with `snd_XXX()` methods are
+    collected in the output buffer and their send operations complete
+    without writing to the connection. Collected messages are written
+    together, with a single write operation, when reading of the next
+    server message starts, when `flush()` is called or when more than
+    `limit` bytes have been collected. Disabling batching writes collected
+    messages first.
+  */
+
+  void set_batching(bool, size_t limit = 16*1024);
+
+  /**
+    Write messages collected in the output buffer (see `set_batching()`).
+  */
+
+  Op& flush();
+
   Op& snd_AuthenticateStart(const char* mechanism, bytes data, bytes response);
   Op& snd_AuthenticateContinue(bytes data);
   Op& snd_Close();
 
+  /**
+    Send request to reset the session state.
+
+    Server replies with Ok message (see `rcv_Reply()`). Session variables,
+    temporary tables, prepared statements etc. are released. If keep_open
+    is false, the session needs to be authenticated again before it can be
+    used. Otherwise it stays authenticated (servers which do not support
+    this report it with Protocol_fields::KEEP_OPEN).
+  */
+
+  Op& snd_SessionReset(bool keep_open = false);
+
 
   /**
     Send protocol command which executes a statement.
@@ -579,13 +647,19 @@ public:
       the same id as an existing document in the collection, the upsert variant
       replaces the document in the collection with the new one. Without upsert
       flag such situation leads to error.
+
+    @param max_size  If not 0, rows are taken from the row source only until
+      their total encoded size reaches `max_size` bytes (at least one row is
+      always taken). The row source is not advanced past the last row included
+      in the command, so that remaining rows can be sent in another command.
   */
 
   Op& snd_Insert(Data_model dm, api::Db_obj &obj,
                  const api::Columns *columns,
                  Row_source &data,
                  const api::Args_map *args = NULL,
-                 bool upsert = false);
+                 bool upsert = false,
+                 size_t max_size = 0);
 
   /**
     Send CRUD Update command.
@@ -629,6 +703,53 @@ public:
                  const api::Args_map *args = NULL);
 
 
+  /**
+    Send request to prepare a statement for later execution.
+
+    These methods take the same parameters as the corresponding snd_XXX()
+    methods, but instead of executing the statement, the server prepares it
+    and stores it under client-assigned id `stmt_id`. Server replies with Ok
+    message (see `rcv_Reply()`). The prepared statement is then executed with
+    `snd_PrepareExecute()` and released with `snd_PrepareDeallocate()`.
+
+    Values of named parameters given by `args` are not sent to the server
+    -- the argument map is used only to determine positions of these
+    parameters. When executing the statement, argument map with the same
+    keys must be used.
+  */
+
+  Op& snd_PrepareStmtExecute(uint32_t stmt_id, const char *ns,
+                             const string &stmt);
+  Op& snd_PrepareFind(uint32_t stmt_id, Data_model dm, const Find_spec &spec,
+                      const api::Args_map *args = NULL);
+  Op& snd_PrepareUpdate(uint32_t stmt_id, Data_model dm,
+                        const Select_spec &select,
+                        Update_spec &update,
+                        const api::Args_map *args = NULL);
+  Op& snd_PrepareDelete(uint32_t stmt_id, Data_model dm,
+                        const Select_spec &select,
+                        const api::Args_map *args = NULL);
+
+  /**
+    Send request to execute statement prepared earlier with id `stmt_id`.
+
+    Server reply is the same as for the statement that was prepared. Values
+    of statement parameters are given either as an argument map (for CRUD
+    statements with named parameters) or as a list of values (for SQL
+    statements with "?" placeholders).
+  */
+
+  Op& snd_PrepareExecute(uint32_t stmt_id, const api::Args_map *args);
+  Op& snd_PrepareExecute(uint32_t stmt_id, const api::Any_list *args);
+
+  /**
+    Send request to release statement prepared with id `stmt_id`.
+
+    Server replies with Ok message (see `rcv_Reply()`).
+  */
+
+  Op& snd_PrepareDeallocate(uint32_t stmt_id);
+
   Op& snd_CreateView(Data_model dm, const api::Db_obj &obj,
                      const Find_spec &query, const api::Columns *columns,
                      bool replace = false,
@@ -682,6 +803,8 @@ public:
 
   template <class C> Protocol_server(C &conn);
 
+  void set_compression(compression_type::value, size_t threshold = 1000);
+
   Op& snd_AuthenticateContinue(bytes data);
   Op& snd_AuthenticateOK(bytes data);
   Op& snd_Ok(const string &msg);
@@ -707,6 +830,10 @@ private:
   create read or write operation, respectively, using appropriate operation
   type C::Read_op or C::Write_op. This operation is allocated dynamically
   and should be deleted by the caller of the method.
+
+  Method read_some() creates C::Read_some_op operation which completes as
+  soon as some bytes are available, without waiting for the whole buffer
+  to be filled. It is used to read ahead as many bytes as are available.
 */
 
 class Protocol::Stream
@@ -721,6 +848,7 @@ public:
   {}
 
   virtual Op* read(const buffers&) =0;
+  virtual Op* read_some(const buffers&) =0;
   virtual Op* write(const buffers&) =0;
 
 private:
@@ -741,6 +869,7 @@ template <class C>
 class Protocol::Stream::Impl : public Stream
 {
   typedef typename C::Read_op  Rd_op;
+  typedef typename C::Read_some_op  Rd_some_op;
   typedef typename C::Write_op Wr_op;
 
   C &m_conn;
@@ -750,6 +879,9 @@ class Protocol::Stream::Impl : public Stream
   Op* read(const buffers &buf)
   { return new Rd_op(m_conn, buf); }
 
+  Op* read_some(const buffers &buf)
+  { return new Rd_some_op(m_conn, buf); }
+
   Op* write(const buffers &buf)
   { return new Wr_op(m_conn, buf); }
 
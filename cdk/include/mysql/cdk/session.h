@@ -87,6 +87,16 @@ public:
     m_connection->close();
   }
 
+  /*
+    Reset the session to the state it had right after it was created,
+    re-using the existing connection. Any open transaction is rolled back
+    and session variables are cleared.
+  */
+
+  void reset() {
+    m_session->reset();
+  }
+
   /*
     Transactions
     ------------
@@ -195,9 +205,10 @@ public:
     `args` list.
   */
 
-  Reply_init sql(const string &query, Any_list *args =NULL)
+  Reply_init sql(const string &query, Any_list *args =NULL,
+                 uint32_t stmt_id = 0)
   {
-    return m_session->sql(query, args);
+    return m_session->sql(query, args, stmt_id);
   }
 
   /**
@@ -231,6 +242,9 @@ public:
     Param_source *param -- optional object which specifies values for named
                           parameters used in expressions that are passed to
                           the operation (such as selection criteria).
+    uint32_t stmt_id    -- if not 0, the operation is not executed but
+                          prepared on the server as a statement with this
+                          id (see "Prepared statements" below).
   */
 
   // CRUD for Collections
@@ -252,6 +266,12 @@ public:
     an error is reported if a document being added conflicts with an exisiting
     document in the collection.
 
+    If `max_size` is not 0, documents are taken from the source only until
+    their total encoded size reaches `max_size` bytes (but at least one
+    document is always sent). The source is then left positioned at the last
+    document that was sent, and the remaining documents can be inserted with
+    another coll_add() call.
+
     Note: Server requires that inserted documents contain "_id" field with
     unique document id.
   */
@@ -259,9 +279,10 @@ public:
   Reply_init coll_add(const api::Object_ref &coll,
                       Doc_source &docs,
                       const Param_source *param,
-                      bool upsert = false)
+                      bool upsert = false,
+                      size_t max_size = 0)
   {
-    return m_session->coll_add(coll, docs, param, upsert);
+    return m_session->coll_add(coll, docs, param, upsert, max_size);
   }
 
   /**
@@ -276,9 +297,10 @@ public:
                          const Expression *expr = NULL,
                          const Order_by *order_by = NULL,
                          const Limit *lim = NULL,
-                         const Param_source *param = NULL)
+                         const Param_source *param = NULL,
+                         uint32_t stmt_id = 0)
   {
-    return m_session->coll_remove(coll, expr, order_by, lim, param);
+    return m_session->coll_remove(coll, expr, order_by, lim, param, stmt_id);
   }
 
   /**
@@ -311,11 +333,13 @@ public:
                        const Expression *having = NULL,
                        const Limit *lim = NULL,
                        const Param_source *param = NULL,
-                       const Lock_mode_value lock_mode = Lock_mode_value::NONE
+                       const Lock_mode_value lock_mode = Lock_mode_value::NONE,
+                       uint32_t stmt_id = 0
                        )
   {
     return m_session->coll_find(coll, view, expr, proj, order_by,
-                                group_by, having, lim, param, lock_mode);
+                                group_by, having, lim, param, lock_mode,
+                                stmt_id);
   }
 
   /**
@@ -334,9 +358,11 @@ public:
                          const Update_spec &us,
                          const Order_by *order_by = NULL,
                          const Limit *lim = NULL,
-                         const Param_source *param = NULL)
+                         const Param_source *param = NULL,
+                         uint32_t stmt_id = 0)
   {
-    return m_session->coll_update(table, expr, us, order_by, lim, param);
+    return m_session->coll_update(table, expr, us, order_by, lim, param,
+                                  stmt_id);
   }
 
   // Table CRUD
@@ -365,10 +391,12 @@ public:
                           const Expression *having = NULL,
                           const Limit* lim = NULL,
                           const Param_source *param = NULL,
-                          const Lock_mode_value lock_mode = Lock_mode_value::NONE)
+                          const Lock_mode_value lock_mode = Lock_mode_value::NONE,
+                          uint32_t stmt_id = 0)
   {
     return m_session->table_select(tab, view, expr, proj, order_by,
-                                   group_by, having, lim, param, lock_mode);
+                                   group_by, having, lim, param, lock_mode,
+                                   stmt_id);
   }
 
   /**
@@ -377,14 +405,17 @@ public:
     Insert rows given by a Row_source object. A Row_source object is a sequence
     of rows where each row is described by a list of expressions, one
     expression per one column in the row.
+
+    The `max_size` limit works as in coll_add().
   */
 
   Reply_init table_insert(const api::Table_ref &tab,
                           Row_source &rows,
                           const api::Columns *cols,
-                          const Param_source *param)
+                          const Param_source *param,
+                          size_t max_size = 0)
   {
-    return m_session->table_insert(tab, rows, cols, param);
+    return m_session->table_insert(tab, rows, cols, param, max_size);
   }
 
   /**
@@ -399,9 +430,10 @@ public:
                           const Expression *expr,
                           const Order_by *order_by,
                           const Limit* lim = NULL,
-                          const Param_source *param = NULL)
+                          const Param_source *param = NULL,
+                          uint32_t stmt_id = 0)
   {
-    return m_session->table_delete(tab, expr, order_by, lim, param);
+    return m_session->table_delete(tab, expr, order_by, lim, param, stmt_id);
   }
 
 
@@ -421,9 +453,46 @@ public:
                           const Update_spec &us,
                           const Order_by *order_by,
                           const Limit *lim = NULL,
-                          const Param_source *param = NULL)
+                          const Param_source *param = NULL,
+                          uint32_t stmt_id = 0)
+  {
+    return m_session->table_update(tab, expr, us, order_by, lim, param,
+                                   stmt_id);
+  }
+
+
+  // Prepared statements
+  // -------------------
+
+  /**
+    Execute statement prepared earlier with id `stmt_id`.
+
+    A statement is prepared by passing non-zero `stmt_id` to one of the
+    sql(), coll_find(), coll_update(), coll_remove(), table_select(),
+    table_update() or table_delete() methods -- the reply to such request
+    has no results and reports error if statement could not be prepared.
+    When executing a prepared CRUD statement, parameter values must be
+    given by `param` with the same keys as when it was prepared. Prepared
+    SQL statement takes values of its "?" placeholders from `args` list.
+  */
+
+  Reply_init prepared_execute(uint32_t stmt_id, const Param_source *param)
+  {
+    return m_session->prepared_execute(stmt_id, param);
+  }
+
+  Reply_init prepared_execute(uint32_t stmt_id, Any_list *args)
+  {
+    return m_session->prepared_execute(stmt_id, args);
+  }
+
+  /**
+    Release statement prepared with id `stmt_id`.
+  */
+
+  Reply_init prepared_deallocate(uint32_t stmt_id)
   {
-    return m_session->table_update(tab, expr, us, order_by, lim, param);
+    return m_session->prepared_deallocate(stmt_id);
   }
 
 
@@ -165,9 +165,15 @@ protected:
   const char *m_ns;
   const string m_stmt;
   Any_list *m_args;
+  uint32_t m_stmt_id;
 
   Proto_op* start()
   {
+    // If statement id is given, statement is prepared instead of executed.
+
+    if (m_stmt_id)
+      return &m_protocol.snd_PrepareStmtExecute(m_stmt_id, m_ns, m_stmt);
+
     Any_list_converter conv;
     if (m_args)
       conv.reset(*m_args);
@@ -177,9 +183,75 @@ protected:
 public:
 
   SndStmt(Protocol& protocol, const char *ns,
-          const string& stmt, Any_list *args)
+          const string& stmt, Any_list *args,
+          uint32_t stmt_id = 0)
     : Proto_delayed_op(protocol), m_ns(ns)
-    , m_stmt(stmt), m_args(args)
+    , m_stmt(stmt), m_args(args), m_stmt_id(stmt_id)
+  {}
+};
+
+
+// -------------------------------------------------------------------------
+
+
+/*
+  Execution of a prepared statement. Values of statement parameters are
+  given either as a key-value map (for CRUD statements) or as a list of
+  values (for SQL statements).
+*/
+
+class SndPrepareExecute
+    : public Proto_delayed_op
+{
+protected:
+
+  uint32_t        m_stmt_id;
+  Param_converter m_param_conv;
+  Any_list        *m_list;
+
+  Proto_op* start()
+  {
+    if (m_list)
+    {
+      Any_list_converter conv;
+      conv.reset(*m_list);
+      return &m_protocol.snd_PrepareExecute(m_stmt_id, &conv);
+    }
+
+    return &m_protocol.snd_PrepareExecute(m_stmt_id, m_param_conv.get());
+  }
+
+public:
+
+  SndPrepareExecute(Protocol& protocol, uint32_t stmt_id,
+                    const cdk::Param_source *param)
+    : Proto_delayed_op(protocol), m_stmt_id(stmt_id)
+    , m_param_conv(param), m_list(NULL)
+  {}
+
+  SndPrepareExecute(Protocol& protocol, uint32_t stmt_id, Any_list *list)
+    : Proto_delayed_op(protocol), m_stmt_id(stmt_id)
+    , m_param_conv(NULL), m_list(list)
+  {}
+};
+
+
+class SndPrepareDeallocate
+    : public Proto_delayed_op
+{
+protected:
+
+  uint32_t m_stmt_id;
+
+  Proto_op* start()
+  {
+    return &m_protocol.snd_PrepareDeallocate(m_stmt_id);
+  }
+
+public:
+
+  SndPrepareDeallocate(Protocol& protocol, uint32_t stmt_id)
+    : Proto_delayed_op(protocol), m_stmt_id(stmt_id)
   {}
 };
 
@@ -196,6 +268,7 @@ protected:
   cdk::Doc_source &m_docs;
   const Param_source *m_param;
   bool m_upsert;
+  size_t m_max_size;
 
   Proto_op* start()
   {
@@ -209,7 +282,8 @@ protected:
                                   NULL,
                                   *this,
                                   &param_conv,
-                                  m_upsert);
+                                  m_upsert,
+                                  m_max_size);
   }
 
 public:
@@ -217,11 +291,13 @@ public:
   SndInsertDocs(Protocol& protocol, const api::Table_ref &coll,
                 cdk::Doc_source &docs,
                 const Param_source *param,
-                bool upsert = false)
+                bool upsert = false,
+                size_t max_size = 0)
     : Crud_op_base(protocol, coll)
     , m_docs(docs)
     , m_param(param)
     , m_upsert(upsert)
+    , m_max_size(max_size)
   {}
 
 private:
@@ -261,6 +337,7 @@ protected:
   cdk::Row_source &m_rows;
   const api::Columns *m_cols;
   const Param_source *m_param;
+  size_t m_max_size;
 
   Proto_op* start()
   {
@@ -273,7 +350,9 @@ protected:
                                   *this,
                                   m_cols,
                                   *this,
-                                  &param_conv);
+                                  &param_conv,
+                                  false,
+                                  m_max_size);
   }
 
 public:
@@ -284,9 +363,10 @@ public:
                 const api::Table_ref &coll,
                 cdk::Row_source &rows,
                 const api::Columns *cols,
-                const Param_source *param)
+                const Param_source *param,
+                size_t max_size = 0)
     : Crud_op_base(protocol, coll)
-    , m_rows(rows), m_cols(cols), m_param(param)
+    , m_rows(rows), m_cols(cols), m_param(param), m_max_size(max_size)
   {}
 
 private:
@@ -380,6 +460,13 @@ protected:
   Order_by_converter m_ord_conv;
   const Limit       *m_limit;
 
+  /*
+    If not 0, the operation is prepared on the server under this id
+    instead of being executed.
+  */
+
+  uint32_t           m_stmt_id;
+
 
   Select_op_base(
     Protocol &protocol,
@@ -387,11 +474,12 @@ protected:
     const cdk::Expression *expr,
     const cdk::Order_by *order_by,
     const cdk::Limit *lim = NULL,
-    const cdk::Param_source *param = NULL
+    const cdk::Param_source *param = NULL,
+    uint32_t stmt_id = 0
   )
     : Crud_op_base(protocol, obj)
     , m_expr_conv(expr), m_param_conv(param), m_ord_conv(order_by)
-    , m_limit(lim)
+    , m_limit(lim), m_stmt_id(stmt_id)
   {}
 
 
@@ -432,6 +520,9 @@ protected:
 
   Proto_op* start()
   {
+    if (m_stmt_id)
+      return &m_protocol.snd_PrepareDelete(m_stmt_id, DM, *this,
+                                           m_param_conv.get());
     return &m_protocol.snd_Delete(DM, *this, m_param_conv.get());
   }
 
@@ -441,8 +532,9 @@ public:
             const cdk::Expression *expr,
             const cdk::Order_by *order_by,
             const cdk::Limit *lim = NULL,
-            const cdk::Param_source *param = NULL)
-    : Select_op_base(protocol, obj, expr, order_by, lim, param)
+            const cdk::Param_source *param = NULL,
+            uint32_t stmt_id = 0)
+    : Select_op_base(protocol, obj, expr, order_by, lim, param, stmt_id)
   {}
 
 };
@@ -581,6 +673,9 @@ protected:
 
   Proto_op* start()
   {
+    if (m_stmt_id)
+      return &m_protocol.snd_PrepareFind(m_stmt_id, DM, *this,
+                                         m_param_conv.get());
     return &m_protocol.snd_Find(DM, *this, m_param_conv.get());
   }
 
@@ -595,9 +690,10 @@ public:
     const cdk::Expression *having = NULL,
     const cdk::Limit *lim = NULL,
     const cdk::Param_source *param = NULL,
-    const Lock_mode_value locking = Lock_mode_value::NONE
+    const Lock_mode_value locking = Lock_mode_value::NONE,
+    uint32_t stmt_id = 0
   )
-    : Select_op_base(protocol, coll, expr, order_by, lim, param)
+    : Select_op_base(protocol, coll, expr, order_by, lim, param, stmt_id)
     , m_proj_conv(proj)
     , m_group_by_conv(group_by), m_having_conv(having)
     , m_lock_mode(locking)
@@ -1071,6 +1167,9 @@ protected:
 
   Proto_op* start()
   {
+    if (m_stmt_id)
+      return &m_protocol.snd_PrepareUpdate(m_stmt_id, DM, *this, m_upd_conv,
+                                           m_param_conv.get());
     return &m_protocol.snd_Update(DM, *this, m_upd_conv, m_param_conv.get());
   }
 
@@ -1082,8 +1181,9 @@ public:
             const cdk::Update_spec &us,
             const cdk::Order_by *order_by,
             const cdk::Limit *lim = NULL,
-            const cdk::Param_source *param = NULL)
-    : Select_op_base(protocol, table, expr, order_by, lim, param)
+            const cdk::Param_source *param = NULL,
+            uint32_t stmt_id = 0)
+    : Select_op_base(protocol, table, expr, order_by, lim, param, stmt_id)
     , m_upd_conv(DM, us)
   {}
 
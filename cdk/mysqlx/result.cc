@@ -63,13 +63,16 @@ Reply::~Reply()
 void Reply::init(Reply_init &init)
 {
   m_error = false;
+  m_executed = false;
   m_da.clear();
   m_session = &init;
 
-  init.register_reply(this);
+  /*
+    Note: this sends the command to the server. Reading server reply starts
+    when this reply becomes the current one.
+  */
 
-  m_session->send_cmd();
-  m_session->start_reading_result();
+  init.register_reply(this);
 }
 
 
@@ -78,7 +81,8 @@ void Reply::close_cursor()
   if (NULL == m_session)
     return;
 
-  assert(this == m_session->m_current_reply);
+  if (this != m_session->m_current_reply)
+    return;
 
   if (m_session->m_current_cursor)
     m_session->m_current_cursor->close();
@@ -86,13 +90,39 @@ void Reply::close_cursor()
 
 
 void Reply::discard()
+{
+  detach();
+
+  // Statement statistics are not available after discarding the reply.
+
+  m_executed = false;
+}
+
+
+/*
+  Skip remaining parts of the reply and detach it from the session, so that
+  session can move to the next reply. Statement statistics are still
+  available after that.
+*/
+
+void Reply::detach()
 {
   // TODO: workaround whenever there is no way to cancel a protocol command
 
   if (NULL == m_session)
     return;
 
-  assert(this == m_session->m_current_reply);
+  /*
+    If reply is not current yet, session will skip it when its turn
+    comes (see Session::make_current()).
+  */
+
+  if (this != m_session->m_current_reply)
+  {
+    m_session->deregister_reply(this);
+    m_session = NULL;
+    return;
+  }
 
   if (m_session->m_current_cursor)
     throw_error("Cursor in usage!");
@@ -105,6 +135,10 @@ void Reply::discard()
   }
 
   m_session->m_discard = false;
+
+  m_executed = m_session->m_executed;
+  m_stmt_stats = m_session->m_stmt_stats;
+
   m_session->deregister_reply(this);
   m_session = NULL;
 }
@@ -115,8 +149,6 @@ bool Reply::has_results()
   if (NULL == m_session)
     return false;
 
-  assert(this == m_session->m_current_reply);
-
   // If we hit error, do not continue.
 
   if (entry_count() > 0)
@@ -129,6 +161,7 @@ bool Reply::has_results()
   if (entry_count() > 0)
     return false;
 
+  assert(this == m_session->m_current_reply);
   return m_session->m_has_results;
 }
 
@@ -138,11 +171,11 @@ void Reply::skip_result()
   if (NULL == m_session)
     throw_error("Session not initialized");
 
-  assert(this == m_session->m_current_reply);
-
   if (entry_count() > 0)
     return;
 
+  m_session->make_current(this);
+
   if (m_session->m_current_cursor)
     throw_error("Cursor in usage!");
 
@@ -158,6 +191,21 @@ void Reply::skip_result()
 }
 
 
+const Session::Stmt_stats& Reply::get_stmt_stats()
+{
+  if (!m_session)
+  {
+    if (!m_executed)
+      throw_error("Only available after end of query execute");
+    return m_stmt_stats;
+  }
+
+  if (has_results() || !m_session->m_executed)
+    throw_error("Only available after end of query execute");
+  return m_session->m_stmt_stats;
+}
+
+
 // Async_op
 
 
@@ -166,7 +214,10 @@ bool Reply::is_completed() const
   if (!m_session)
     return true;
 
-  assert(this == m_session->m_current_reply);
+  // Reply to a command that is not current yet was not read.
+
+  if (this != m_session->m_current_reply)
+    return false;
 
   if (!m_session->m_reply_op_queue.empty())
     return false;
@@ -175,12 +226,18 @@ bool Reply::is_completed() const
 }
 
 
+/*
+  Note: If this reply is not yet the current one, replies to earlier
+  commands are skipped first. It is up to the user of replies to consume
+  them in the order in which the commands were sent.
+*/
+
 bool Reply::do_cont()
 {
   if (!m_session)
     return true;
 
-  assert(this == m_session->m_current_reply);
+  m_session->make_current(this);
 
   if (m_session->m_reply_op_queue.empty())
     return true;
@@ -212,6 +269,11 @@ bool Reply::do_cont()
 
 void Reply::do_wait()
 {
+  if (!m_session)
+    return;
+
+  m_session->make_current(this);
+
   while (m_session && !m_session->m_reply_op_queue.empty())
   {
     assert(this == m_session->m_current_reply);
@@ -246,6 +308,9 @@ void Reply::do_cancel()
 
 const cdk::api::Event_info* Reply::get_event_info() const
 {
+  if (this != m_session->m_current_reply)
+    return NULL;
+
   if (!m_session->m_reply_op_queue.empty())
     return m_session->m_reply_op_queue.front()->waits_for();
 
@@ -94,6 +94,10 @@ struct Proto_field_checker : public cdk::protocol::mysqlx::api::Expectations
         // Insert=18, upsert=6
         m_data = bytes("18.6");
         break;
+      case Protocol_fields::KEEP_OPEN:
+        // Reset=6, keep_open=1
+        m_data = bytes("6.1");
+        break;
       default:
         return 0;
     }
@@ -353,6 +357,88 @@ void Session::authenticate(const Session::Options &options,
 }
 
 
+void Session::save_options(const Options &options)
+{
+  m_options = ds::mysqlx::Options(options.user(), options.password());
+  if (options.database())
+    m_options.set_database(*options.database());
+  m_options.set_auth_method(options.auth_method());
+}
+
+
+/*
+  Ask the server to compress messages using the "deflate_stream" algorithm
+  and enable compression in the protocol layer if it agrees. We also ask
+  the server to combine several messages in one compressed frame, which
+  is handled transparently by the protocol layer.
+*/
+
+void Session::negotiate_compression(const Options &options)
+{
+  using cdk::ds::mysqlx::Protocol_options;
+
+  if (Protocol_options::COMPRESSION_DISABLED == options.compression())
+    return;
+
+#ifdef HAVE_COMPRESSION
+
+  struct : cdk::protocol::mysqlx::api::Any::Document
+  {
+    void process(Processor &prc) const
+    {
+      prc.doc_begin();
+      auto cap = cdk::safe_prc(prc)->key_val("compression")->doc();
+      cap->doc_begin();
+      cap->key_val("algorithm")->scalar()->str("deflate_stream");
+      cap->key_val("server_combine_mixed_messages")->scalar()->yesno(true);
+      cap->doc_end();
+      prc.doc_end();
+    }
+  } caps;
+
+  m_protocol.snd_CapabilitiesSet(caps).wait();
+
+  struct : cdk::protocol::mysqlx::Reply_processor
+  {
+    bool m_ok = true;
+    unsigned m_code = 0;
+    sql_state_t m_sql_state;
+    string m_msg;
+
+    void error(unsigned int code, short int,
+               sql_state_t sql_state, const string &msg)
+    {
+      m_ok = false;
+      m_code = code;
+      m_sql_state = sql_state;
+      m_msg = msg;
+    }
+  } prc;
+
+  m_protocol.rcv_Reply(prc).wait();
+
+  if (prc.m_ok)
+  {
+    m_protocol.set_compression(
+      cdk::protocol::mysqlx::compression_type::DEFLATE
+    );
+    return;
+  }
+
+  if (Protocol_options::COMPRESSION_REQUIRED == options.compression())
+    throw Server_error(prc.m_code, prc.m_sql_state, prc.m_msg);
+
+#else
+
+  // Built without zlib: compression is not offered to the server.
+
+  if (Protocol_options::COMPRESSION_REQUIRED == options.compression())
+    THROW("Compression is not supported by this build");
+
+#endif
+}
+
+
 Session::~Session()
 {
   //TODO: add timeout to close session!
@@ -394,6 +480,7 @@ void Session::check_protocol_fields()
     /* More fields checks will be added here */
     m_proto_fields |= field_checker.is_supported(Protocol_fields::ROW_LOCKING);
     m_proto_fields |= field_checker.is_supported(Protocol_fields::UPSERT);
+    m_proto_fields |= field_checker.is_supported(Protocol_fields::KEEP_OPEN);
   }
 }
 
@@ -409,10 +496,12 @@ option_t Session::check_valid()
 void Session::close()
 {
   m_reply_op_queue.clear();
+  m_pending_replies.clear();
 
   if (is_valid())
   {
     m_protocol.snd_Close().wait();
+    m_protocol.flush().wait();
     //    TODO: Uncomment this line when srever implements Close OK reply message
     //    m_protocol.rcv_Reply(*this).wait();
   }
@@ -420,28 +509,154 @@ void Session::close()
 
 }
 
+void Session::reset()
+{
+  if (!is_valid())
+    throw_error("reset: invalid session");
+
+  // Skip replies to commands that were discarded without processing them.
+
+  make_current(NULL);
+  assert(!m_current_reply);
+
+  m_reply_op_queue.clear();
+  clear_errors();
+
+  /*
+    If supported by the server, the session is reset without closing it,
+    so that it stays authenticated. The current schema is back to the
+    default one.
+  */
+
+  if (m_proto_fields & Protocol_fields::KEEP_OPEN)
+  {
+    m_protocol.snd_SessionReset(true).wait();
+    m_protocol.rcv_Reply(*this).wait();
+
+    if (0 == entry_count())
+    {
+      const string *db = m_options.database();
+      m_cur_schema = db ? *db : string();
+      return;
+    }
+
+    // Server rejected the request: fall back to reset with authentication.
+
+    clear_errors();
+  }
+
+  m_protocol.snd_SessionReset().wait();
+  m_protocol.rcv_Reply(*this).wait();
+
+  if (0 < entry_count())
+  {
+    m_isvalid = false;
+    get_error().rethrow();
+  }
+
+  // Server expects new authentication after session reset.
+
+  m_isvalid = false;
+  m_expired = false;
+  m_cur_schema = string();
+
+  authenticate(m_options, m_secure_conn);
+  wait();
+
+  if (0 < entry_count())
+    get_error().rethrow();
+}
+
+
+/*
+  Register reply to the command that was set by set_command(). The command
+  is sent to the server right away. If reply to an earlier command is still
+  being processed, the new reply is queued and becomes current only after
+  that earlier reply is done with (see make_current()).
+*/
+
 void Session::register_reply(Reply *reply)
 {
-  // Complete previous reply
+  reply->m_ok_reply = m_cmd_ok_reply;
+  send_cmd();
 
-  if (m_current_reply)
+  if (m_current_reply || !m_pending_replies.empty())
   {
-    m_current_reply->close_cursor();
-    m_current_reply->discard();
+    m_pending_replies.push_back({ reply, reply->m_ok_reply });
+    return;
   }
+
   m_current_reply = reply;
+  start_reading_result();
 }
 
 void Session::deregister_reply(Reply *reply)
 {
-  // TODO: Should reply be discared here?
+  if (reply != m_current_reply)
+  {
+    /*
+      Reply to a command that was not processed yet. Server reply will be
+      skipped when it is its turn.
+    */
+
+    for (Pending_reply &pending : m_pending_replies)
+      if (reply == pending.m_reply)
+        pending.m_reply = NULL;
+    return;
+  }
+
   m_current_reply = NULL;
 }
 
 
-Reply_init& Session::sql(const string &stmt, Any_list *args)
+void Session::make_current(Reply *reply)
+{
+  for (;;)
+  {
+    // Note: detach() de-registers current reply.
+
+    if (m_current_reply)
+    {
+      if (reply == m_current_reply)
+        return;
+      m_current_reply->close_cursor();
+      m_current_reply->detach();
+      continue;
+    }
+
+    if (m_pending_replies.empty())
+    {
+      assert(!reply);
+      return;
+    }
+
+    Pending_reply next = m_pending_replies.front();
+    m_pending_replies.pop_front();
+    m_current_reply = next.m_reply;
+    start_reading_result();
+
+    if (m_current_reply)
+      continue;
+
+    /*
+      Skip reply that was discarded before. Any errors reported by server
+      are ignored.
+    */
+
+    Reply skip;
+    skip.m_session = this;
+    skip.m_ok_reply = next.m_ok_reply;
+    m_current_reply = &skip;
+    skip.detach();
+  }
+}
+
+
+Reply_init& Session::sql(const string &stmt, Any_list *args, uint32_t stmt_id)
 {
-  return set_command(new SndStmt(m_protocol, "sql", stmt, args));
+  return set_command(
+    new SndStmt(m_protocol, "sql", stmt, args, stmt_id), 0 != stmt_id
+  );
 }
 
 void Session::Doc_args::process(Processor &prc) const
@@ -524,10 +739,11 @@ void Session::savepoint_remove(const string &savepoint)
 Reply_init& Session::coll_add(const Table_ref &coll,
                               Doc_source &docs,
                               const Param_source *param,
-                              bool upsert)
+                              bool upsert,
+                              size_t max_size)
 {
   return set_command(
-    new SndInsertDocs(m_protocol, coll, docs, param, upsert)
+    new SndInsertDocs(m_protocol, coll, docs, param, upsert, max_size)
   );
 }
 
@@ -535,12 +751,14 @@ Reply_init& Session::coll_remove(const Table_ref &coll,
                                  const Expression *expr,
                                  const Order_by *order_by,
                                  const Limit *lim,
-                                 const Param_source *param)
+                                 const Param_source *param,
+                                 uint32_t stmt_id)
 {
   return set_command(
     new SndDelete<protocol::mysqlx::DOCUMENT>(
-          m_protocol, coll, expr,order_by, lim, param
+          m_protocol, coll, expr,order_by, lim, param, stmt_id
         )
+    , 0 != stmt_id
   );
 }
 
@@ -553,7 +771,8 @@ Reply_init& Session::coll_find(const Table_ref &coll,
                                const Expression *having,
                                const Limit *lim,
                                const Param_source *param,
-                               const Lock_mode_value lock_mode)
+                               const Lock_mode_value lock_mode,
+                               uint32_t stmt_id)
 {
   if (lock_mode != Lock_mode_value::NONE &&
       !(m_proto_fields & Protocol_fields::ROW_LOCKING))
@@ -562,13 +781,13 @@ Reply_init& Session::coll_find(const Table_ref &coll,
   SndFind<protocol::mysqlx::DOCUMENT> *find
     = new SndFind<protocol::mysqlx::DOCUMENT>(
             m_protocol, coll, expr, proj, order_by,
-            group_by, having, lim, param, lock_mode
+            group_by, having, lim, param, lock_mode, stmt_id
           );
 
   if (view)
     return set_command(new SndViewCrud<protocol::mysqlx::DOCUMENT>(*view, find));
 
-  return set_command(find);
+  return set_command(find, 0 != stmt_id);
 }
 
 Reply_init& Session::coll_update(const api::Table_ref &coll,
@@ -576,20 +795,23 @@ Reply_init& Session::coll_update(const api::Table_ref &coll,
                                  const Update_spec &us,
                                  const Order_by *order_by,
                                  const Limit *lim,
-                                 const Param_source *param)
+                                 const Param_source *param,
+                                 uint32_t stmt_id)
 {
   return set_command(
     new SndUpdate<protocol::mysqlx::DOCUMENT>(
-          m_protocol, coll, expr, us, order_by, lim, param
+          m_protocol, coll, expr, us, order_by, lim, param, stmt_id
         )
+    , 0 != stmt_id
   );
 }
 
 Reply_init& Session::table_insert(const Table_ref &coll, Row_source &rows,
-                                  const api::Columns *cols, const Param_source *param)
+                                  const api::Columns *cols, const Param_source *param,
+                                  size_t max_size)
 {
   return set_command(
-    new SndInsertRows(m_protocol, coll, rows, cols, param)
+    new SndInsertRows(m_protocol, coll, rows, cols, param, max_size)
   );
 }
 
@@ -597,12 +819,14 @@ Reply_init& Session::table_delete(const Table_ref &coll,
                                   const Expression *expr,
                                   const Order_by *order_by,
                                   const Limit *lim,
-                                  const Param_source *param)
+                                  const Param_source *param,
+                                  uint32_t stmt_id)
 {
   return set_command(
     new SndDelete<protocol::mysqlx::TABLE>(
-          m_protocol, coll, expr, order_by, lim, param
+          m_protocol, coll, expr, order_by, lim, param, stmt_id
         )
+    , 0 != stmt_id
   );
 }
 
@@ -615,7 +839,8 @@ Reply_init& Session::table_select(const Table_ref &coll,
                                   const Expression *having,
                                   const Limit *lim,
                                   const Param_source *param,
-                                  const Lock_mode_value lock_mode)
+                                  const Lock_mode_value lock_mode,
+                                  uint32_t stmt_id)
 {
   if (lock_mode != Lock_mode_value::NONE &&
       !(m_proto_fields & Protocol_fields::ROW_LOCKING))
@@ -624,13 +849,13 @@ Reply_init& Session::table_select(const Table_ref &coll,
   SndFind<protocol::mysqlx::TABLE> *find
     = new SndFind<protocol::mysqlx::TABLE>(
             m_protocol, coll, expr, proj, order_by,
-            group_by, having, lim, param, lock_mode
+            group_by, having, lim, param, lock_mode, stmt_id
           );
 
   if (view)
     return set_command(new SndViewCrud<protocol::mysqlx::TABLE>(*view, find));
 
-  return set_command(find);
+  return set_command(find, 0 != stmt_id);
 }
 
 Reply_init& Session::table_update(const api::Table_ref &coll,
@@ -638,12 +863,14 @@ Reply_init& Session::table_update(const api::Table_ref &coll,
                                   const Update_spec &us,
                                   const Order_by *order_by,
                                   const Limit *lim,
-                                  const Param_source *param)
+                                  const Param_source *param,
+                                  uint32_t stmt_id)
 {
   return set_command(
     new SndUpdate<protocol::mysqlx::TABLE>(
-          m_protocol, coll, expr, us, order_by, lim, param
+          m_protocol, coll, expr, us, order_by, lim, param, stmt_id
         )
+    , 0 != stmt_id
   );
 }
 
@@ -657,12 +884,32 @@ Reply_init& Session::view_drop(const api::Table_ref &view, bool check_existence)
 
 
 
-Reply_init &Session::set_command(Proto_op *cmd)
+Reply_init& Session::prepared_execute(uint32_t stmt_id,
+                                      const Param_source *param)
+{
+  return set_command(new SndPrepareExecute(m_protocol, stmt_id, param));
+}
+
+
+Reply_init& Session::prepared_execute(uint32_t stmt_id, Any_list *args)
+{
+  return set_command(new SndPrepareExecute(m_protocol, stmt_id, args));
+}
+
+
+Reply_init& Session::prepared_deallocate(uint32_t stmt_id)
+{
+  return set_command(new SndPrepareDeallocate(m_protocol, stmt_id), true);
+}
+
+
+Reply_init &Session::set_command(Proto_op *cmd, bool ok_reply)
 {
   if (!is_valid())
     throw_error("set_command: invalid session");
 
   m_cmd.reset(cmd);
+  m_cmd_ok_reply = ok_reply;
 
   return *this;
 }
@@ -764,7 +1011,19 @@ void Session::add_diagnostics(Severity::value level, unsigned code,
 
 
 void Session::ok(string)
-{}
+{
+  /*
+    Ok is the complete reply to a prepare or deallocate command: there are
+    no results and the command was executed. For other commands Ok does
+    not change the state of the reply.
+  */
+
+  if (!m_current_reply || !m_current_reply->m_ok_reply)
+    return;
+
+  m_has_results = false;
+  m_executed = true;
+}
 
 
 void Session::col_count(col_count_t nr_cols)
@@ -923,10 +1182,12 @@ void Session::row_stats(row_stats_t stats, row_count_t val)
 
 void Session::send_cmd()
 {
-  m_executed = false;
-  m_reply_op_queue.push_back(m_cmd);
-  m_cmd.reset();
-  m_stmt_stats.clear();
+  if (!m_cmd)
+    throw_error("send_cmd: no command to send");
+
+  shared_ptr<Proto_op> cmd;
+  cmd.swap(m_cmd);
+  cmd->wait();
 }
 
 
@@ -934,6 +1195,7 @@ void Session::start_reading_result()
 {
   m_col_metadata.reset(new Mdata_storage());
   m_executed = false;
+  m_stmt_stats.clear();
   m_reply_op_queue.push_back(
     shared_ptr<Proto_op>(new RcvMetaData(m_protocol, *this))
   );
@@ -1591,18 +1591,23 @@ Expression* Expr_parser_base::parse_ilri(Processor *prc)
     return NULL;
   }
 
+  /*
+    We have an ilri expression with operator and 2 arguments.
+
+    Note: operator type is determined before consuming more tokens, which
+    would invalidate t.
+  */
+
+  Op::Type op = Op::get_binary(*t);
+
   // Handle IS NOT case.
 
-  if (neg && Op::IS == *t)
+  if (neg && Op::IS == op)
     parse_error(L"Operator NOT before IS, should be IS NOT");
 
-  if (Op::IS == *t && consume_token(Op::NOT))
+  if (Op::IS == op && consume_token(Op::NOT))
     neg = true;
 
-  // We have an ilri expression with operator and 2 arguments.
-
-  Op::Type op = Op::get_binary(*t);
-
   // Detect unsupported operators before handling parmaeters
 
   switch (op)
@@ -33,6 +33,8 @@
 
 PUSH_SYS_WARNINGS
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 POP_SYS_WARNINGS
 
 
@@ -190,3 +192,225 @@ bool JSON_scalar_parser::do_parse(Processor *vp)
 }
 
 
+
+
+/*
+  Scanning JSON documents (see json_parser.h).
+*/
+
+// Skip white space, return false if at the end of the string.
+
+bool JSON_doc_scanner::skip_ws()
+{
+  while (m_pos < m_end)
+  {
+    switch (*m_pos)
+    {
+    case ' ': case '\t': case '\n': case '\r':
+      ++m_pos;
+      continue;
+    default:
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool JSON_doc_scanner::consume(char c)
+{
+  if (!skip_ws() || c != *m_pos)
+    return false;
+  ++m_pos;
+  return true;
+}
+
+
+/*
+  Read double-quoted string and set [beg, end) to its contents. Flag
+  `plain` is cleared if the string contains escape sequences.
+*/
+
+bool JSON_doc_scanner::string(const byte *&beg, const byte *&end, bool &plain)
+{
+  if (!consume('"'))
+    return false;
+
+  plain = true;
+  beg = m_pos;
+
+  for (; m_pos < m_end; ++m_pos)
+  {
+    switch (*m_pos)
+    {
+    case '\\':
+      plain = false;
+      if (++m_pos == m_end)
+        return false;
+      continue;
+
+    case '"':
+      end = m_pos++;
+      return true;
+
+    default:
+      continue;
+    }
+  }
+
+  return false;
+}
+
+
+/*
+  Skip a field value, stopping at ',' or '}' which ends it. Only brackets
+  and strings inside the value are looked at. Sets [m_val_begin, m_val_end)
+  to the value.
+*/
+
+bool JSON_doc_scanner::skip_value()
+{
+  unsigned depth = 0;
+  const byte *beg, *end;
+  bool plain;
+
+  if (!skip_ws())
+    return false;
+
+  m_val_begin = m_pos;
+
+  while (skip_ws())
+  {
+    switch (*m_pos)
+    {
+    case '"':
+      if (!string(beg, end, plain))
+        return false;
+      m_val_end = m_pos;
+      continue;
+
+    case '\'':
+      // Non-standard quotes are left to the full parser.
+      return false;
+
+    case '{': case '[':
+      ++depth;
+      break;
+
+    case '}': case ']':
+      if (0 == depth)
+        return m_val_begin < m_pos;
+      --depth;
+      break;
+
+    case ',':
+      if (0 == depth)
+        return m_val_begin < m_pos;
+      break;
+
+    default:
+      break;
+    }
+
+    m_val_end = ++m_pos;
+  }
+
+  return false;
+}
+
+
+bool JSON_doc_scanner::next()
+{
+  switch (m_state)
+  {
+  case START:
+
+    if (!consume('{'))
+      return fail();
+
+    if (consume('}'))
+    {
+      m_state = DONE;
+      break;
+    }
+
+    m_state = FIELDS;
+    break;
+
+  case FIELDS:
+
+    if (consume(','))
+      break;
+
+    if (!consume('}'))
+      return fail();
+
+    m_state = DONE;
+    break;
+
+  case DONE:
+  case FAILED:
+    return false;
+  }
+
+  if (DONE == m_state)
+  {
+    // Nothing is expected after the document.
+
+    if (skip_ws())
+      return fail();
+    return false;
+  }
+
+  if (!string(m_key_begin, m_key_end, m_plain_key))
+    return fail();
+
+  if (!consume(':'))
+    return fail();
+
+  if (!skip_value())
+    return fail();
+
+  return true;
+}
+
+
+Doc_id_scan parser::scan_doc_id(cdk::bytes json, std::string &id)
+{
+  JSON_doc_scanner scanner(json);
+  Doc_id_scan ret = SCAN_NO_ID;
+
+  while (scanner.next())
+  {
+    cdk::bytes key = scanner.key();
+
+    if (3 != key.size() || 0 != memcmp(key.begin(), "_id", 3))
+    {
+      if (scanner.plain_key())
+        continue;
+      return SCAN_UNKNOWN;
+    }
+
+    // Non-string ids are reported by the full parser.
+
+    cdk::bytes val = scanner.value();
+
+    if (val.size() < 2 || '"' != val.begin()[0] || '"' != val.end()[-1])
+      return SCAN_UNKNOWN;
+
+    const char *beg = (const char*)val.begin() + 1;
+    const char *end = (const char*)val.end() - 1;
+
+    if (end != std::find_if(beg, end,
+                            [](char c) { return '"' == c || '\\' == c; }))
+      return SCAN_UNKNOWN;
+
+    id.assign(beg, end);
+    ret = SCAN_ID;
+  }
+
+  if (scanner.failed())
+    return SCAN_UNKNOWN;
+
+  return ret;
+}
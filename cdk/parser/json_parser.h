@@ -126,6 +126,115 @@ public:
 
 };
 
+
+/*
+  Scanner which splits a JSON document, given as UTF8 string, into top-level
+  key-value pairs without parsing it.
+
+  The scan works directly on the bytes of the string. Values are not decoded:
+  for each pair the scanner gives the raw bytes of the key (without quotes)
+  and of the value, which can be parsed separately if needed. Nested values
+  are skipped by counting brackets. Scanning can be stopped and resumed later
+  with the next call to next().
+
+  Only plain JSON with double-quoted strings is handled. If the scanner finds
+  something else, or a syntax error, next() returns false and failed() is
+  true. Then the document must be processed with the full JSON_parser, which
+  also reports errors.
+
+  Note: The scanner does not fully validate the document.
+*/
+
+class JSON_doc_scanner
+{
+public:
+
+  typedef cdk::byte byte;
+
+  JSON_doc_scanner(cdk::bytes json)
+    : m_pos(json.begin()), m_end(json.end())
+  {}
+
+  /*
+    Move to the next key-value pair. Returns false if there are no more
+    pairs or if the scan failed.
+  */
+
+  bool next();
+
+  bool failed() const
+  {
+    return FAILED == m_state;
+  }
+
+  // Bytes of the key, without quotes. Escape sequences are not decoded.
+
+  cdk::bytes key() const
+  {
+    return cdk::bytes(const_cast<byte*>(m_key_begin),
+                      const_cast<byte*>(m_key_end));
+  }
+
+  // True if the key does not contain escape sequences.
+
+  bool plain_key() const
+  {
+    return m_plain_key;
+  }
+
+  // Bytes of the value, without surrounding white space.
+
+  cdk::bytes value() const
+  {
+    return cdk::bytes(const_cast<byte*>(m_val_begin),
+                      const_cast<byte*>(m_val_end));
+  }
+
+private:
+
+  enum { START, FIELDS, DONE, FAILED } m_state = START;
+
+  const byte *m_pos;
+  const byte *m_end;
+
+  const byte *m_key_begin = nullptr;
+  const byte *m_key_end = nullptr;
+  const byte *m_val_begin = nullptr;
+  const byte *m_val_end = nullptr;
+  bool  m_plain_key = true;
+
+  bool skip_ws();
+  bool consume(char);
+  bool string(const byte*&, const byte*&, bool&);
+  bool skip_value();
+
+  bool fail()
+  {
+    m_state = FAILED;
+    return false;
+  }
+};
+
+
+/*
+  Quick scan of a JSON document, given as UTF8 string, which looks for
+  a top-level "_id" field with a string value (using JSON_doc_scanner). If
+  found, the value is stored in `id` (in case of duplicate keys, the last one
+  is taken).
+
+  Only an "_id" key and value without escape sequences are handled. In all
+  other cases, and if JSON_doc_scanner fails, it returns SCAN_UNKNOWN.
+*/
+
+enum Doc_id_scan
+{
+  SCAN_NO_ID,
+  SCAN_ID,
+  SCAN_UNKNOWN
+};
+
+Doc_id_scan scan_doc_id(cdk::bytes json, std::string &id);
+
 }  // parser
 
 #endif
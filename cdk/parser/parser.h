@@ -73,6 +73,11 @@ protected:
   It  *m_first;
   It  m_last;
 
+  /*
+    Note: The returned token is valid only until the next token is consumed
+    (see Tokenizer::iterator).
+  */
+
   const Token* consume_token()
   {
     const Token *t = peek_token();
@@ -215,6 +215,63 @@ try { \
 } \
 
 
+TEST(Parser, tokenizer)
+{
+  struct
+  {
+    Token::Type type;
+    const wchar_t *text;
+  }
+  expected[] =
+  {
+    { Token::WORD, L"foo" },
+    { Token::DOT, L"." },
+    { Token::QWORD, L"b`ar" },
+    { Token::ARROW2, L"->>" },
+    { Token::QSTRING, L"it's" },
+    { Token::QQSTRING, L"a\"b\\c" },
+    { Token::HEX, L"1F" },
+    { Token::HEX, L"ab" },
+    { Token::NUMBER, L"1.5e3" },
+    { Token::INTEGER, L"42" },
+    { Token::LPAREN, L"(" },
+  };
+
+  Tokenizer toks(L"foo.`b``ar` ->> 'it''s' \"a\\\"b\\\\c\" 0x1F X'ab'"
+                 L" 1.5e3 42(");
+
+  EXPECT_FALSE(toks.empty());
+
+  Tokenizer::iterator it = toks.begin();
+
+  for (auto &exp : expected)
+  {
+    ASSERT_NE(toks.end(), it);
+    cout << it->get_name() << ": " << it->get_text() << endl;
+    EXPECT_EQ(exp.type, it->get_type());
+    EXPECT_EQ(cdk::string(exp.text), it->get_text());
+
+    // Previous token must stay valid after moving forward.
+
+    const Token &prev = *it;
+    ++it;
+    EXPECT_EQ(exp.type, prev.get_type());
+    EXPECT_EQ(cdk::string(exp.text), prev.get_text());
+  }
+
+  EXPECT_EQ(toks.end(), it);
+
+  EXPECT_TRUE(Tokenizer(L"  ").empty());
+
+  // Errors are reported when iterator reaches the offending characters.
+
+  Tokenizer bad(L"foo 'bar");
+  it = bad.begin();
+  EXPECT_EQ(cdk::string(L"foo"), it->get_text());
+  EXPECT_ERROR(++it);
+}
+
+
 TEST(Parser, json)
 {
   JSON_printer printer(cout, 0);
@@ -319,6 +376,97 @@ TEST(Parser, json)
 }
 
 
+TEST(Parser, doc_id_scan)
+{
+  struct scan_doc_t
+  {
+    const char  *doc;
+    Doc_id_scan  res;
+    const char  *id;
+  }
+  scan_docs[] = {
+    { "{}", SCAN_NO_ID, "" },
+    { " { \"_id\" : \"abc\" } ", SCAN_ID, "abc" },
+    { "{\"a\": 1, \"_id\": \"abc\", \"b\": [1, {\"_id\": 2}]}",
+      SCAN_ID, "abc" },
+    { "{\"a\": {\"_id\": \"nested\"}, \"b\": \"}\\\"]\"}", SCAN_NO_ID, "" },
+    { "{\"_ida\": \"x\", \"_i\": \"y\", \"id\": \"z\"}", SCAN_NO_ID, "" },
+    { "{\"_id\": \"first\", \"_id\": \"last\"}", SCAN_ID, "last" },
+    { "{\"name\": \"\xc5\xbc\xc3\xb3\xc5\x82w\", \"_id\": \"\xc5\xbc\"}",
+      SCAN_ID, "\xc5\xbc" },
+    // cases left to the full parser
+    { "{\"_id\": 123}", SCAN_UNKNOWN, NULL },
+    { "{\"_id\": null}", SCAN_UNKNOWN, NULL },
+    { "{\"_id\": \"a\\\"b\"}", SCAN_UNKNOWN, NULL },
+    { "{\"\\u005fid\": \"x\"}", SCAN_UNKNOWN, NULL },
+    { "{'_id': 'x'}", SCAN_UNKNOWN, NULL },
+    { "{\"a\": 'x'}", SCAN_UNKNOWN, NULL },
+    { "{\"a\": 1", SCAN_UNKNOWN, NULL },
+    { "{\"a\" 1}", SCAN_UNKNOWN, NULL },
+    { "{\"a\": \"x}", SCAN_UNKNOWN, NULL },
+    { "{} {}", SCAN_UNKNOWN, NULL },
+    { "[1, 2]", SCAN_UNKNOWN, NULL },
+    { "", SCAN_UNKNOWN, NULL },
+  };
+
+  for (unsigned i = 0; i < sizeof(scan_docs) / sizeof(scan_doc_t); ++i)
+  {
+    cout << "== doc#" << i << ": " << scan_docs[i].doc << endl;
+
+    std::string json(scan_docs[i].doc);
+    std::string id;
+    Doc_id_scan res = scan_doc_id(cdk::bytes(json), id);
+
+    EXPECT_EQ(scan_docs[i].res, res);
+    if (SCAN_ID == scan_docs[i].res)
+      EXPECT_EQ(std::string(scan_docs[i].id), id);
+  }
+}
+
+
+TEST(Parser, doc_scanner)
+{
+  std::string json =
+    " { \"a\" : 1 , \"b\":{\"c\": [1, \"]\"]},"
+    "\"d\\\"\": \"x,y\" ,\"e\": [ {}, [] ] } ";
+
+  const char *keys[] = { "a", "b", "d\\\"", "e" };
+  const char *vals[] = { "1", "{\"c\": [1, \"]\"]}", "\"x,y\"", "[ {}, [] ]" };
+
+  parser::JSON_doc_scanner scanner{ cdk::bytes(json) };
+  unsigned pos = 0;
+
+  while (scanner.next())
+  {
+    cdk::bytes key = scanner.key();
+    cdk::bytes val = scanner.value();
+    std::string key_str(key.begin(), key.end());
+    std::string val_str(val.begin(), val.end());
+
+    cout << key_str << ": " << val_str << endl;
+
+    ASSERT_LT(pos, 4U);
+    EXPECT_EQ(std::string(keys[pos]), key_str);
+    EXPECT_EQ(std::string(vals[pos]), val_str);
+    EXPECT_EQ(2 != pos, scanner.plain_key());
+    pos++;
+  }
+
+  EXPECT_FALSE(scanner.failed());
+  EXPECT_EQ(4U, pos);
+  EXPECT_FALSE(scanner.next());
+
+  // Scanning stops at a problem, after returning correct pairs.
+
+  json = "{\"a\": 1, \"b\": 'x'}";
+  parser::JSON_doc_scanner scanner1{ cdk::bytes(json) };
+
+  EXPECT_TRUE(scanner1.next());
+  EXPECT_FALSE(scanner1.next());
+  EXPECT_TRUE(scanner1.failed());
+}
+
+
 
 class Expr_printer
   : public cdk::Expression::Processor
@@ -53,12 +53,66 @@ namespace {
 }
 
 
-bool Tokenizer::cur_char_is_space() const
+/*
+  Extract characters of a token from the input string.
+
+  For quotted strings and words the quotes are removed and escape sequences
+  (a backslash followed by a character, or a doubled quote character) are
+  replaced by the escaped characters. For hex literals only the hex digits
+  are returned.
+*/
+
+string Token::get_text() const
+{
+  if (!_input)
+    return string();
+
+  const string &inp = *_input;
+  size_t begin = _pos_begin;
+  size_t end = _pos_end;
+
+  switch (_type)
+  {
+  case QWORD:
+  case QSTRING:
+  case QQSTRING:
+  {
+    char_t qchar = inp[begin];
+    string val;
+
+    val.reserve(end - begin - 2);
+
+    for (size_t pos = begin + 1; pos < end - 1; ++pos)
+    {
+      if (L'\\' == inp[pos] || qchar == inp[pos])
+        ++pos;
+      val.push_back(inp[pos]);
+    }
+
+    return val;
+  }
+
+  case HEX:
+    // Skip "0x" or "X'" prefix and the closing quote, if present.
+    begin += 2;
+    if (L'\'' == inp[end - 1])
+      --end;
+    break;
+
+  default:
+    break;
+  }
+
+  return inp.substr(begin, end - begin);
+}
+
+
+bool Tokenizer::iterator::cur_char_is_space() const
 {
   return ctf.is(ctf.space, cur_char());
 }
 
-bool Tokenizer::cur_char_is_word() const
+bool Tokenizer::iterator::cur_char_is_word() const
 {
   if (cur_char_is(L'_'))
     return true;
@@ -66,58 +120,54 @@ bool Tokenizer::cur_char_is_word() const
 }
 
 
-void Tokenizer::get_tokens()
+void Tokenizer::iterator::next_token()
 {
-  while (chars_available())
-  {
-    if (0 == cur_char())
-      return;
-
-    while (chars_available() && cur_char_is_space())
-      consume_char();
+  while (chars_available() && cur_char_is_space())
+    consume_char();
 
-    if (!chars_available())
-      return;
+  if (!chars_available() || 0 == cur_char())
+  {
+    _at_end = true;
+    return;
+  }
 
-    if (parse_string())
-      continue;
+  if (parse_string())
+    return;
 
-    if (parse_hex())
-      continue;
+  if (parse_hex())
+    return;
 
-    if (parse_number())
-      continue;
+  if (parse_number())
+    return;
 
-    // check symbol tokens
+  // check symbol tokens
 
-    set_token_start();
+  set_token_start();
 
 #define  symbol_check(T,X) \
-    if (consume_chars(L##X)) \
-    { \
-      add_token(Token::T, L##X); \
-      continue; \
-    } \
+  if (consume_chars(L##X)) \
+  { \
+    add_token(Token::T); \
+    return; \
+  } \
 
-    SYMBOL_LIST2(symbol_check)
+  SYMBOL_LIST2(symbol_check)
 
 #define  symbol_check1(T,X) \
-    if (c == (L##X)[0]) { consume_char(); add_token(Token::T,L##X); continue; }
-
-    char_t c = cur_char();
-    SYMBOL_LIST1(symbol_check1)
+  if (c == (L##X)[0]) { consume_char(); add_token(Token::T); return; }
 
-    /*
-      Note: it is important to parse word last as some words can qualify as
-      other tokens.
-    */
+  char_t c = cur_char();
+  SYMBOL_LIST1(symbol_check1)
 
-    if (parse_word())
-      continue;
+  /*
+    Note: it is important to parse word last as some words can qualify as
+    other tokens.
+  */
 
-    token_error(L"Could not recognize next token");
+  if (parse_word())
+    return;
 
-  } // while
+  token_error(L"Could not recognize next token");
 }
 
 
@@ -146,24 +196,20 @@ void Tokenizer::get_tokens()
     FLOAT ::= DIGIT* '.' DIGIT+ ('E' ('+'|'-')? DIGIT+)? | DIGIT+ 'E' ('+'|'-')? DIGIT+
 */
 
-bool Tokenizer::parse_digits(string *out)
+bool Tokenizer::iterator::parse_digits()
 {
   bool has_digits = false;
 
   while (chars_available() && cur_char_in(L"0123456789"))
   {
     has_digits = true;
-
-    if (out)
-      out->push_back(consume_char());
-    else
-      consume_char();
+    consume_char();
   }
 
   return has_digits;
 }
 
-bool Tokenizer::parse_number()
+bool Tokenizer::iterator::parse_number()
 {
   bool is_float = false;
   bool exponent = false;
@@ -240,13 +286,13 @@ bool Tokenizer::parse_number()
 */
 
 
-bool Tokenizer::parse_hex()
+bool Tokenizer::iterator::parse_hex()
 {
-  string val;
-
   if (!chars_available())
     return false;
 
+  set_token_start();
+
   switch (cur_char())
   {
 
@@ -258,7 +304,7 @@ bool Tokenizer::parse_hex()
     consume_char();
     consume_char();
 
-    if (!parse_hex_digits(val))
+    if (!parse_hex_digits())
       token_error(L"Unexpected character inside hex literal");
 
     if (!consume_char(L'\''))
@@ -275,7 +321,7 @@ bool Tokenizer::parse_hex()
     consume_char();
     consume_char();
 
-    if (!parse_hex_digits(val))
+    if (!parse_hex_digits())
       token_error(L"No hex digits found after 0x");
 
     break;
@@ -285,15 +331,15 @@ bool Tokenizer::parse_hex()
     return false;
   }
 
-  add_token(Token::HEX, val);
+  add_token(Token::HEX);
   return true;
 }
 
-bool Tokenizer::parse_hex_digits(string &digits)
+bool Tokenizer::iterator::parse_hex_digits()
 {
   bool ret = cur_char_in(L"0123456789ABCDEFabcdef");
   while (cur_char_in(L"0123456789ABCDEFabcdef"))
-    digits.push_back(consume_char());
+    consume_char();
   return ret;
 }
 
@@ -305,7 +351,7 @@ bool Tokenizer::parse_hex_digits(string &digits)
   QWORD - word quotted in back-ticks
 */
 
-bool Tokenizer::parse_word()
+bool Tokenizer::iterator::parse_word()
 {
   if (!chars_available())
     return false;
@@ -314,9 +360,8 @@ bool Tokenizer::parse_word()
 
   if (cur_char_is(L'`'))
   {
-    string word;
-    parse_quotted_string(L'`', &word);
-    add_token(Token::QWORD, word);
+    parse_quotted_string(L'`');
+    add_token(Token::QWORD);
     return true;
   }
 
@@ -343,24 +388,23 @@ bool Tokenizer::parse_word()
   QQSTRING - a string in double quotes
 */
 
-bool Tokenizer::parse_string()
+bool Tokenizer::iterator::parse_string()
 {
   set_token_start();
-  string val;
   char_t quote = cur_char();
 
   if (!(L'\"' == quote || L'\'' == quote))
     return false;
 
-  if (!parse_quotted_string(quote, &val))
+  if (!parse_quotted_string(quote))
     return false;
 
-  add_token(L'\"' == quote ? Token::QQSTRING : Token::QSTRING, val);
+  add_token(L'\"' == quote ? Token::QQSTRING : Token::QSTRING);
   return true;
 }
 
 
-bool Tokenizer::parse_quotted_string(char_t qchar, string *val)
+bool Tokenizer::iterator::parse_quotted_string(char_t qchar)
 {
   if (!consume_char(qchar))
     return false;
@@ -384,9 +428,6 @@ bool Tokenizer::parse_quotted_string(char_t qchar, string *val)
 
     char_t c = consume_char();
 
-    if (val)
-      val->push_back(c);
-
     if (pos < start_len)
       start[pos++] = c;
   }
@@ -404,72 +445,75 @@ bool Tokenizer::parse_quotted_string(char_t qchar, string *val)
 }
 
 
-// Constructing token sequence
+// Constructing tokens
 
 
-size_t Tokenizer::set_token_start()
+size_t Tokenizer::iterator::set_token_start()
 {
   _tok_pos = _in_pos;
   return _tok_pos;
 }
 
-void Tokenizer::add_token(Token::Type tt)
+void Tokenizer::iterator::add_token(Token::Type tt)
 {
   assert(_in_pos > _tok_pos);
-  add_token(tt, _input.substr(_tok_pos, _in_pos - _tok_pos));
-  _tok_pos = _in_pos;
-}
 
-void Tokenizer::add_token(Token::Type tt, const string &val)
-{
-  _tokens.emplace_back(tt, val, _tok_pos, _in_pos);
+  /*
+    Note: the previous token is kept in the other slot so that references
+    to it stay valid (see description of Tokenizer::iterator).
+  */
+
+  _cur = 1 - _cur;
+  _tok[_cur] = Token(tt, get_input(), _tok_pos, _in_pos);
+  _at_end = false;
 }
 
 
 // Access underlying sequence of characters
 
 
-bool Tokenizer::chars_available() const
+bool Tokenizer::iterator::chars_available() const
 {
-  return _in_pos < _input.size();
+  return _in_pos < get_input().size();
 }
 
-char_t   Tokenizer::cur_char() const
+char_t   Tokenizer::iterator::cur_char() const
 {
   if (!chars_available())
     token_error(L"More characters expected");
-  return _input.at(_in_pos);
+  return get_input().at(_in_pos);
 }
 
-size_t Tokenizer::get_char_pos() const
+size_t Tokenizer::iterator::get_char_pos() const
 {
   return _in_pos;
 }
 
 
-bool Tokenizer::next_char_is(char_t c, size_t off) const
+bool Tokenizer::iterator::next_char_is(char_t c, size_t off) const
 {
-  return _in_pos + off < _input.size() && _input[_in_pos + off] == c;
+  return _in_pos + off < get_input().size()
+         && get_input()[_in_pos + off] == c;
 }
 
-bool Tokenizer::next_char_in(const char_t *set, size_t off) const
+bool Tokenizer::iterator::next_char_in(const char_t *set, size_t off) const
 {
-  if (_in_pos + off >= _input.size())
+  if (_in_pos + off >= get_input().size())
     return false;
-  char_t c = _input[_in_pos + off];
+  char_t c = get_input()[_in_pos + off];
 
   return (0 != c) && (NULL != std::wcschr(set, c));
 }
 
 
-char_t Tokenizer::consume_char()
+char_t Tokenizer::iterator::consume_char()
 {
   char_t c = cur_char();
   _in_pos++;
   return c;
 }
 
-bool Tokenizer::consume_char(char_t c)
+bool Tokenizer::iterator::consume_char(char_t c)
 {
   if (!cur_char_is(c))
     return false;
@@ -477,17 +521,18 @@ bool Tokenizer::consume_char(char_t c)
   return true;
 }
 
-char_t Tokenizer::consume_char(const char_t *set)
+char_t Tokenizer::iterator::consume_char(const char_t *set)
 {
   if (!cur_char_in(set))
     return '\0';
   return consume_char();
 }
 
-bool Tokenizer::consume_chars(const char_t *str)
+bool Tokenizer::iterator::consume_chars(const char_t *str)
 {
-  if (_in_pos != _input.find(str, _in_pos))
+  size_t len = wcslen(str);
+  if (0 != get_input().compare(_in_pos, len, str))
     return false;
-  _in_pos += wcslen(str);
+  _in_pos += len;
   return true;
 }
@@ -253,13 +253,15 @@ namespace parser {
   /*
     Class representing a single token.
 
-    It stores token type, characters which make the token and its position
-    within the parsed string (begin and end position).
+    It stores token type and its position within the parsed string (begin
+    and end position). Characters of the token are not copied: the token
+    refers to the input string, which must stay valid as long as the token
+    is used, and get_text() extracts the characters only when asked for.
 
     Note: For tokens such as quotted string, the characters of the token do
-    not include the quotes. For that reason characters of the token are not
-    always identical with the sub-range [_pos_begin, _pos_end) of the input
-    string.
+    not include the quotes and escape sequences are replaced by the escaped
+    characters. For that reason characters of the token are not always
+    identical with the sub-range [_pos_begin, _pos_end) of the input string.
   */
 
   class Token
@@ -275,18 +277,20 @@ namespace parser {
 
     typedef std::set<Type>  Set;
 
+    Token()
+      : _type(WORD), _input(NULL)
+      , _pos_begin(0), _pos_end(0)
+    {}
+
     Token(
-      Type type, const string& text,
+      Type type, const string& input,
       size_t begin, size_t end
     )
-      : _type(type), _text(text)
+      : _type(type), _input(&input)
       , _pos_begin(begin), _pos_end(end)
     {}
 
-    const string& get_text() const
-    {
-      return _text;
-    }
+    string get_text() const;
 
     Type get_type() const
     {
@@ -322,7 +326,7 @@ namespace parser {
   private:
 
     Type _type;
-    string _text;
+    const string *_input;
     size_t    _pos_begin;
     size_t    _pos_end;
 
@@ -351,11 +355,11 @@ namespace parser {
     Tokenizer::iterator returned by method begin() to iterate through the
     sequence of tokens.
 
-    Any errors in converting a string into a token sequence are thrown upon
-    construction of a tokenizer.
-
-    TODO: Avoid storing all tokens in memory.
-    Idea: have it working on istream instead.
+    Tokens are not stored anywhere: the iterator recognizes the next token
+    when it is moved forward, so that parsing a string needs only constant
+    extra memory. For the same reason, errors in converting a string into
+    a token sequence are thrown when the iterator reaches the offending
+    characters.
   */
 
   class Tokenizer
@@ -367,41 +371,130 @@ namespace parser {
 
     Tokenizer(const string& input)
       : _input(input)
-      , _in_pos(0)
-      , _tok_pos(0)
-      //, _pos(0)
+    {}
+
+    bool empty() const;
+
+    iterator begin() const;
+    iterator end() const;
+
+  protected:
+
+    // Storage for the input string
+
+    string _input;
+
+    friend iterator;
+    friend Error;
+  };
+
+
+  /*
+    Iterator for accessing a sequence of tokens of a tokenizer.
+
+    The iterator keeps its position within the input string and the current
+    token which starts at that position. When moved forward, it parses
+    characters of the next token.
+
+    Note: Pointer or reference to the current token stays valid after moving
+    the iterator forward by one token, but not further. This is so that
+    a parser can consume a token and still look at it (see
+    Token_base::consume_token()).
+  */
+
+  class Tokenizer::iterator
+  {
+    const Tokenizer *_toks;
+    size_t _in_pos;   // current position in the input string
+    size_t _tok_pos;  // start position of a token in the input string
+
+    /*
+      Storage for the current and the previous token. Index _cur tells which
+      one is the current token.
+    */
+
+    Token  _tok[2];
+    unsigned _cur;
+    bool   _at_end;
+
+  public:
+
+    iterator()
+      : _toks(NULL), _in_pos(0), _tok_pos(0), _cur(0), _at_end(true)
+    {}
+
+    iterator(const Tokenizer &toks, bool at_end = false)
+      : _toks(&toks), _in_pos(0), _tok_pos(0), _cur(0), _at_end(true)
     {
-      get_tokens();
+      if (at_end)
+        _in_pos = _tok_pos = toks._input.size();
+      else
+        next_token();
     }
 
+    const Token& operator*() const
+    {
+      if (!_toks)
+        THROW("token iterator: accessing null iterator");
+      if (_at_end)
+        THROW("token iterator: accessing end iterator");
+      return _tok[_cur];
+    }
 
-    bool empty() const
+    const Token* operator->() const
     {
-      return _tokens.empty();
+      return &(**this);
     }
 
-    iterator begin() const;
-    iterator end() const;
+    iterator& operator++()
+    {
+      if (_toks && !_at_end)
+        next_token();
+      return *this;
+    }
 
-  protected:
+    bool operator==(const iterator &other) const
+    {
+      if (_toks != other._toks || _at_end != other._at_end)
+        return false;
+      return _at_end || _in_pos == other._in_pos;
+    }
 
-    // Build token sequence from the input string.
+    bool operator!=(const iterator &other) const
+    {
+      return !(*this == other);
+    }
 
-    void get_tokens();
+    iterator operator+(size_t diff) const
+    {
+      iterator it(*this);
+      while (diff-- > 0)
+        ++it;
+      return it;
+    }
+
+  private:
+
+    /*
+      Parse the next token from the input string and make it the current
+      one. Sets _at_end if there are no more tokens.
+    */
+
+    void next_token();
 
     // Methods that parse characters into various kinds of tokens.
 
     bool parse_number();
-    bool parse_digits(string *digits = NULL);
+    bool parse_digits();
     bool parse_hex();
-    bool parse_hex_digits(string &digits);
+    bool parse_hex_digits();
     bool parse_string();
     bool parse_word();
-    bool parse_quotted_string(char_t, string *val = NULL);
+    bool parse_quotted_string(char_t);
 
     // access underlying sequence of characters
 
-    const string& get_input() const { return _input; }
+    const string& get_input() const { return _toks->_input; }
 
     char_t cur_char() const;
     size_t get_char_pos() const;
@@ -461,102 +554,13 @@ namespace parser {
     size_t set_token_start();
 
     /*
-      Add to the sequence new token of a given type. The token ends at the
-      current position within the input string and starts at the position
-      marked with set_token_start(). The characters of the token are all the
-      caracters of the input string between token's start and end position.
+      Set the current token to a new token of a given type. The token ends
+      at the current position within the input string and starts at the
+      position marked with set_token_start().
     */
 
     void add_token(Token::Type);
 
-    /*
-      This method works like `add_token(Token::Type)` but the characters of
-      the new token are as given by the second argument (instead of being taken
-      from the input string).
-    */
-
-    void add_token(Token::Type, const string&);
-
-
-    // Storage for tokens and the input string
-
-    string _input;
-    size_t _in_pos;   // current position in the input string
-    size_t _tok_pos;  // start position of a token in the input string
-
-    std::vector<Token> _tokens;
-    //tokens_t::size_type _pos;
-
-    friend Error;
-  };
-
-
-  /*
-    Iterator for accessing a sequence of tokens of a tokenizer.
-  */
-
-  class Tokenizer::iterator
-  {
-    const Tokenizer *_toks;
-    size_t     _pos;
-
-    iterator(const Tokenizer *toks, size_t pos = 0)
-      : _toks(toks), _pos(pos)
-    {}
-
-  public:
-
-    iterator()
-      : _toks(NULL), _pos(0)
-    {}
-
-    iterator(const Tokenizer &toks, bool at_end = false)
-      : _toks(&toks), _pos(0)
-    {
-      if (at_end)
-        _pos = toks._tokens.size();
-    }
-
-    iterator(const iterator &other)
-      : _toks(other._toks), _pos(other._pos)
-    {}
-
-    const Token& operator*() const
-    {
-      if (!_toks)
-        THROW("token iterator: accessing null iterator");
-      return _toks->_tokens[_pos];
-    }
-
-    const Token* operator->() const
-    {
-      if (!_toks)
-        THROW("token iterator: accessing null iterator");
-      return &(_toks->_tokens[_pos]);
-    }
-
-    iterator& operator++()
-    {
-      if (_toks && _pos < _toks->_tokens.size())
-        ++_pos;
-      return *this;
-    }
-
-    bool operator==(const iterator &other) const
-    {
-      return _toks == other._toks && _pos == other._pos;
-    }
-
-    bool operator!=(const iterator &other) const
-    {
-      return !(*this == other);
-    }
-
-    iterator operator+(size_t diff) const
-    {
-      return iterator(_toks, _pos + diff > 0 ? _pos + diff : 0);
-    }
-
     friend Tokenizer::Error;
   };
 
@@ -573,6 +577,12 @@ namespace parser {
     return iterator(*this, true);
   }
 
+  inline
+  bool Tokenizer::empty() const
+  {
+    return begin() == end();
+  }
+
 
   /*
     Tokenizer error class.
@@ -586,24 +596,30 @@ namespace parser {
   {
   public:
 
-    Error(const Tokenizer *p, const string &descr = string())
-      : parser::Error_base<string>(p->_input, p->_in_pos, descr)
-    {}
-
     Error(const Tokenizer::iterator &it, const string &msg = string())
       : parser::Error_base<string>(
           it._toks->_input,
-          it != it._toks->end() ? &(*it) : NULL,
+          it._at_end ? NULL : &(*it),
           msg
         )
     {}
+
+  private:
+
+    // Error at the current character position of a tokenizer iterator.
+
+    Error(const string &input, size_t pos, const string &descr)
+      : parser::Error_base<string>(input, pos, descr)
+    {}
+
+    friend Tokenizer::iterator;
   };
 
 
   inline
-  void Tokenizer::token_error(const string &msg) const
+  void Tokenizer::iterator::token_error(const string &msg) const
   {
-    throw Error(this, msg);
+    throw Error(get_input(), _in_pos, msg);
   }
 
 
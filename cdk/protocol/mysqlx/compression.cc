@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <mysql/cdk/foundation/common.h>
+#include "compression.h"
+
+
+namespace cdk {
+namespace protocol {
+namespace mysqlx {
+
+#ifdef HAVE_COMPRESSION
+
+Compression::Compression(compression_type::value type, size_t threshold)
+  : m_threshold(threshold)
+{
+  if (compression_type::DEFLATE != type)
+    throw_error("Unsupported compression algorithm");
+
+  memset(&m_def, 0, sizeof(m_def));
+  memset(&m_inf, 0, sizeof(m_inf));
+
+  if (Z_OK != deflateInit(&m_def, Z_DEFAULT_COMPRESSION))
+    throw_error("Could not initialize compression");
+
+  if (Z_OK != inflateInit(&m_inf))
+  {
+    deflateEnd(&m_def);
+    throw_error("Could not initialize decompression");
+  }
+}
+
+
+Compression::~Compression()
+{
+  deflateEnd(&m_def);
+  inflateEnd(&m_inf);
+}
+
+
+void Compression::compress(bytes data, std::string &out)
+{
+  size_t done = out.size();
+
+  // Note: sync flush adds a few bytes on top of deflateBound().
+
+  out.resize(done + deflateBound(&m_def, (uLong)data.size()) + 16);
+
+  m_def.next_in = data.begin();
+  m_def.avail_in = (uInt)data.size();
+
+  do {
+
+    if (done == out.size())
+      out.resize(2 * out.size());
+
+    m_def.next_out = (Bytef*)&out[done];
+    m_def.avail_out = (uInt)(out.size() - done);
+
+    int rc = deflate(&m_def, Z_SYNC_FLUSH);
+
+    if (Z_OK != rc && Z_BUF_ERROR != rc)
+      throw_error("Compression error");
+
+    done = out.size() - m_def.avail_out;
+  }
+  while (0 == m_def.avail_out);
+
+  out.resize(done);
+}
+
+
+bytes Compression::uncompress(bytes data, size_t size_hint)
+{
+  if (m_inf_buf.size() < size_hint)
+    m_inf_buf.resize(size_hint);
+  if (m_inf_buf.empty())
+    m_inf_buf.resize(4 * data.size() + 64);
+
+  m_inf.next_in = data.begin();
+  m_inf.avail_in = (uInt)data.size();
+
+  size_t done = 0;
+
+  for (;;)
+  {
+    if (done == m_inf_buf.size())
+      m_inf_buf.resize(2 * m_inf_buf.size());
+
+    m_inf.next_out = (Bytef*)&m_inf_buf[done];
+    m_inf.avail_out = (uInt)(m_inf_buf.size() - done);
+
+    int rc = inflate(&m_inf, Z_SYNC_FLUSH);
+
+    done = m_inf_buf.size() - m_inf.avail_out;
+
+    if (Z_STREAM_END == rc)
+    {
+      // The peer finished the stream -- be ready for a new one.
+      inflateReset(&m_inf);
+      if (0 == m_inf.avail_in)
+        break;
+      continue;
+    }
+
+    if (Z_OK != rc && Z_BUF_ERROR != rc)
+      throw_error("Decompression error");
+
+    // Stop when all input is consumed and there is no more pending output.
+
+    if (0 == m_inf.avail_in && 0 < m_inf.avail_out)
+      break;
+
+    if (Z_BUF_ERROR == rc && 0 < m_inf.avail_out)
+      throw_error("Truncated compressed data");
+  }
+
+  return bytes((byte*)&m_inf_buf[0], done);
+}
+
+#else
+
+Compression::Compression(compression_type::value, size_t threshold)
+  : m_threshold(threshold)
+{
+  throw_error("Compression is not supported by this build");
+}
+
+Compression::~Compression()
+{}
+
+void Compression::compress(bytes, std::string&)
+{
+  assert(false);
+}
+
+bytes Compression::uncompress(bytes, size_t)
+{
+  assert(false);
+  return bytes();
+}
+
+#endif
+
+
+}}}  // cdk::protocol::mysqlx
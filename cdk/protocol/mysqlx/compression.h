@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef PROTOCOL_MYSQLX_COMPRESSION_H
+#define PROTOCOL_MYSQLX_COMPRESSION_H
+
+#include "protocol.h"
+
+PUSH_PB_WARNINGS
+#include "protobuf/mysqlx_connection.pb.h"
+POP_PB_WARNINGS
+
+PUSH_SYS_WARNINGS
+#ifdef HAVE_COMPRESSION
+#include <zlib.h>
+#endif
+#include <string>
+POP_SYS_WARNINGS
+
+
+namespace cdk {
+namespace protocol {
+namespace mysqlx {
+
+
+/*
+  Compression of message frames
+  =============================
+
+  Once compression is negotiated, a sender can wrap one or more complete
+  message frames (header included) inside a single Mysqlx.Connection.Compression
+  message. The "deflate_stream" algorithm is used, which means that a single
+  zlib stream spans all compressed messages sent in one direction and each
+  message ends with a sync flush point. For that reason the deflate and inflate
+  states are kept for the lifetime of the Compression object.
+
+  Sender compresses all frames collected in its output buffer at once (see
+  Protocol_impl::wr_flush()), so one compressed frame can contain several
+  messages.
+
+  Method compress() appends compressed data to the given string, which is
+  meant to be the payload field of m_msg. Method uncompress() decompresses
+  given data into an internal buffer and returns it -- the returned bytes
+  are valid until the next call to uncompress().
+
+  If the connector is built without zlib (HAVE_COMPRESSION not defined),
+  the constructor throws an error.
+*/
+
+class Compression
+  : foundation::nocopy
+{
+public:
+
+  Compression(compression_type::value type, size_t threshold);
+  ~Compression();
+
+  /// Output shorter than this is sent without compression.
+  size_t threshold() const { return m_threshold; }
+
+  void compress(bytes data, std::string &out);
+  bytes uncompress(bytes data, size_t size_hint = 0);
+
+  /*
+    Message object used to build outgoing or parse incoming compressed
+    frames.
+  */
+
+  Mysqlx::Connection::Compression m_msg;
+
+private:
+
+  size_t   m_threshold;
+#ifdef HAVE_COMPRESSION
+  z_stream m_def;
+  z_stream m_inf;
+#endif
+
+  std::string m_inf_buf;
+};
+
+
+}}}  // cdk::protocol::mysqlx
+
+#endif
@@ -39,6 +39,7 @@
 
 PUSH_PB_WARNINGS
 #include "protobuf/mysqlx_sql.pb.h"
+#include "protobuf/mysqlx_prepare.pb.h"
 POP_PB_WARNINGS
 
 
@@ -500,6 +501,30 @@ Protocol::snd_Find(Data_model dm, const Find_spec &fs, const api::Args_map *args
 }
 
 
+/*
+  Prepare message wraps a statement message which is built in the same way
+  as when the statement is executed directly. Argument values stored in
+  the statement message by set_args() are removed, because values of
+  placeholders are sent later with Prepare::Execute message.
+*/
+
+Protocol::Op&
+Protocol::snd_PrepareFind(uint32_t stmt_id, Data_model dm, const Find_spec &fs,
+                          const api::Args_map *args)
+{
+  Mysqlx::Prepare::Prepare prepare;
+  prepare.set_stmt_id(stmt_id);
+
+  Mysqlx::Prepare::Prepare_OneOfMessage *stmt = prepare.mutable_stmt();
+  stmt->set_type(Mysqlx::Prepare::Prepare_OneOfMessage_Type_FIND);
+
+  set_find(*stmt->mutable_find(), dm, fs, args);
+  stmt->mutable_find()->clear_args();
+
+  return get_impl().snd_start(prepare, msg_type::cli_PreparePrepare);
+}
+
+
 // -------------------------------------------------------------------------
 
 
@@ -562,7 +587,8 @@ Protocol::snd_Insert(
     const api::Columns *columns,
     Row_source &rs,
     const api::Args_map *args,
-    bool upsert)
+    bool upsert,
+    size_t max_size)
 {
   Mysqlx::Crud::Insert insert;
 
@@ -581,7 +607,14 @@ Protocol::snd_Insert(
     columns->process(proj_builder);
   }
 
-  while (rs.next())
+  /*
+    Note: the size limit is checked before calling rs.next() so that the row
+    source is not moved to a row which would not be sent.
+  */
+
+  size_t size = 0;
+
+  while ((0 == max_size || size < max_size) && rs.next())
   {
     Mysqlx::Crud::Insert_TypedRow *msg = insert.add_row();
 
@@ -589,6 +622,9 @@ Protocol::snd_Insert(
 
     row_builder.reset(*msg, &conv);
     rs.process(row_builder);
+
+    if (0 < max_size)
+      size += static_cast<size_t>(msg->ByteSize());
   }
 
   insert.set_upsert(upsert);
@@ -669,13 +705,12 @@ public:
 
 
 
-Protocol::Op& Protocol::snd_Update(
-    Data_model dm,
-    const Select_spec &sel,
-    Update_spec &us,
-    const api::Args_map *args)
+void set_update(Mysqlx::Crud::Update &update,
+                Data_model dm,
+                const Select_spec &sel,
+                Update_spec &us,
+                const api::Args_map *args)
 {
-  Mysqlx::Crud::Update update;
   Placeholder_conv_imp conv;
 
   set_data_model(dm, update);
@@ -690,18 +725,50 @@ Protocol::Op& Protocol::snd_Update(
     Update_builder prc(*update.add_operation(), conv);
     us.process(prc);
   }
+}
+
+
+Protocol::Op& Protocol::snd_Update(
+    Data_model dm,
+    const Select_spec &sel,
+    Update_spec &us,
+    const api::Args_map *args)
+{
+  Mysqlx::Crud::Update update;
+
+  set_update(update, dm, sel, us, args);
 
   return get_impl().snd_start(update, msg_type::cli_CrudUpdate);
 }
 
 
+Protocol::Op& Protocol::snd_PrepareUpdate(
+    uint32_t stmt_id,
+    Data_model dm,
+    const Select_spec &sel,
+    Update_spec &us,
+    const api::Args_map *args)
+{
+  Mysqlx::Prepare::Prepare prepare;
+  prepare.set_stmt_id(stmt_id);
+
+  Mysqlx::Prepare::Prepare_OneOfMessage *stmt = prepare.mutable_stmt();
+  stmt->set_type(Mysqlx::Prepare::Prepare_OneOfMessage_Type_UPDATE);
+
+  set_update(*stmt->mutable_update(), dm, sel, us, args);
+  stmt->mutable_update()->clear_args();
+
+  return get_impl().snd_start(prepare, msg_type::cli_PreparePrepare);
+}
+
+
 // -------------------------------------------------------------------------
 
 
-Protocol::Op&
-Protocol::snd_Delete(Data_model dm, const Select_spec &sel, const api::Args_map *args)
+void set_delete(Mysqlx::Crud::Delete &del,
+                Data_model dm, const Select_spec &sel,
+                const api::Args_map *args)
 {
-  Mysqlx::Crud::Delete del;
   Placeholder_conv_imp conv;
 
   set_data_model(dm, del);
@@ -710,11 +777,83 @@ Protocol::snd_Delete(Data_model dm, const Select_spec &sel, const api::Args_map
     set_args(*args, del, conv);
 
   set_select(sel, del, conv);
+}
+
+
+Protocol::Op&
+Protocol::snd_Delete(Data_model dm, const Select_spec &sel, const api::Args_map *args)
+{
+  Mysqlx::Crud::Delete del;
+
+  set_delete(del, dm, sel, args);
 
   return get_impl().snd_start(del, msg_type::cli_CrudDelete);
 }
 
 
+Protocol::Op&
+Protocol::snd_PrepareDelete(uint32_t stmt_id, Data_model dm,
+                            const Select_spec &sel, const api::Args_map *args)
+{
+  Mysqlx::Prepare::Prepare prepare;
+  prepare.set_stmt_id(stmt_id);
+
+  Mysqlx::Prepare::Prepare_OneOfMessage *stmt = prepare.mutable_stmt();
+  stmt->set_type(Mysqlx::Prepare::Prepare_OneOfMessage_Type_DELETE);
+
+  set_delete(*stmt->mutable_delete_(), dm, sel, args);
+  stmt->mutable_delete_()->clear_args();
+
+  return get_impl().snd_start(prepare, msg_type::cli_PreparePrepare);
+}
+
+
+// -------------------------------------------------------------------------
+
+
+/*
+  Values of named parameters are sent in Prepare::Execute message in the
+  order in which they are reported by the argument map. This is the same
+  order in which positions were assigned to them by set_args() when the
+  statement was prepared.
+*/
+
+class Exec_args_builder
+  : public api::Args_map::Processor
+{
+  Mysqlx::Prepare::Execute &m_msg;
+  Any_builder m_builder;
+
+public:
+
+  Exec_args_builder(Mysqlx::Prepare::Execute &msg)
+    : m_msg(msg)
+  {}
+
+  Any_prc* key_val(const string&)
+  {
+    m_builder.reset(*m_msg.add_args());
+    return &m_builder;
+  }
+};
+
+
+Protocol::Op&
+Protocol::snd_PrepareExecute(uint32_t stmt_id, const api::Args_map *args)
+{
+  Mysqlx::Prepare::Execute execute;
+  execute.set_stmt_id(stmt_id);
+
+  if (args)
+  {
+    Exec_args_builder args_builder(execute);
+    args->process(args_builder);
+  }
+
+  return get_impl().snd_start(execute, msg_type::cli_PrepareExecute);
+}
+
+
 // -------------------------------------------------------------------------
 
 
@@ -52,6 +52,7 @@
 #endif
 
 #include "protocol.h"
+#include "compression.h"
 
 PUSH_SYS_WARNINGS
 #include <memory.h> // for memcpy
@@ -141,13 +142,17 @@ static void log_handler_init()
 Protocol_impl::Protocol_impl(Protocol::Stream *str, Protocol_side side)
   : m_str(str), m_side(side)
   , m_msg_state(PAYLOAD)
+  , m_rd_pos(0), m_rd_end(0), m_rd_need(0)
+  , m_msg_buf(NULL)
   , m_msg_size(0)
+  , m_wr_pos(0), m_wr_batch(0)
 {
   EXECUTE_ONCE(&log_handler_once, &log_handler_init);
 
   // Allocate initial I/O buffers
 
-  m_wr_size= m_rd_size= 512;
+  m_wr_size= 512;
+  m_rd_size= rd_ahead_size;
   m_rd_buf= (byte*)malloc(m_rd_size);
   m_wr_buf= (byte*)malloc(m_wr_size);
 
@@ -156,10 +161,14 @@ Protocol_impl::Protocol_impl(Protocol::Stream *str, Protocol_side side)
 
   if (!m_wr_buf)
     throw_error("Could not allocate initial output buffer");
+
+  memset(m_rcv_msg, 0, sizeof(m_rcv_msg));
 }
 
 Protocol_impl::~Protocol_impl()
 {
+  for (size_t type = 0; type < sizeof(m_rcv_msg)/sizeof(Message*); ++type)
+    delete m_rcv_msg[type];
   free(m_rd_buf);
   free(m_wr_buf);
   delete m_str;
@@ -213,6 +222,14 @@ Protocol::Op& Protocol_impl::snd_start(Message &msg, msg_type_t msg_type)
 }
 
 
+Protocol::Op& Protocol_impl::snd_flush()
+{
+  m_snd_op.reset();
+  m_snd_op.reset(new Op_snd(*this));
+  return *m_snd_op;
+}
+
+
 /*
   Helper function which creates protobuf message object of type
   indicated by msg_type identifier. Interpretation of msg_type_t
@@ -259,6 +276,20 @@ Message* mk_message(Protocol_side side, msg_type_t msg_type)
 
 
 
+Message& Protocol_impl::rcv_msg(msg_type_t msg_type)
+{
+  if (msg_type >= sizeof(m_rcv_msg)/sizeof(Message*))
+    THROW("unknown message type");
+
+  Message *&msg = m_rcv_msg[msg_type];
+
+  if (!msg)
+    msg = mk_message(m_side, msg_type);
+
+  return *msg;
+}
+
+
 /*
   Protobuf error logger
   =====================
@@ -305,19 +336,43 @@ static void log_handler(LogLevel level, const char* filename, int line, const st
 
 void Protocol_impl::write_msg(msg_type_t msg_type, Message &msg)
 {
-  if (m_wr_op)
-    THROW("Can't write message while another one is written");
+  // Output buffer can not be modified while it is being written.
+
+  wr_wait();
+
+  size_t len = wr_frame(m_wr_pos, msg_type, msg);
+
+  m_wr_pos += len;
+
+  // Unless batching, create write operation to send the frame right away.
+
+  if (m_wr_pos >= m_wr_batch)
+    wr_flush();
+}
+
+
+/*
+  Serialize given message into m_wr_buf at position `pos`, wrapped in
+  a message frame. Returns the total length of the frame.
+*/
 
+size_t Protocol_impl::wr_frame(size_t pos, msg_type_t msg_type, Message &msg)
+{
   msg_size_t net_size = static_cast<unsigned>(msg.ByteSize()) + 1;
 
-  if (!resize_buf(CLIENT, header_length + net_size))
+  if (pos + header_length + net_size > max_wr_size)
+    THROW("Message too large");
+
+  if (!resize_buf(CLIENT, pos + header_length + net_size))
     THROW("Not enough memory for output buffer");
 
+  byte *frame = m_wr_buf + pos;
+
   // Construct message header
 
   HTONSIZE(net_size);
-  memcpy((void*)m_wr_buf, (const void*)&net_size, sizeof(net_size));
-  m_wr_buf[header_length - 1] = (byte)msg_type;
+  memcpy((void*)frame, (const void*)&net_size, sizeof(net_size));
+  frame[header_length - 1] = (byte)msg_type;
 
   // Convert net_size back to original endian before using it later
 
@@ -327,13 +382,112 @@ void Protocol_impl::write_msg(msg_type_t msg_type, Message &msg)
 
   assert(m_wr_size < (size_t)std::numeric_limits<int>::max());
 
-  if (!msg.SerializeToArray((void*)(m_wr_buf + header_length),
-                            (int)(m_wr_size - header_length)))
+  if (!msg.SerializeToArray((void*)(frame + header_length),
+                            (int)(m_wr_size - pos - header_length)))
     throw_error(cdkerrc::protobuf_error, "Serialization error!");
 
-  // Create write operation to send message payload
+  return net_size + header_length - 1;
+}
+
+
+/*
+  Start writing frames collected in the output buffer, if any. Does
+  nothing if a write operation is already in progress.
+*/
+
+void Protocol_impl::wr_flush()
+{
+  if (m_wr_op || 0 == m_wr_pos)
+    return;
+
+  if (m_compression && m_wr_pos >= m_compression->threshold())
+    wr_compress();
+
+  m_wr_op.reset(m_str->write(buffers(m_wr_buf, m_wr_pos)));
+}
+
+
+/*
+  Compress all frames collected in the output buffer and replace them with
+  a single compressed frame. Compressing the whole batch at once gives
+  better compression ratio than compressing individual messages and allows
+  compressing batches of small messages.
+
+  The type of the compressed messages is passed in the client_messages or
+  server_messages field, depending on which side we are, but only if all
+  of them have the same type. Otherwise the field is not set and the other
+  side finds the types in the headers of the decompressed frames.
+*/
+
+void Protocol_impl::wr_compress()
+{
+  Mysqlx::Connection::Compression &frame = m_compression->m_msg;
+
+  frame.Clear();
+  m_compression->compress(bytes(m_wr_buf, m_wr_pos),
+                          *frame.mutable_payload());
+  frame.set_uncompressed_size(m_wr_pos);
+
+  // Check if all frames in the buffer are of the same type.
+
+  msg_type_t msg_type = m_wr_buf[header_length - 1];
+  bool same_type = true;
+
+  for (size_t pos = 0; pos < m_wr_pos;)
+  {
+    msg_size_t msg_size;
+    memcpy(&msg_size, m_wr_buf + pos, sizeof(msg_size));
+    NTOHSIZE(msg_size);
+
+    if (msg_type != m_wr_buf[pos + header_length - 1])
+    {
+      same_type = false;
+      break;
+    }
+
+    pos += header_length + msg_size - 1;
+  }
 
-  m_wr_op.reset(m_str->write(buffers(m_wr_buf, net_size + header_length - 1)));
+  if (SERVER == m_side)
+  {
+    if (same_type)
+      frame.set_client_messages(msg_type);
+    m_wr_pos = wr_frame(0, ClientMessages_Type_COMPRESSION, frame);
+  }
+  else
+  {
+    if (same_type)
+      frame.set_server_messages(msg_type);
+    m_wr_pos = wr_frame(0, ServerMessages_Type_COMPRESSION, frame);
+  }
+}
+
+
+void Protocol_impl::set_compression(
+  compression_type::value type, size_t threshold
+)
+{
+  if (compression_type::NONE == type)
+  {
+    m_compression.reset();
+    return;
+  }
+
+  m_compression.reset(new Compression(type, threshold));
+}
+
+
+void Protocol_impl::set_batching(size_t limit)
+{
+  m_wr_batch = limit;
+
+  // If batching is disabled, write messages that were collected so far.
+
+  if (0 == m_wr_batch)
+  {
+    wr_flush();
+    wr_wait();
+  }
 }
 
 
@@ -346,6 +500,7 @@ bool Protocol_impl::wr_cont()
     return false;
 
   m_wr_op.reset();
+  m_wr_pos = 0;
   return true;
 }
 
@@ -356,20 +511,27 @@ void Protocol_impl::wr_wait()
   {
     m_wr_op->wait();
     m_wr_op.reset();
+    m_wr_pos = 0;
   }
 }
 
 
 void Protocol_impl::read_header()
 {
+  // The other side might wait for messages collected in the output buffer.
+
+  wr_flush();
+
   if (HEADER == m_msg_state)
     return;
 
   if (m_rd_op)
     THROW("can't read header when reading payload is not completed");
 
-  m_rd_op.reset(m_str->read(buffers(m_rd_buf,4)));
   m_msg_state= HEADER;
+
+  if (rd_fill(header_length))
+    rd_done();
 }
 
 void Protocol_impl::read_payload()
@@ -383,45 +545,190 @@ void Protocol_impl::read_payload()
   if (m_rd_op)
     THROW("can't read payload when reading header is not completed");
 
-  if (!resize_buf(SERVER, m_msg_size))
+  m_msg_state= PAYLOAD;
+
+  if (rd_fill(m_msg_size))
+    rd_done();
+}
+
+
+/*
+  Make sure that at least `need` unconsumed bytes are present in the
+  read-ahead buffer. Returns true if this is already the case. Otherwise
+  starts asynchronous operation which reads more bytes from the stream
+  and returns false. Completion of this operation is handled by rd_cont()
+  or rd_wait() which will call rd_fill() again with the same requirement.
+
+  Before reading, unconsumed bytes are moved to the beginning of the buffer
+  and the buffer is extended if it is too small to hold `need` bytes. Note
+  that this invalidates m_msg_buf, which is fine because rd_fill() is
+  called only after the previous message has been processed.
+*/
+
+bool Protocol_impl::rd_fill(size_t need)
+{
+  assert(!m_rd_op);
+  assert(m_rd_pos <= m_rd_end);
+
+  m_rd_need= need;
+
+  size_t avail= m_rd_end - m_rd_pos;
+
+  if (avail >= need)
+    return true;
+
+  if (m_rd_pos > 0)
+  {
+    if (avail > 0)
+      memmove(m_rd_buf, m_rd_buf + m_rd_pos, avail);
+    m_rd_pos= 0;
+    m_rd_end= avail;
+  }
+
+  if (need > max_rd_size)
+    THROW("Message too large");
+
+  if (!resize_buf(SERVER, need))
+    THROW("Not enough memory for input buffer");
+
+  // Read as much as fits in the free space of the buffer.
+
+  m_rd_op.reset(m_str->read_some(buffers(m_rd_buf + m_rd_end,
+                                         m_rd_size - m_rd_end)));
+  return false;
+}
+
+
+/*
+  Called when enough bytes have been read to complete the current stage:
+  either process the header or expose the payload in m_msg_buf. Returns
+  false if more bytes must be read first, in which case a new read
+  operation has been started by rd_fill().
+*/
+
+bool Protocol_impl::rd_done()
+{
+  switch (m_msg_state)
+  {
+  case HEADER:
+    if (!rd_inflate())
+      return false;
+    rd_process();
+    break;
+
+  case PAYLOAD:
+    m_msg_buf= m_rd_buf + m_rd_pos;
+    m_rd_pos += m_msg_size;
+    break;
+  }
+
+  return true;
+}
+
+
+/*
+  If compression is enabled and the frame at the current position of
+  the read-ahead buffer is a compressed one, read it completely and
+  replace it in the buffer by the frames obtained from decompressing its
+  payload. This is repeated until the buffer starts with a header of
+  a regular frame. Returns false if more bytes must be read first.
+*/
+
+bool Protocol_impl::rd_inflate()
+{
+  const msg_type_t compressed_type = (SERVER == m_side ?
+    (msg_type_t)ServerMessages_Type_COMPRESSION
+    : (msg_type_t)ClientMessages_Type_COMPRESSION);
+
+  while (m_compression
+         && compressed_type == m_rd_buf[m_rd_pos + header_length - 1])
+  {
+    msg_size_t msg_size;
+    memcpy(&msg_size, m_rd_buf + m_rd_pos, sizeof(msg_size));
+    NTOHSIZE(msg_size);
+
+    if (0 == msg_size)
+      THROW("Invalid message frame");
+
+    size_t frame_size = header_length + msg_size - 1;
+
+    if (!rd_fill(frame_size))
+      return false;
+
+    Mysqlx::Connection::Compression &frame = m_compression->m_msg;
+
+    if (!frame.ParseFromArray(m_rd_buf + m_rd_pos + header_length,
+                              (int)(msg_size - 1)))
+      THROW("Could not parse compressed frame");
+
+    bytes data = m_compression->uncompress(
+      bytes(frame.payload()),
+      frame.has_uncompressed_size() ? (size_t)frame.uncompressed_size() : 0
+    );
+
+    /*
+      Put decompressed frames at the beginning of the buffer, followed by
+      the bytes that were read after the compressed frame.
+    */
+
+    size_t tail = m_rd_end - m_rd_pos - frame_size;
+
+    if (!resize_buf(SERVER, data.size() + tail))
       THROW("Not enough memory for input buffer");
 
-  if (m_msg_size > 0)
-    m_rd_op.reset(m_str->read(buffers(m_rd_buf, m_msg_size)));
-  m_msg_state= PAYLOAD;
+    memmove(m_rd_buf + data.size(), m_rd_buf + m_rd_pos + frame_size, tail);
+    memcpy(m_rd_buf, data.begin(), data.size());
+    m_rd_pos= 0;
+    m_rd_end= data.size() + tail;
+
+    if (!rd_fill(header_length))
+      return false;
+  }
+
+  return true;
 }
 
 
 bool Protocol_impl::rd_cont()
 {
+  if (!wr_cont())
+    return false;
+
   if (!m_rd_op)
     return true;
 
   if (!m_rd_op->cont())
     return false;
 
+  m_rd_end += m_rd_op->get_result();
   m_rd_op.reset();
 
-  if (PAYLOAD == m_msg_state)
-    return true;
+  // If not enough bytes were read yet, rd_fill() starts another read.
 
-  rd_process();
+  if (!rd_fill(m_rd_need))
+    return false;
 
-  return true;
+  return rd_done();
 }
 
 
 void Protocol_impl::rd_wait()
 {
-  if (m_rd_op)
+  wr_wait();
+
+  /*
+    Note: rd_done() can start another read if the buffer contained
+    a compressed frame.
+  */
+
+  while (m_rd_op)
   {
     m_rd_op->wait();
+    m_rd_end += m_rd_op->get_result();
     m_rd_op.reset();
 
-    if (PAYLOAD == m_msg_state)
-      return;
-
-    rd_process();
+    if (rd_fill(m_rd_need))
+      rd_done();
   }
 }
 
@@ -461,15 +768,18 @@ bool Protocol_impl::resize_buf(Protocol_side side, size_t requested_size)
 
 void Protocol_impl::rd_process()
 {
-  m_msg_size= *(msg_size_t*)m_rd_buf;
-  NTOHSIZE(m_msg_size);
-  assert(m_msg_size > 0);
-  m_msg_size--;
+  assert(m_rd_end - m_rd_pos >= header_length);
 
-  m_rd_op.reset(m_str->read(buffers(m_rd_buf, 1)));
-  m_rd_op->wait();
-  m_rd_op.reset();
-  m_msg_type= m_rd_buf[0];
+  msg_size_t msg_size;
+  memcpy(&msg_size, m_rd_buf + m_rd_pos, sizeof(msg_size));
+  NTOHSIZE(msg_size);
+
+  if (0 == msg_size)
+    THROW("Invalid message frame");
+
+  m_msg_size= msg_size - 1;
+  m_msg_type= m_rd_buf[m_rd_pos + header_length - 1];
+  m_rd_pos += header_length;
 }
 
 
@@ -667,16 +977,9 @@ void Op_rcv::process_payload()
 
   try {
 
-    byte *cur_pos = m_proto.m_rd_buf;
+    byte *cur_pos = m_proto.m_msg_buf;
     byte *end_pos = cur_pos + m_msg_size;
 
-    /*
-      Note: read_header() checks if message fits into the buffer and
-      throws error if this is not the case.
-    */
-
-    assert(m_msg_size <= m_proto.m_rd_size);
-
     while (cur_pos < end_pos && m_read_window)
     {
       size_t new_window = m_prc->message_data(bytes(cur_pos,
@@ -698,24 +1001,56 @@ void Op_rcv::process_payload()
   if (m_skip)
     return;
 
-  // Parse message.
+#ifndef DEBUG_PROTOBUF
 
-  scoped_ptr<Message> m_msg;
-  m_msg.reset(mk_message(m_proto.m_side, m_msg_type));
+  // Give the operation a chance to process the payload without parsing it.
 
-  if (m_msg_size > 0)
+  try {
+    if (process_raw(m_msg_type, bytes(m_proto.m_msg_buf, m_msg_size)))
+      return;
+  }
+  catch (...)
   {
-    try {
-      assert(m_msg_size < (size_t)std::numeric_limits<int>::max());
-      if (!m_msg->ParseFromArray(m_proto.m_rd_buf, (int)m_msg_size))
-        throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+    save_error();
+    return;
+  }
+
+#endif
+
+  /*
+    Parse message. Messages are parsed into objects cached by the protocol
+    instance so that their memory is reused. An exception are messages
+    larger than the read-ahead buffer -- for these we use a temporary
+    object so that it does not hold on to a large amount of memory after
+    the message is processed.
+  */
+
+  scoped_ptr<Message> tmp_msg;
+  Message *m_msg;
+
+  try {
+
+    if (m_msg_size > rd_ahead_size)
+    {
+      tmp_msg.reset(mk_message(m_proto.m_side, m_msg_type));
+      m_msg = tmp_msg.get();
     }
-    catch (...)
+    else
+      m_msg = &m_proto.rcv_msg(m_msg_type);
+
+    if (m_msg_size > 0)
     {
-      save_error();
-      m_msg.reset();
-      return;
+      assert(m_msg_size < (size_t)std::numeric_limits<int>::max());
+      if (!m_msg->ParseFromArray(m_proto.m_msg_buf, (int)m_msg_size))
+        throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
     }
+    else
+      m_msg->Clear();
+  }
+  catch (...)
+  {
+    save_error();
+    return;
   }
 
 #ifdef DEBUG_PROTOBUF
@@ -824,11 +1159,37 @@ Protocol::Op& Protocol::rcv_Reply(Reply_processor &prc)
 }
 
 
+void Protocol::set_compression(compression_type::value type, size_t threshold)
+{
+  get_impl().set_compression(type, threshold);
+}
+
+
+void Protocol::set_batching(bool on, size_t limit)
+{
+  get_impl().set_batching(on ? limit : 0);
+}
+
+
+Protocol::Op& Protocol::flush()
+{
+  return get_impl().snd_flush();
+}
+
+
 // Server-side API
 // ===============
 // TODO: Complete and adapt to protocol changes.
 
 
+void Protocol_server::set_compression(
+  compression_type::value type, size_t threshold
+)
+{
+  get_impl().set_compression(type, threshold);
+}
+
+
 Protocol::Op& Protocol_server::snd_Ok(const string &msg)
 {
   Mysqlx::Ok ok;
@@ -95,6 +95,9 @@ const size_t header_length= 5;
 const size_t max_wr_size= 1024*1024*1024;  // 1GB
 const size_t max_rd_size= max_wr_size;
 
+/// Initial size of the read-ahead buffer used for incoming messages.
+const size_t rd_ahead_size= 64*1024;
+
 // TODO: use throw_error or any other appropriate method when the code is ready
 #define THROW_PROTOCOL_ERROR(ERR) throw ERR
 
@@ -116,6 +119,7 @@ Protocol_side other_side(Protocol_side side)
 
 class Op_base;
 class Op_rcv;
+class Compression;
 
 /*
   Internal implementation for Protocol class.
@@ -171,6 +175,25 @@ public:
   template <class RCV, class PRC>
   Protocol::Op& rcv_start(PRC&);
 
+  /**
+    Enable or disable compression of message frames (see Compression class).
+  */
+
+  void set_compression(compression_type::value, size_t threshold);
+
+  /**
+    Enable or disable batching of outgoing messages (see write_msg()).
+    A limit of 0 disables batching.
+  */
+
+  void set_batching(size_t limit);
+
+  /**
+    Start async op that writes all messages collected in the output buffer.
+  */
+
+  Protocol::Op& snd_flush();
+
 protected:
 
   /*
@@ -183,12 +206,25 @@ protected:
     be called only at the beginning or after reading message payload.
 
     Method read_payload() starts asynchronous reading of message payload.
-    If payload has been already read, it does nothing. The payload is placed
-    in m_rd_buf buffer. This method can be called only after reading message
-    header.
+    If payload has been already read, it does nothing. When reading is
+    completed, m_msg_buf points at the payload. It stays valid until the
+    next call to read_header(). This method can be called only after reading
+    message header.
 
     To complete the asynchronous header/payload reading operation one has
     to call method rd_cont() until it returns true.
+
+    Bytes are not read from the stream frame by frame. Instead m_rd_buf is
+    used as a read-ahead buffer which is filled with as many bytes as
+    the stream can deliver in one go. Unconsumed bytes are kept between
+    m_rd_pos and m_rd_end offsets. Reading header or payload of a message
+    which is already present in the buffer completes immediately without
+    touching the stream. This way a single read from the stream can deliver
+    many small messages, such as rows of a result set.
+
+    If compression is enabled, a compressed frame found in the buffer when
+    reading a header is replaced by the frames obtained from decompressing
+    its payload (see rd_inflate()). Layers above never see compressed frames.
   */
 
   enum { HEADER, PAYLOAD }   m_msg_state;
@@ -200,8 +236,17 @@ protected:
 
   byte   *m_rd_buf;
   size_t  m_rd_size;
+  size_t  m_rd_pos;
+  size_t  m_rd_end;
+  size_t  m_rd_need;
   scoped_ptr<Protocol::Stream::Op> m_rd_op;
 
+  bool rd_fill(size_t);
+  bool rd_done();
+  bool rd_inflate();
+
+  byte   *m_msg_buf;
+
   // Info extracted from message header
 
   msg_type_t m_msg_type;
@@ -217,18 +262,64 @@ protected:
 
     To complete writing operation one has to call method wr_cont() until it
     returns true.
+
+    Frames are appended to m_wr_buf, which holds m_wr_pos bytes of frames
+    that were not written yet. Normally write_msg() calls wr_flush() which
+    starts writing the buffer contents to the stream. But if batching is
+    enabled (m_wr_batch > 0), frames are collected in the buffer until
+    their total size reaches m_wr_batch bytes. This way several messages
+    sent in a row are written to the stream with a single write operation.
+    Collected frames are also flushed when reading of a message header
+    starts, because the other side might wait for them before sending
+    anything, and when snd_flush() is called.
+
+    If compression is enabled and the frames collected in m_wr_buf take
+    at least the compression threshold, wr_flush() compresses all of them
+    into a single compressed frame which is then written instead (see
+    wr_compress()).
+
+    While frames are being written, the contents of m_wr_buf can not be
+    changed. Thus write_msg() first completes any pending write operation.
+    Reading operations also complete the pending write before reading
+    anything (see rd_cont() and rd_wait()).
   */
 
   void write_msg(msg_type_t, Message&);
+  size_t wr_frame(size_t pos, msg_type_t, Message&);
+  void wr_flush();
+  void wr_compress();
   bool wr_cont();
   void wr_wait();
 
   byte   *m_wr_buf;
   size_t  m_wr_size;
+  size_t  m_wr_pos;
+  size_t  m_wr_batch;
   scoped_ptr<Protocol::Stream::Op> m_wr_op;
 
   bool resize_buf(Protocol_side side, size_t new_size);
 
+  scoped_ptr<Compression> m_compression;
+
+  /*
+    Message objects for parsing incoming messages
+    ---------------------------------------------
+
+    Method rcv_msg() returns message object of the type indicated by given
+    message type identifier. Such objects are created on first use and then
+    cached and reused for parsing subsequent messages of the same type. This
+    way memory allocated by a message object (such as repeated fields and
+    strings) is re-used when parsing a stream of messages, such as rows of
+    a result set, instead of being allocated and freed for each message.
+
+    Note that a message object returned by rcv_msg() is valid only until the
+    next call for the same message type.
+  */
+
+  Message& rcv_msg(msg_type_t);
+
+  Message *m_rcv_msg[256];
+
 public:
 
   /**
@@ -345,7 +436,20 @@ protected:
 
   void do_cancel() { THROW("not implemented"); }
 
-  cdk::api::Event_info* get_event_info() const { return NULL; }
+  /*
+    An operation which is not completed waits for the pending read or write
+    of message frames. Pending write is reported first, because it must
+    complete before anything is read (see Protocol_impl::rd_cont()).
+  */
+
+  const cdk::api::Event_info* get_event_info() const
+  {
+    if (m_proto.m_wr_op)
+      return m_proto.m_wr_op->waits_for();
+    if (m_proto.m_rd_op)
+      return m_proto.m_rd_op->waits_for();
+    return NULL;
+  }
 
 protected:
 
@@ -392,6 +496,14 @@ public:
     m_proto.write_msg(type, msg);
   }
 
+  // Operation which writes messages collected in the output buffer.
+
+  Op_snd(Protocol_impl &proto)
+    : Op_base(proto)
+  {
+    m_proto.wr_flush();
+  }
+
   bool do_cont()
   {
     if (!m_proto.wr_cont())
@@ -551,6 +663,18 @@ protected:
   virtual void process_msg(msg_type_t, Message&);
   virtual void do_process_msg(msg_type_t, Message&) {}
 
+  /*
+    Process raw message payload, before it is parsed. Specializations can
+    override this to decode selected message types directly from the wire
+    format, without building protobuf message object. If false is returned,
+    the payload is parsed and processed with process_msg() as usual.
+
+    Note: method should not report anything to the processor before it
+    decides to handle the message.
+  */
+
+  virtual bool process_raw(msg_type_t, bytes) { return false; }
+
   /**
     This method is called after processing each message to determine
     if operation should continue processing next message or stop.
@@ -153,6 +153,16 @@ protected:
     throw_error("Invalid processor used to process server reply");
   }
 
+  /*
+    Row messages are decoded directly from the receive buffer, without
+    creating protobuf objects (see process_raw()). Views of row fields
+    are collected in m_fields, which is re-used between rows.
+  */
+
+  std::vector<bytes> m_fields;
+
+  bool process_raw(msg_type_t, bytes);
+  void process_field(Row_processor&, col_count_t, bytes);
 };
 
 
@@ -575,28 +585,125 @@ void Rcv_result_base::process_msg_with(Mysqlx::Resultset::Row &row,
   for (RepeatedPtrField< ::std::string>::const_iterator it = row.field().begin();
         it != row.field().end(); ++it, ++ccount)
   {
+    process_field(rp, ccount, bytes(*it));
+  }
 
-    if (it->length() == 0)
-    {
-      rp.col_null(ccount);
-      continue;
-    }
+  rp.row_end(rcount);
+}
 
-    size_t read_window = rp.col_begin(ccount, it->length());
-    size_t pos= 0;
 
-    while (it->length() > pos && read_window)
-    {
-      size_t bytes_to_feed = it->length() - pos > read_window ? read_window : it->length() - pos;
-      size_t read_window_new = rp.col_data(ccount, bytes((byte*)(it->c_str() + pos), bytes_to_feed));
-      pos += read_window;
-      read_window = read_window_new;
-    }
+/*
+  Pass data of a single row field to the row processor. Empty field
+  represents NULL value.
+*/
+
+void Rcv_result_base::process_field(Row_processor &rp, col_count_t ccount,
+                                    bytes data)
+{
+  if (data.size() == 0)
+  {
+    rp.col_null(ccount);
+    return;
+  }
+
+  size_t read_window = rp.col_begin(ccount, data.size());
+  size_t pos= 0;
+
+  while (data.size() > pos && read_window)
+  {
+    size_t bytes_to_feed = data.size() - pos > read_window ? read_window : data.size() - pos;
+    size_t read_window_new = rp.col_data(ccount, bytes(data.begin() + pos, bytes_to_feed));
+    pos += read_window;
+    read_window = read_window_new;
+  }
+
+  rp.col_end(ccount, data.size());
+}
+
+
+/*
+  Fast path for Row messages.
+
+  Message Mysqlx.Resultset.Row has only one field: `repeated bytes field = 1`.
+  On the wire it is a sequence of entries, each consisting of a tag (varint
+  with value 0x0A: field number 1, length-delimited wire type), followed by
+  varint length and that many bytes of data. We decode this format directly
+  from the receive buffer and pass views of the data to the row processor.
+
+  If anything else is found in the payload (unknown fields, malformed data)
+  we return false and the message is processed by the generic code which
+  parses it with protobuf library first.
+*/
+
+static bool read_varint(const byte *&pos, const byte *end, uint64_t &val)
+{
+  val = 0;
 
-    rp.col_end(ccount, it->length());
+  for (unsigned shift = 0; shift < 64; shift += 7)
+  {
+    if (pos >= end)
+      return false;
+
+    byte b = *pos++;
+    val |= (uint64_t)(b & 0x7F) << shift;
+
+    if (!(b & 0x80))
+      return true;
+  }
+
+  return false;
+}
+
+
+bool Rcv_result_base::process_raw(msg_type_t type, bytes payload)
+{
+  static const uint64_t field_tag = (1 << 3) | 2;
+
+  if (ROWS != m_result_state || msg_type::Row != type)
+    return false;
+
+  /*
+    First scan the whole payload so that we can back-off to the generic
+    code before anything is reported to the processor.
+  */
+
+  m_fields.clear();
+
+  const byte *pos = payload.begin();
+  const byte *end = payload.end();
+
+  while (pos < end)
+  {
+    uint64_t tag, len;
+
+    if (!read_varint(pos, end, tag) || field_tag != tag)
+      return false;
+
+    if (!read_varint(pos, end, len) || len > (uint64_t)(end - pos))
+      return false;
+
+    m_fields.push_back(bytes(const_cast<byte*>(pos), (size_t)len));
+    pos += len;
+  }
+
+  assert(m_prc);
+  Row_processor &rp = *static_cast<Row_processor*>(m_prc);
+
+  row_count_t rcount= m_rcount++;
+
+  if (!rp.row_begin(rcount))
+    return true; // skip this row if the processor doesn't want it
+
+  col_count_t ccount = 0;
+
+  for (std::vector<bytes>::const_iterator it = m_fields.begin();
+       it != m_fields.end(); ++it, ++ccount)
+  {
+    process_field(rp, ccount, *it);
   }
 
   rp.row_end(rcount);
+  return true;
 }
 
 
@@ -122,6 +122,15 @@ Protocol::Op& Protocol::snd_AuthenticateContinue(bytes data)
   return get_impl().snd_start(auth_cont, msg_type::cli_AuthenticateContinue);
 }
 
+
+Protocol::Op& Protocol::snd_SessionReset(bool keep_open)
+{
+  Mysqlx::Session::Reset reset;
+  if (keep_open)
+    reset.set_keep_open(true);
+  return get_impl().snd_start(reset, msg_type::cli_SessionReset);
+}
+
 struct Expectation_builder : api::Expectations::Processor, api::Expectation_processor
 {
   Mysqlx::Expect::Open *m_msg;
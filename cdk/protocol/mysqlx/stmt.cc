@@ -39,6 +39,7 @@
 
 PUSH_PB_WARNINGS
 #include "protobuf/mysqlx_sql.pb.h"
+#include "protobuf/mysqlx_prepare.pb.h"
 POP_PB_WARNINGS
 
 
@@ -98,6 +99,72 @@ Protocol::Op& Protocol::snd_StmtExecute(const char *ns,
 }
 
 
+/*
+  Prepared SQL statement uses "?" placeholders whose values are given
+  when the statement is executed, so no arguments are stored inside
+  the StmtExecute message that is prepared.
+*/
+
+Protocol::Op& Protocol::snd_PrepareStmtExecute(uint32_t stmt_id,
+                                               const char *ns,
+                                               const string &stmt)
+{
+  Mysqlx::Prepare::Prepare prepare;
+  prepare.set_stmt_id(stmt_id);
+
+  Mysqlx::Prepare::Prepare_OneOfMessage *msg = prepare.mutable_stmt();
+  msg->set_type(Mysqlx::Prepare::Prepare_OneOfMessage_Type_STMT);
+
+  Mysqlx::Sql::StmtExecute *stmt_exec = msg->mutable_stmt_execute();
+
+  if (ns)
+    stmt_exec->set_namespace_(ns);
+
+  stmt_exec->set_stmt(stmt);
+
+  return get_impl().snd_start(prepare, msg_type::cli_PreparePrepare);
+}
+
+
+template<>
+struct Arr_msg_traits<Mysqlx::Prepare::Execute>
+{
+  typedef Mysqlx::Prepare::Execute Array;
+  typedef Mysqlx::Datatypes::Any   Msg;
+
+  static Msg& add_element(Array &arr)
+  {
+    return *arr.add_args();
+  }
+};
+
+
+Protocol::Op& Protocol::snd_PrepareExecute(uint32_t stmt_id,
+                                           const api::Any_list *args)
+{
+  Mysqlx::Prepare::Execute execute;
+  execute.set_stmt_id(stmt_id);
+
+  if (args)
+  {
+    Array_builder<Any_builder, Mysqlx::Prepare::Execute> args_builder;
+    args_builder.reset(execute);
+    args->process(args_builder);
+  }
+
+  return get_impl().snd_start(execute, msg_type::cli_PrepareExecute);
+}
+
+
+Protocol::Op& Protocol::snd_PrepareDeallocate(uint32_t stmt_id)
+{
+  Mysqlx::Prepare::Deallocate deallocate;
+  deallocate.set_stmt_id(stmt_id);
+
+  return get_impl().snd_start(deallocate, msg_type::cli_PrepareDeallocate);
+}
+
+
 Protocol::Op& Protocol_server::snd_StmtExecuteOk()
 {
   Mysqlx::Sql::StmtExecuteOk ok;
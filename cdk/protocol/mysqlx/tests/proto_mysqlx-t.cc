@@ -42,6 +42,10 @@
 #include <cdk_test.h>
 #include <gtest/gtest.h>
 
+#ifdef HAVE_COMPRESSION
+#include <zlib.h>
+#endif
+
 
 using namespace cdk;
 using namespace cdk::protocol::mysqlx;
@@ -106,3 +110,554 @@ TEST(Protocol_mysqlx, io_buffers)
   }
   CATCH_TEST_GENERIC;
 }
+
+
+/*
+  Several messages sent in a row are read from the stream in a single
+  read-ahead chunk and then decoded one by one from the buffer. Messages
+  larger than the initial read-ahead buffer must also be handled.
+*/
+
+TEST(Protocol_mysqlx, read_ahead)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    Protocol_server srv(*conn);
+
+    const size_t sizes[] = { 7, 200*1024, 0, 13, 1 };
+    const unsigned count = sizeof(sizes)/sizeof(size_t);
+
+    std::string buf(200*1024, 'x');
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+      bytes data((byte*)buf.data(), sizes[i]);
+      proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    }
+
+    struct : public Init_processor
+    {
+      size_t auth_size;
+
+      void auth_start(const char*, bytes data, bytes)
+      {
+        EXPECT_EQ(auth_size, data.size());
+      }
+
+      void auth_continue(bytes)
+      {}
+
+    } m_iproc;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+      cout <<"Reading message with " <<sizes[i] <<" bytes of auth data"
+           <<endl;
+      m_iproc.auth_size = sizes[i];
+      srv.rcv_InitMessage(m_iproc).wait();
+    }
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+/*
+  With batching enabled, messages are collected in the output buffer and
+  written to the stream together when flushed or when the limit is reached.
+*/
+
+TEST(Protocol_mysqlx, batching)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    Protocol_server srv(*conn);
+
+    struct : public Init_processor
+    {
+      size_t auth_size;
+
+      void auth_start(const char*, bytes data, bytes)
+      {
+        EXPECT_EQ(auth_size, data.size());
+      }
+
+      void auth_continue(bytes)
+      {}
+
+    } m_iproc;
+
+    std::string buf(2000, 'x');
+
+    proto.set_batching(true, 5000);
+
+    cout <<"Sending 2 messages" <<endl;
+
+    for (unsigned i = 0; i < 2; ++i)
+    {
+      bytes data((byte*)buf.data(), 100);
+      Protocol::Op &op = proto.snd_AuthenticateStart("test", data, bytes(""));
+      EXPECT_TRUE(op.cont());
+    }
+
+    EXPECT_FALSE(conn->has_bytes());
+
+    proto.flush().wait();
+    EXPECT_TRUE(conn->has_bytes());
+
+    m_iproc.auth_size = 100;
+    srv.rcv_InitMessage(m_iproc).wait();
+    srv.rcv_InitMessage(m_iproc).wait();
+    EXPECT_FALSE(conn->has_bytes());
+
+    cout <<"Sending messages until limit is reached" <<endl;
+
+    bytes data((byte*)buf.data(), buf.size());
+
+    proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    EXPECT_FALSE(conn->has_bytes());
+
+    proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    EXPECT_TRUE(conn->has_bytes());
+
+    m_iproc.auth_size = buf.size();
+    for (unsigned i = 0; i < 3; ++i)
+      srv.rcv_InitMessage(m_iproc).wait();
+
+    cout <<"Disabling batching" <<endl;
+
+    proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    EXPECT_FALSE(conn->has_bytes());
+
+    proto.set_batching(false);
+    EXPECT_TRUE(conn->has_bytes());
+
+    srv.rcv_InitMessage(m_iproc).wait();
+
+    proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    EXPECT_TRUE(conn->has_bytes());
+
+    srv.rcv_InitMessage(m_iproc).wait();
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+/*
+  Row messages are decoded directly from the wire format, without parsing
+  them into protobuf objects. Rows which contain fields other than the
+  column data must still be handled (by the generic protobuf code).
+*/
+
+template <class S>
+void write_frame(S &conn, msg_type_t type, const std::string &payload)
+{
+  uint32_t len = (uint32_t)payload.size() + 1;
+  byte hdr[5] = { byte(len), byte(len >> 8), byte(len >> 16), byte(len >> 24),
+                  byte(type) };
+  typename S::Write_op(conn, buffers(hdr, sizeof(hdr))).wait();
+  if (!payload.empty())
+    typename S::Write_op(conn, bytes(payload)).wait();
+}
+
+
+TEST(Protocol_mysqlx, rows)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+
+    // Column meta-data with type BYTES (field 1 = 7).
+
+    const std::string mdata("\x08\x07", 2);
+
+    write_frame(*conn, msg_type::ColumnMetaData, mdata);
+    write_frame(*conn, msg_type::ColumnMetaData, mdata);
+
+    // Row: "abc", NULL
+
+    write_frame(*conn, msg_type::Row,
+                std::string("\x0A\x03" "abc" "\x0A\x00", 7));
+
+    // Row: "x", "y" with unknown field 2 between them
+
+    write_frame(*conn, msg_type::Row,
+                std::string("\x0A\x01" "x" "\x10\x05" "\x0A\x01" "y", 8));
+
+    // Row: large value, NULL
+
+    std::string big(1000, 'z');
+    write_frame(*conn, msg_type::Row,
+                std::string("\x0A\xE8\x07", 3) + big
+                + std::string("\x0A\x00", 2));
+
+    write_frame(*conn, msg_type::FetchDone, "");
+    write_frame(*conn, msg_type::StmtExecuteOk, "");
+
+    struct : public protocol::mysqlx::Mdata_processor
+    {
+      col_count_t m_cols;
+      void col_type(col_count_t pos, unsigned short type)
+      {
+        EXPECT_EQ(7U, type);
+        m_cols = pos + 1;
+      }
+    } mdp;
+
+    mdp.m_cols = 0;
+    proto.rcv_MetaData(mdp).wait();
+    EXPECT_EQ(2U, mdp.m_cols);
+
+    struct : public protocol::mysqlx::Row_processor
+    {
+      std::vector<std::string> m_data;
+      bool m_done;
+
+      bool row_begin(row_count_t) { return true; }
+
+      void col_null(col_count_t)
+      { m_data.push_back("<null>"); }
+
+      size_t col_begin(col_count_t, size_t)
+      {
+        m_data.push_back(std::string());
+        return 100;
+      }
+
+      size_t col_data(col_count_t, bytes data)
+      {
+        m_data.back().append((const char*)data.begin(), data.size());
+        return 100;
+      }
+
+      void done(bool, bool) { m_done = true; }
+
+    } rp;
+
+    rp.m_done = false;
+    proto.rcv_Rows(rp).wait();
+
+    EXPECT_TRUE(rp.m_done);
+    ASSERT_EQ(6U, rp.m_data.size());
+    EXPECT_EQ("abc", rp.m_data[0]);
+    EXPECT_EQ("<null>", rp.m_data[1]);
+    EXPECT_EQ("x", rp.m_data[2]);
+    EXPECT_EQ("y", rp.m_data[3]);
+    EXPECT_EQ(big, rp.m_data[4]);
+    EXPECT_EQ("<null>", rp.m_data[5]);
+
+    struct : public protocol::mysqlx::Stmt_processor
+    {} sp;
+
+    proto.rcv_StmtReply(sp).wait();
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+#ifdef HAVE_COMPRESSION
+
+/*
+  With compression enabled on both ends, output above the threshold is
+  sent in compressed frames and must be delivered intact to the other side.
+  Output below the threshold is sent as it is.
+*/
+
+TEST(Protocol_mysqlx, compression)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    Protocol_server srv(*conn);
+
+    proto.set_compression(compression_type::DEFLATE, 100);
+    srv.set_compression(compression_type::DEFLATE, 100);
+
+    const size_t sizes[] = { 7, 200*1024, 0, 1000, 13 };
+    const unsigned count = sizeof(sizes)/sizeof(size_t);
+
+    std::string buf(200*1024, 'x');
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+      bytes data((byte*)buf.data(), sizes[i]);
+      proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    }
+
+    struct : public Init_processor
+    {
+      size_t auth_size;
+
+      void auth_start(const char*, bytes data, bytes)
+      {
+        EXPECT_EQ(auth_size, data.size());
+      }
+
+      void auth_continue(bytes)
+      {}
+
+    } m_iproc;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+      cout <<"Reading message with " <<sizes[i] <<" bytes of auth data"
+           <<endl;
+      m_iproc.auth_size = sizes[i];
+      srv.rcv_InitMessage(m_iproc).wait();
+    }
+
+    // Other direction.
+
+    std::string msg(5000, 'y');
+
+    srv.snd_Ok("short").wait();
+    srv.snd_Ok(msg).wait();
+
+    struct : public Reply_processor
+    {
+      std::string m_msg;
+
+      void ok(string msg)
+      {
+        m_msg = msg;
+      }
+    } rp;
+
+    proto.rcv_Reply(rp).wait();
+    EXPECT_EQ("short", rp.m_msg);
+    proto.rcv_Reply(rp).wait();
+    EXPECT_EQ(msg, rp.m_msg);
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+/*
+  Server can combine several messages of different types in a single
+  compressed frame. Such frame must be split into individual messages
+  which are then processed as usual.
+*/
+
+TEST(Protocol_mysqlx, compression_combined)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    proto.set_compression(compression_type::DEFLATE);
+
+    // Frames to be compressed: meta-data, 3 rows and end of result set.
+
+    std::string frames;
+
+    auto add_frame = [&frames](msg_type_t type, const std::string &payload)
+    {
+      uint32_t len = (uint32_t)payload.size() + 1;
+      byte hdr[5] = { byte(len), byte(len >> 8), byte(len >> 16),
+                      byte(len >> 24), byte(type) };
+      frames.append((const char*)hdr, sizeof(hdr));
+      frames.append(payload);
+    };
+
+    add_frame(msg_type::ColumnMetaData, std::string("\x08\x07", 2));
+    add_frame(msg_type::Row, std::string("\x0A\x03" "abc", 5));
+    add_frame(msg_type::Row, std::string("\x0A\x01" "x", 3));
+    add_frame(msg_type::Row, std::string("\x0A\x00", 2));
+    add_frame(msg_type::FetchDone, "");
+    add_frame(msg_type::StmtExecuteOk, "");
+
+    // Compress them into deflate stream ending with a sync flush point.
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    ASSERT_EQ(Z_OK, deflateInit(&zs, Z_DEFAULT_COMPRESSION));
+
+    std::string data(deflateBound(&zs, (uLong)frames.size()) + 16, '\0');
+
+    zs.next_in = (Bytef*)frames.data();
+    zs.avail_in = (uInt)frames.size();
+    zs.next_out = (Bytef*)&data[0];
+    zs.avail_out = (uInt)data.size();
+
+    ASSERT_EQ(Z_OK, deflate(&zs, Z_SYNC_FLUSH));
+    data.resize(data.size() - zs.avail_out);
+    deflateEnd(&zs);
+
+    /*
+      Mysqlx.Connection.Compression message with uncompressed_size (field 1)
+      and payload (field 4). Sizes are below 128 so that single byte varints
+      can be used.
+    */
+
+    ASSERT_LT(frames.size(), 128U);
+    ASSERT_LT(data.size(), 128U);
+
+    std::string compressed;
+    compressed.push_back('\x08');
+    compressed.push_back((char)frames.size());
+    compressed.push_back('\x22');
+    compressed.push_back((char)data.size());
+    compressed.append(data);
+
+    write_frame(*conn, ServerMessages_Type_COMPRESSION, compressed);
+
+    struct : public protocol::mysqlx::Mdata_processor
+    {
+      col_count_t m_cols;
+      void col_type(col_count_t pos, unsigned short)
+      {
+        m_cols = pos + 1;
+      }
+    } mdp;
+
+    mdp.m_cols = 0;
+    proto.rcv_MetaData(mdp).wait();
+    EXPECT_EQ(1U, mdp.m_cols);
+
+    struct : public protocol::mysqlx::Row_processor
+    {
+      std::vector<std::string> m_data;
+
+      bool row_begin(row_count_t) { return true; }
+
+      void col_null(col_count_t)
+      { m_data.push_back("<null>"); }
+
+      size_t col_begin(col_count_t, size_t)
+      {
+        m_data.push_back(std::string());
+        return 100;
+      }
+
+      size_t col_data(col_count_t, bytes data)
+      {
+        m_data.back().append((const char*)data.begin(), data.size());
+        return 100;
+      }
+
+    } rp;
+
+    proto.rcv_Rows(rp).wait();
+
+    ASSERT_EQ(3U, rp.m_data.size());
+    EXPECT_EQ("abc", rp.m_data[0]);
+    EXPECT_EQ("x", rp.m_data[1]);
+    EXPECT_EQ("<null>", rp.m_data[2]);
+
+    struct : public protocol::mysqlx::Stmt_processor
+    {} sp;
+
+    proto.rcv_StmtReply(sp).wait();
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+/*
+  With batching, all messages collected in the output buffer are sent in
+  a single compressed frame, even if each of them is below the compression
+  threshold. Messages of different types can be combined in one frame.
+*/
+
+TEST(Protocol_mysqlx, compression_batch)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    Protocol_server srv(*conn);
+
+    proto.set_compression(compression_type::DEFLATE, 500);
+    srv.set_compression(compression_type::DEFLATE, 500);
+
+    proto.set_batching(true, 16*1024);
+
+    struct : public Init_processor
+    {
+      unsigned m_start = 0;
+      unsigned m_cont = 0;
+
+      void auth_start(const char*, bytes data, bytes)
+      {
+        EXPECT_EQ(50U, data.size());
+        m_start++;
+      }
+
+      void auth_continue(bytes data)
+      {
+        EXPECT_EQ(10U, data.size());
+        m_cont++;
+      }
+
+    } m_iproc;
+
+    std::string buf(50, 'x');
+    bytes data((byte*)buf.data(), buf.size());
+
+    for (unsigned i = 0; i < 20; ++i)
+    {
+      proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+      proto.snd_AuthenticateContinue(bytes((byte*)buf.data(), 10)).wait();
+    }
+
+    EXPECT_FALSE(conn->has_bytes());
+
+    proto.flush().wait();
+    EXPECT_TRUE(conn->has_bytes());
+
+    for (unsigned i = 0; i < 40; ++i)
+      srv.rcv_InitMessage(m_iproc).wait();
+
+    EXPECT_EQ(20U, m_iproc.m_start);
+    EXPECT_EQ(20U, m_iproc.m_cont);
+    EXPECT_FALSE(conn->has_bytes());
+
+    // Output below the threshold is not compressed.
+
+    proto.snd_AuthenticateStart("test", data, bytes("")).wait();
+    proto.flush().wait();
+
+    m_iproc.m_start = 0;
+    srv.rcv_InitMessage(m_iproc).wait();
+    EXPECT_EQ(1U, m_iproc.m_start);
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+#endif
@@ -472,5 +472,79 @@ TEST(Protocol_mysqlx_msg, insert)
   CATCH_TEST_GENERIC;
 }
 
+/*
+  Insert with size limit: only rows which fit into the limit are sent and the
+  row source is not moved past the last one of them, so that remaining rows
+  can be sent with the next Insert.
+*/
+
+TEST(Protocol_mysqlx_msg, insert_max_size)
+{
+  struct Rows
+    : public protocol::mysqlx::Row_source
+  {
+    std::string m_data;
+    unsigned m_count;
+    unsigned m_pos;
+
+    Rows() : m_data(1000, 'x'), m_count(10), m_pos(0)
+    {}
+
+    bool next()
+    {
+      if (m_pos == m_count)
+        return false;
+      m_pos++;
+      return true;
+    }
+
+    void process(Processor &prc) const
+    {
+      prc.list_begin();
+      safe_prc(prc)->list_el()->scalar()->val()->str(bytes(m_data));
+      prc.list_end();
+    }
+  }
+  rows;
+
+  struct : public Msg_processor
+  {
+    int m_rows;
+
+    void process_msg(msg_type_t type, Message &msg)
+    {
+      EXPECT_EQ(msg_type::cli_CrudInsert, type);
+      m_rows = static_cast<Mysqlx::Crud::Insert&>(msg).row_size();
+    }
+  }
+  checker;
+
+  TRY_TEST_GENERIC
+  {
+    Test_server<32*1024> srv;
+    Protocol proto(srv.get_connection());
+
+    Db_obj obj("schema", "name");
+
+    // Each row takes a bit more than 1000 bytes.
+
+    int expected[] = { 3, 3, 3, 1 };
+
+    for (int count : expected)
+    {
+      cout <<"== Sending Insert message" <<endl;
+      proto.snd_Insert(TABLE, obj, NULL, rows, NULL, false, 2500).wait();
+      srv.rcv_msg(checker);
+      cout <<"== Rows sent: " <<checker.m_rows <<endl;
+      EXPECT_EQ(count, checker.m_rows);
+    }
+
+    EXPECT_EQ(rows.m_count, rows.m_pos);
+
+    cout <<"== Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
 }}  // cdk::test
 
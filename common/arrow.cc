@@ -0,0 +1,688 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <mysqlx/common/arrow.h>
+#include "result.h"
+
+#include <limits>
+
+/*
+  Export of row data in Arrow C Data Interface format (see result.h).
+*/
+
+using namespace ::mysqlx::common;
+using Rows = std::vector<Row_data>;
+
+
+namespace {
+
+/*
+  DECIMAL columns are exported as Arrow decimal128 values if their precision
+  (given by column length) is at most 38 digits. Otherwise they are exported
+  as doubles.
+*/
+
+const unsigned long decimal128_digits = 38;
+
+bool is_decimal128(const Meta_data_base &md, cdk::col_count_t col)
+{
+  return 0 < md.get_length(col) && md.get_length(col) <= decimal128_digits;
+}
+
+
+/*
+  Arrow format string for values of a given column.
+*/
+
+std::string arrow_format(const Meta_data_base &md, cdk::col_count_t col)
+{
+  const Format_info &fi = md.get_format(col);
+
+  switch (fi.m_type)
+  {
+  case cdk::TYPE_INTEGER:
+    return fi.get<cdk::TYPE_INTEGER>().m_format.is_unsigned() ? "L" : "l";
+
+  case cdk::TYPE_FLOAT:
+  {
+    auto &fmt = fi.get<cdk::TYPE_FLOAT>().m_format;
+
+    if (fmt.FLOAT == fmt.type())
+      return "f";
+
+    if (fmt.DECIMAL == fmt.type() && is_decimal128(md, col))
+      return "d:" + std::to_string(md.get_length(col))
+             + "," + std::to_string(md.get_decimals(col));
+
+    return "g";
+  }
+
+  case cdk::TYPE_STRING:
+  case cdk::TYPE_DOCUMENT:
+    return "u";
+
+  case cdk::TYPE_DATETIME:
+  {
+    auto &fmt = fi.get<cdk::TYPE_DATETIME>().m_format;
+
+    if (fmt.TIME == fmt.type())
+      return "tDu";
+
+    return fmt.has_time() ? "tsu:" : "tdD";
+  }
+
+  case cdk::TYPE_BYTES:
+    return fi.get<cdk::TYPE_BYTES>().m_format.is_bit() ? "L" : "z";
+
+  default:
+    return "z";
+  }
+}
+
+
+/*
+  Schema export
+  -------------
+  Data of an exported ArrowSchema is owned by Schema_data instance pointed
+  by its private_data member.
+*/
+
+struct Schema_data
+{
+  std::string  m_format;
+  std::string  m_name;
+  std::vector<ArrowSchema>  m_children;
+  std::vector<ArrowSchema*> m_child_ptrs;
+
+  ~Schema_data()
+  {
+    for (ArrowSchema &child : m_children)
+      if (child.release)
+        child.release(&child);
+  }
+};
+
+
+void release_schema(ArrowSchema *schema)
+{
+  delete static_cast<Schema_data*>(schema->private_data);
+  schema->release = nullptr;
+}
+
+
+void init_schema(ArrowSchema *out, Schema_data *data, int64_t flags)
+{
+  for (ArrowSchema &child : data->m_children)
+    data->m_child_ptrs.push_back(&child);
+
+  out->format = data->m_format.c_str();
+  out->name = data->m_name.c_str();
+  out->metadata = nullptr;
+  out->flags = flags;
+  out->n_children = (int64_t)data->m_children.size();
+  out->children = data->m_child_ptrs.empty() ? nullptr
+                                             : data->m_child_ptrs.data();
+  out->dictionary = nullptr;
+  out->release = release_schema;
+  out->private_data = data;
+}
+
+
+/*
+  Array export
+  ------------
+  Similar as for schema, data of an exported ArrowArray is owned by
+  Array_data instance.
+*/
+
+struct Array_data
+{
+  std::vector<uint8_t>  m_validity;
+  std::vector<int32_t>  m_offsets;
+  std::vector<uint64_t> m_values;  // values of fixed width, 8-byte aligned
+  std::string           m_bytes;   // data of variable length values
+  const void*           m_buffers[3];
+  int64_t               m_null_count = 0;
+
+  std::vector<ArrowArray>  m_children;
+  std::vector<ArrowArray*> m_child_ptrs;
+
+  ~Array_data()
+  {
+    for (ArrowArray &child : m_children)
+      if (child.release)
+        child.release(&child);
+  }
+};
+
+
+void release_array(ArrowArray *array)
+{
+  delete static_cast<Array_data*>(array->private_data);
+  array->release = nullptr;
+}
+
+
+void init_array(ArrowArray *out, Array_data *data, int64_t length,
+                int64_t n_buffers)
+{
+  for (ArrowArray &child : data->m_children)
+    data->m_child_ptrs.push_back(&child);
+
+  out->length = length;
+  out->null_count = data->m_null_count;
+  out->offset = 0;
+  out->n_buffers = n_buffers;
+  out->n_children = (int64_t)data->m_children.size();
+  out->buffers = data->m_buffers;
+  out->children = data->m_child_ptrs.empty() ? nullptr
+                                             : data->m_child_ptrs.data();
+  out->dictionary = nullptr;
+  out->release = release_array;
+  out->private_data = data;
+}
+
+
+/*
+  Column decoders
+  ---------------
+  Each decoder processes one column of a batch of rows and stores its
+  values in Arrow buffers. The type of the column is looked at only once,
+  when selecting a decoder, not for each value.
+*/
+
+inline
+bool is_null(const Row_data &row, cdk::col_count_t col)
+{
+  return row.is_null(col) || 0 == row.at(col).size();
+}
+
+
+/*
+  Build validity bitmap for the column. It is not needed if there are no
+  null values.
+*/
+
+void decode_validity(const Rows &rows, cdk::col_count_t col, Array_data &out)
+{
+  out.m_null_count = 0;
+  out.m_buffers[0] = nullptr;
+
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    if (!is_null(rows[i], col))
+      continue;
+
+    if (out.m_validity.empty())
+      out.m_validity.assign((rows.size() + 7) / 8, 0xFF);
+
+    out.m_validity[i / 8] &= (uint8_t)~(1U << (i % 8));
+    out.m_null_count++;
+  }
+
+  if (0 < out.m_null_count)
+    out.m_buffers[0] = out.m_validity.data();
+}
+
+
+/*
+  Decode column of fixed width values of type T. Function object `decode`
+  converts raw bytes of a single non-null value.
+*/
+
+template <typename T, class DECODE>
+void decode_fixed(const Rows &rows, cdk::col_count_t col, Array_data &out,
+                  DECODE decode)
+{
+  out.m_values.assign((rows.size() * sizeof(T) + 7) / 8, 0);
+  T *values = reinterpret_cast<T*>(out.m_values.data());
+
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    if (is_null(rows[i], col))
+      continue;
+    values[i] = decode(rows[i].at(col));
+  }
+
+  out.m_buffers[1] = values;
+}
+
+
+/*
+  Decode column of integer values. Raw bytes of all values are collected
+  first and then decoded by the codec in a single batch.
+*/
+
+template <typename T>
+void decode_int(const Rows &rows, cdk::col_count_t col, Array_data &out,
+                cdk::Codec<cdk::TYPE_INTEGER> &codec)
+{
+  std::vector<cdk::bytes> data;
+  data.reserve(rows.size());
+
+  for (const Row_data &row : rows)
+  {
+    if (is_null(row, col))
+      data.emplace_back((cdk::byte*)nullptr, (size_t)0);
+    else
+      data.push_back(row.at(col));
+  }
+
+  out.m_values.resize(rows.size());
+  T *values = reinterpret_cast<T*>(out.m_values.data());
+
+  codec.from_bytes(data.data(), data.size(), values);
+  out.m_buffers[1] = values;
+}
+
+
+/*
+  Decode column of variable length values. Function object `append`
+  appends bytes of a single non-null value to the given string.
+*/
+
+template <class APPEND>
+void decode_var(const Rows &rows, cdk::col_count_t col, Array_data &out,
+                APPEND append)
+{
+  out.m_offsets.resize(rows.size() + 1);
+  out.m_offsets[0] = 0;
+
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    if (!is_null(rows[i], col))
+      append(rows[i].at(col), out.m_bytes);
+
+    if (out.m_bytes.size() > (size_t)std::numeric_limits<int32_t>::max())
+      throw_error("Arrow export: too much data in a batch");
+
+    out.m_offsets[i + 1] = (int32_t)out.m_bytes.size();
+  }
+
+  out.m_buffers[1] = out.m_offsets.data();
+  out.m_buffers[2] = out.m_bytes.data();
+}
+
+
+/*
+  Append bytes of an octets value without the trailing '\0' byte which is
+  used for null value detection (see convert()). Note that values of other
+  types, such as DATETIME, BIT or SET, are encoded differently and do not
+  have this extra byte.
+*/
+
+void append_raw(cdk::bytes data, std::string &out)
+{
+  out.append((const char*)data.begin(), data.size() - 1);
+}
+
+
+/*
+  Append elements of a SET value as a comma separated list. A SET value is
+  a sequence of length prefixed elements, where a single 0x01 byte denotes
+  the empty set. Function object `append_elem` appends bytes of a single
+  element.
+*/
+
+template <class APPEND>
+void append_set(cdk::bytes data, std::string &out, APPEND append_elem)
+{
+  if (1 == data.size() && 0x01 == *data.begin())
+    return;
+
+  const cdk::byte *pos = data.begin();
+  bool first = true;
+
+  while (pos < data.end())
+  {
+    uint64_t len;
+    size_t len_size = cdk::foundation::varint::decode(
+      cdk::bytes(const_cast<cdk::byte*>(pos), data.end()), len
+    );
+
+    if (0 == len_size || len > (uint64_t)(data.end() - pos - len_size))
+      throw_error("Arrow export: invalid SET value");
+
+    pos += len_size;
+
+    if (!first)
+      out.push_back(',');
+    first = false;
+
+    append_elem(cdk::bytes(const_cast<cdk::byte*>(pos), (size_t)len), out);
+    pos += len;
+  }
+}
+
+
+/*
+  Decode components of a DATETIME or TIME value which are stored as a
+  sequence of varints. Trailing components can be omitted if they are 0.
+*/
+
+void decode_varints(cdk::bytes data, uint64_t *vals, unsigned count)
+{
+  const cdk::byte *pos = data.begin();
+
+  for (unsigned i = 0; i < count; ++i)
+  {
+    vals[i] = 0;
+
+    if (pos == data.end())
+      continue;
+
+    size_t len = cdk::foundation::varint::decode(
+      cdk::bytes(const_cast<cdk::byte*>(pos), data.end()), vals[i]
+    );
+
+    if (0 == len)
+      throw_error("Arrow export: invalid temporal value");
+
+    pos += len;
+  }
+}
+
+
+/*
+  Number of days from 1970-01-01 to the given date of the proleptic
+  Gregorian calendar.
+*/
+
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+  y -= m <= 2;
+  int64_t  era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned)(y - era * 400);
+  unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int64_t)doe - 719468;
+}
+
+
+int64_t time_usec(uint64_t h, uint64_t m, uint64_t s, uint64_t us)
+{
+  return (int64_t)(((h * 60 + m) * 60 + s) * 1000000 + us);
+}
+
+
+/*
+  Arrow decimal128 value: 128-bit two's complement integer, stored in
+  native byte order (which we assume to be little-endian).
+*/
+
+struct Decimal128
+{
+  uint64_t m_low;
+  uint64_t m_high;
+};
+
+
+void decode_temporal(
+  const Format_descr<cdk::TYPE_DATETIME> &fd, const Rows &rows,
+  cdk::col_count_t col, Array_data &out
+)
+{
+  auto &fmt = fd.m_format;
+
+  // TIME: negate byte followed by hours, minutes, seconds and microseconds.
+
+  if (fmt.TIME == fmt.type())
+  {
+    decode_fixed<int64_t>(rows, col, out, [](cdk::bytes data) {
+      uint64_t v[4];
+      decode_varints(
+        cdk::bytes(data.begin() + 1, data.end()), v, 4
+      );
+      int64_t val = time_usec(v[0], v[1], v[2], v[3]);
+      return 0 != *data.begin() ? -val : val;
+    });
+    return;
+  }
+
+  // DATETIME: year, month, day, hours, minutes, seconds and microseconds.
+
+  if (!fmt.has_time())
+  {
+    decode_fixed<int32_t>(rows, col, out, [](cdk::bytes data) {
+      uint64_t v[3];
+      decode_varints(data, v, 3);
+      return (int32_t)days_from_civil((int64_t)v[0], (unsigned)v[1],
+                                      (unsigned)v[2]);
+    });
+    return;
+  }
+
+  decode_fixed<int64_t>(rows, col, out, [](cdk::bytes data) {
+    uint64_t v[7];
+    decode_varints(data, v, 7);
+    int64_t days = days_from_civil((int64_t)v[0], (unsigned)v[1],
+                                   (unsigned)v[2]);
+    return days * 86400 * 1000000 + time_usec(v[3], v[4], v[5], v[6]);
+  });
+}
+
+
+void decode_decimal(
+  Format_descr<cdk::TYPE_FLOAT> &fd, unsigned scale, const Rows &rows,
+  cdk::col_count_t col, Array_data &out
+)
+{
+  decode_fixed<Decimal128>(rows, col, out, [&fd, scale](cdk::bytes data) {
+    cdk::Codec<cdk::TYPE_FLOAT>::Decimal val;
+
+    if (!fd.m_codec.from_bytes(data, val) || !val.set_scale(scale)
+        || (val.m_high >> 63))
+      throw_error("Arrow export: DECIMAL value out of range");
+
+    Decimal128 res = { val.m_low, val.m_high };
+
+    if (val.m_negative)
+    {
+      res.m_low = ~res.m_low + 1;
+      res.m_high = ~res.m_high + (0 == res.m_low ? 1 : 0);
+    }
+
+    return res;
+  });
+}
+
+
+void decode_column(
+  const Meta_data_base &md, const Rows &rows, cdk::col_count_t col,
+  Array_data &out
+)
+{
+  const Format_info &fi = md.get_format(col);
+
+  decode_validity(rows, col, out);
+
+  switch (fi.m_type)
+  {
+  case cdk::TYPE_INTEGER:
+  {
+    auto &fd = fi.get<cdk::TYPE_INTEGER>();
+
+    if (fd.m_format.is_unsigned())
+      decode_int<uint64_t>(rows, col, out, fd.m_codec);
+    else
+      decode_int<int64_t>(rows, col, out, fd.m_codec);
+    return;
+  }
+
+  case cdk::TYPE_FLOAT:
+  {
+    auto &fd = fi.get<cdk::TYPE_FLOAT>();
+
+    if (fd.m_format.FLOAT == fd.m_format.type())
+      decode_fixed<float>(rows, col, out, [&fd](cdk::bytes data) {
+        float val;
+        fd.m_codec.from_bytes(data, val);
+        return val;
+      });
+    else if (fd.m_format.DECIMAL == fd.m_format.type()
+             && is_decimal128(md, col))
+      decode_decimal(fd, md.get_decimals(col), rows, col, out);
+    else
+      decode_fixed<double>(rows, col, out, [&fd](cdk::bytes data) {
+        double val;
+        fd.m_codec.from_bytes(data, val);
+        return val;
+      });
+    return;
+  }
+
+  case cdk::TYPE_STRING:
+  {
+    auto &fd = fi.get<cdk::TYPE_STRING>();
+
+    auto append_str = [&fd](cdk::bytes data, std::string &buf) {
+      if (is_utf8(fd.m_format))
+      {
+        buf.append((const char*)data.begin(), data.size());
+        return;
+      }
+      cdk::string str;
+      fd.m_codec.from_bytes(data, str);
+      buf.append(std::string(str));
+    };
+
+    if (fd.m_format.is_set())
+    {
+      decode_var(rows, col, out,
+        [&append_str](cdk::bytes data, std::string &buf) {
+          append_set(data, buf, append_str);
+        });
+      return;
+    }
+
+    if (is_utf8(fd.m_format))
+    {
+      decode_var(rows, col, out, append_raw);
+      return;
+    }
+
+    decode_var(rows, col, out,
+      [&append_str](cdk::bytes data, std::string &buf) {
+        append_str(cdk::bytes(data.begin(), data.end() - 1), buf);
+      });
+    return;
+  }
+
+  case cdk::TYPE_DATETIME:
+    decode_temporal(fi.get<cdk::TYPE_DATETIME>(), rows, col, out);
+    return;
+
+  case cdk::TYPE_BYTES:
+    if (fi.get<cdk::TYPE_BYTES>().m_format.is_bit())
+    {
+      decode_fixed<uint64_t>(rows, col, out, [](cdk::bytes data) {
+        uint64_t val;
+        if (0 == cdk::foundation::varint::decode(data, val))
+          throw_error("Arrow export: invalid BIT value");
+        return val;
+      });
+      return;
+    }
+    decode_var(rows, col, out, append_raw);
+    return;
+
+  default:
+    // Documents are sent as UTF8 JSON strings, other values as raw bytes.
+    decode_var(rows, col, out, append_raw);
+    return;
+  }
+}
+
+}  // namespace
+
+
+void mysqlx::common::export_arrow_schema(
+  const Meta_data_base &md, const std::vector<std::string> &names,
+  ArrowSchema *out
+)
+{
+  std::unique_ptr<Schema_data> data(new Schema_data());
+  data->m_format = "+s";
+
+  cdk::col_count_t col_count = md.col_count();
+  data->m_children.resize(col_count);
+
+  for (ArrowSchema &child : data->m_children)
+    child.release = nullptr;
+
+  for (cdk::col_count_t col = 0; col < col_count; ++col)
+  {
+    std::unique_ptr<Schema_data> child(new Schema_data());
+    child->m_format = arrow_format(md, col);
+    if (col < names.size())
+      child->m_name = names[col];
+    init_schema(&data->m_children[col], child.release(), ARROW_FLAG_NULLABLE);
+  }
+
+  init_schema(out, data.release(), 0);
+}
+
+
+row_count_t mysqlx::common::export_arrow_batch(
+  Result_impl_base &res, row_count_t max_rows, ArrowArray *out
+)
+{
+  out->release = nullptr;
+
+  Rows rows;
+
+  if (0 == res.get_rows(rows, max_rows))
+    return 0;
+
+  const Meta_data_base &md = *res.get_mdata();
+  cdk::col_count_t col_count = md.col_count();
+  int64_t length = (int64_t)rows.size();
+
+  std::unique_ptr<Array_data> data(new Array_data());
+  data->m_buffers[0] = nullptr;
+  data->m_children.resize(col_count);
+
+  for (ArrowArray &child : data->m_children)
+    child.release = nullptr;
+
+  for (cdk::col_count_t col = 0; col < col_count; ++col)
+  {
+    std::unique_ptr<Array_data> child(new Array_data());
+
+    decode_column(md, rows, col, *child);
+
+    std::string format = arrow_format(md, col);
+    int64_t n_buffers = ("u" == format || "z" == format) ? 3 : 2;
+    init_array(&data->m_children[col], child.release(), length, n_buffers);
+  }
+
+  init_array(out, data.release(), length, 1);
+  return (row_count_t)length;
+}
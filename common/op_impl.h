@@ -34,6 +34,7 @@
 #include <mysql/cdk.h>
 #include <mysqlx/common.h>
 #include <mysqlx/common/op_if.h>
+#include <json_parser.h>
 #include "session.h"
 #include "result.h"
 #include "db_object.h"
@@ -76,6 +77,15 @@ enum class Object_type
      receive server reply and then returns Result_base instance created
      from the cdk::Reply object.
 
+  Operations which can be prepared on the server override `send_prepare`
+  and `send_prepared_execute` methods. When such operation is executed for
+  the second time without being modified in between (only parameter values
+  can change), it is prepared on the server and then this and subsequent
+  executions only send values of parameters, which saves the server from
+  parsing and planning the statement each time. Derived classes call
+  `reset_prepare` whenever definition of the operation is modified. If the
+  statement can not be prepared, it is executed directly as before.
+
   The Op_base template is parametrized by the implementation interface
   `IF` that derived class wants to implement (see executable.h for interface
   definitions). The Op_base template implements some of the interface methods,
@@ -100,9 +110,44 @@ protected:
   */
   cdk::scoped_ptr<cdk::Reply> m_reply;
 
+  /*
+    Replies to earlier chunks of an operation which was split into several
+    commands (see add_chunk()), and information collected from the ones
+    already processed.
+  */
+
+  std::list<std::unique_ptr<cdk::Reply>> m_chunks;
+  Chunk_stats m_chunk_stats;
+
   bool m_inited = false;
   bool m_completed = false;
 
+  /*
+    Row prefetch size for results of this operation, if set with
+    set_prefetch_size(). Otherwise session default is used.
+  */
+
+  bool     m_has_prefetch_size = false;
+  unsigned m_prefetch_size = 0;
+
+  /*
+    Prepared statement state: number of executions since the operation was
+    last modified, id of the prepared statement (0 if not prepared) and
+    whether preparing should be attempted.
+  */
+
+  unsigned m_exec_count = 0;
+  uint32_t m_stmt_id = 0;
+  bool     m_can_prepare = true;
+
+  /*
+    Reply to the prepare request sent by prepare() together with the first
+    execute request of the prepared statement. It is checked before reading
+    reply to the execute request (see check_prepare()).
+  */
+
+  std::unique_ptr<cdk::Reply> m_prepare_reply;
+
 public:
 
   Op_base(const Shared_session_impl &sess)
@@ -118,10 +163,15 @@ public:
 
   Op_base(const Op_base& other)
     : m_sess(other.m_sess)
+    , m_has_prefetch_size(other.m_has_prefetch_size)
+    , m_prefetch_size(other.m_prefetch_size)
   {}
 
   virtual ~Op_base()
-  {}
+  {
+    if (m_stmt_id && m_sess)
+      m_sess->release_stmt_id(m_stmt_id);
+  }
 
   cdk::Session& get_cdk_session()
   {
@@ -147,17 +197,26 @@ public:
 
     /*
       Prepare session for sending a new command. This gives session a chance
-      to do necessary cleanups, such as consuming pending reply to a previous
-      command.
-
-      TODO: It should be possible to send next command while previous results
-      are still being consumed (rd/wr split). But this requires changes in CDK.
-      At present calling send_command(), which creates a new CDK reply object,
-      discards a previous reply (if any) and this confuses the overall result
-      processing logic.
+      to do necessary cleanups. Note that the command is sent even if results
+      of previous commands are still being consumed -- they are cached only
+      when we start reading reply to this command (see prepare_for_reply()).
     */
 
     m_sess->prepare_for_cmd();
+    m_chunk_stats.clear();
+
+    if (m_stmt_id)
+    {
+      m_reply.reset(send_prepared_execute(m_stmt_id));
+      return;
+    }
+
+    if (0 < m_exec_count++ && prepare())
+    {
+      m_reply.reset(send_prepared_execute(m_stmt_id));
+      return;
+    }
+
     m_reply.reset(send_command());
   }
 
@@ -167,42 +226,115 @@ public:
       return true;
 
     init();
-    m_completed = (!m_reply) || m_reply->is_completed();
+    m_completed = m_chunks.empty() && !m_prepare_reply
+                  && ((!m_reply) || m_reply->is_completed());
     return m_completed;
   }
 
 
   /*
     Drive statement execution operation. First call init() to initialize it
-    if it was not done before. Then wait for the reply object to become ready.
+    if it was not done before. Then push forward processing of the reply
+    without blocking. Returns true when the reply is ready.
+
+    Before the reply can be read, results of earlier commands that were not
+    consumed yet must be cached. This is also done without blocking (see
+    Session_impl::prepare_for_reply_cont()).
+
+    Note: Hooks execute_prepare() and execute_cleanup() are called before
+    sending the command and after the reply is ready, as in synchronous
+    execution.
   */
 
-  void cont()
+  bool cont() override
   {
     if (m_completed)
-      return;
+      return true;
+
+    if (!m_inited)
+      execute_prepare();
+
     init();
+
+    if (!process_chunks(false))
+      return false;
+
     if (m_reply)
     {
+      if (!m_sess->prepare_for_reply_cont())
+        return false;
+      if (!check_prepare(false))
+        return false;
       m_reply->cont();
       check_errors();
     }
+
+    if (!is_completed())
+      return false;
+
+    execute_cleanup();
+    return true;
   }
 
   /*
     Drive statement execution until server reply is available.
   */
 
-  void wait()
+  void wait_reply()
   {
     init();
+    process_chunks(true);
     if (m_reply)
     {
+      m_sess->prepare_for_reply();
+      check_prepare(true);
       m_reply->wait();
       check_errors();
     }
   }
 
+  /*
+    Drive asynchronous execution until server reply is available.
+  */
+
+  void wait() override
+  {
+    if (m_completed)
+      return;
+
+    if (!m_inited)
+      execute_prepare();
+
+    wait_reply();
+    is_completed();
+    execute_cleanup();
+  }
+
+  const cdk::api::Event_info* waits_for() override
+  {
+    if (m_completed)
+      return nullptr;
+
+    // Results of earlier commands are read first (see cont()).
+
+    if (m_sess->has_results())
+      return m_sess->results_waits_for();
+
+    if (m_prepare_reply)
+      return m_prepare_reply->waits_for();
+
+    if (!m_chunks.empty())
+      return m_chunks.front()->waits_for();
+    if (!m_reply)
+      return nullptr;
+    return m_reply->waits_for();
+  }
+
+  Result_init& get_result() override
+  {
+    return *this;
+  }
+
 
   // Synchronous execution
 
@@ -217,12 +349,18 @@ public:
     assert(!m_completed);
 
     execute_prepare();
-    wait();
+    wait_reply();
     execute_cleanup();
 
     return *this;
   }
 
+  void set_prefetch_size(unsigned rows) override
+  {
+    m_has_prefetch_size = true;
+    m_prefetch_size = rows;
+  }
+
 protected:
 
   /*
@@ -242,9 +380,181 @@ protected:
 
 
   /*
-    Hooks that are called just before and after execution of the operation.
+    An operation that is too big to be sent to the server in one command can
+    be split into chunks, each sent as a separate command. In that case
+    send_command() sends all the chunks, without waiting for replies, and
+    passes replies to all of them except the last one to add_chunk(). It
+    returns the reply to the last chunk as usual.
+
+    Replies to earlier chunks are processed first, in order. Their affected
+    rows counts and warnings are added to the result of the operation (see
+    init_result()). If any chunk fails, the error is thrown and replies to
+    later chunks are discarded.
+
+    Note: The server executes chunks independently. When one of them fails,
+    chunks before it were executed and chunks after it might have been
+    executed as well.
+  */
+
+  void add_chunk(cdk::Reply *reply)
+  {
+    m_chunks.emplace_back(reply);
+  }
+
+  /*
+    Process replies to earlier chunks of the operation. If `wait` is false
+    this does not block and returns false if some replies are not yet
+    available.
+  */
+
+  bool process_chunks(bool wait)
+  {
+    while (!m_chunks.empty())
+    {
+      cdk::Reply &reply = *m_chunks.front();
+
+      if (wait)
+        m_sess->prepare_for_reply();
+      else if (!m_sess->prepare_for_reply_cont())
+        return false;
+
+      if (wait)
+        reply.wait();
+      else if (!reply.is_completed())
+      {
+        reply.cont();
+        if (!reply.is_completed())
+          return false;
+      }
+
+      if (0 < reply.entry_count())
+      {
+        /*
+          Discard the remaining replies so that the operation can be
+          executed again.
+        */
+
+        std::unique_ptr<cdk::Reply> failed(m_chunks.front().release());
+        m_chunks.clear();
+        m_reply.reset();
+        m_inited = false;
+        failed->get_error().rethrow();
+      }
+
+      m_chunk_stats.add(reply);
+      m_chunks.pop_front();
+    }
+
+    return true;
+  }
+
+
+  /*
+    Operations which can be prepared on the server override this method to
+    send a request to prepare the operation as a statement with the given id
+    (see cdk::Session). It returns NULL if operation can not be prepared.
+  */
+
+  virtual cdk::Reply* send_prepare(uint32_t /*stmt_id*/)
+  {
+    return nullptr;
+  }
+
+  /*
+    Send a request to execute statement prepared with send_prepare(), using
+    current values of operation parameters.
+  */
+
+  virtual cdk::Reply* send_prepared_execute(uint32_t /*stmt_id*/)
+  {
+    return nullptr;
+  }
+
+  /*
+    Try to prepare the operation on the server. Returns false if this is not
+    possible, in which case the operation should be executed directly.
+
+    Note: The prepare request is sent without waiting for its reply, so that
+    the execute request can follow right after it. The reply is checked
+    later, by check_prepare().
+  */
+
+  bool prepare()
+  {
+    if (!m_can_prepare || !m_sess->m_prepare_supported)
+      return false;
+
+    uint32_t stmt_id = m_sess->create_stmt_id();
+    m_prepare_reply.reset(send_prepare(stmt_id));
+
+    if (!m_prepare_reply)
+    {
+      m_can_prepare = false;
+      return false;
+    }
+
+    m_stmt_id = stmt_id;
+    return true;
+  }
 
-    TODO: Currently these hooks are not called when executing asynchronously.
+  /*
+    Check reply to the prepare request sent by prepare(), if any. If wait is
+    false and the reply is not yet available, returns false without
+    blocking.
+
+    If preparing failed, the execute request that followed fails as well.
+    Its reply is discarded and the operation is sent again to be executed
+    directly. Server which does not know prepare requests replies with
+    ER_UNKNOWN_COM_ERROR -- in that case we do not try to prepare statements
+    in this session any more. Other errors, such as too many prepared
+    statements, are not reported here: any genuine errors are reported by
+    the direct execution.
+  */
+
+  bool check_prepare(bool wait)
+  {
+    if (!m_prepare_reply)
+      return true;
+
+    if (wait)
+      m_prepare_reply->wait();
+    else if (!m_prepare_reply->cont())
+      return false;
+
+    std::unique_ptr<cdk::Reply> reply(std::move(m_prepare_reply));
+
+    if (0 == reply->entry_count())
+      return true;
+
+    if (cdk::server_error(1047) == reply->get_error().code())
+      m_sess->m_prepare_supported = false;
+    m_can_prepare = false;
+    m_stmt_id = 0;
+
+    // Note: Deleting the old reply makes CDK skip it.
+
+    m_reply.reset(send_command());
+    return true;
+  }
+
+  /*
+    Derived classes call this method whenever definition of the operation
+    changes. Statement prepared for the old definition is released and
+    the operation will be prepared again after being executed twice.
+  */
+
+  void reset_prepare()
+  {
+    if (m_stmt_id)
+      m_sess->release_stmt_id(m_stmt_id);
+    m_stmt_id = 0;
+    m_exec_count = 0;
+    m_can_prepare = true;
+  }
+
+
+  /*
+    Hooks that are called just before and after execution of the operation.
   */
 
   virtual void execute_prepare()
@@ -308,6 +618,21 @@ protected:
     return m_sess;
   }
 
+  row_count_t get_prefetch_size() override
+  {
+    if (m_has_prefetch_size)
+      return m_prefetch_size;
+    return Result_init::get_prefetch_size();
+  }
+
+  // Pass information about earlier chunks (if any) to the result.
+
+  void init_result(Result_impl_base &res) override
+  {
+    res.m_chunks = std::move(m_chunk_stats);
+    m_chunk_stats.clear();
+  }
+
   cdk::Reply* get_reply() override
   {
     if (!is_completed())
@@ -368,6 +693,11 @@ protected:
     {
       el.first->second = val;
     }
+    else
+    {
+      // Positions of parameters in a prepared statement have changed.
+      Base::reset_prepare();
+    }
   }
 
   void add_param(Value) override
@@ -378,6 +708,14 @@ protected:
   void clear_params() override
   {
     m_map.clear();
+    Base::reset_prepare();
+  }
+
+  cdk::Reply* send_prepared_execute(uint32_t stmt_id) override
+  {
+    return new cdk::Reply(
+      Base::get_cdk_session().prepared_execute(stmt_id, get_params())
+    );
   }
 
   // cdk::Param_source
@@ -432,26 +770,39 @@ protected:
 
   // Limit and offset
 
+  /*
+    Note: limits are stored in the prepared statement, so changing them
+    requires preparing it again.
+  */
+
   void set_limit(unsigned lm) override
   {
+    if (!m_has_limit || m_limit != lm)
+      Base::reset_prepare();
     m_has_limit = true;
     m_limit = lm;
   }
 
   void clear_limit() override
   {
+    if (m_has_limit)
+      Base::reset_prepare();
     m_has_limit = false;
   }
 
 
   void set_offset(unsigned offset) override
   {
+    if (!m_has_offset || m_offset != offset)
+      Base::reset_prepare();
     m_has_offset = true;
     m_offset = offset;
   }
 
   void clear_offset() override
   {
+    if (m_has_offset)
+      Base::reset_prepare();
     m_has_offset = false;
   }
 
@@ -475,6 +826,29 @@ protected:
 };
 
 
+/*
+  Parsed expressions
+  ------------------
+  Expressions given as strings are parsed when a statement is executed for
+  the first time and the result is kept in a parser::Stored_any object,
+  which can re-play the parsed expression to a processor without parsing
+  it again. Such stored expression is not modified after parsing, so it is
+  shared by all copies of the statement. It is discarded only when the
+  expression string changes.
+*/
+
+using Stored_expr = std::shared_ptr<parser::Stored_any>;
+
+inline
+Stored_expr parse_expr(parser::Parser_mode::value pm, const std::wstring &expr)
+{
+  Stored_expr stored = std::make_shared<parser::Stored_any>();
+  parser::Expression_parser parser(pm, expr);
+  parser.process(*stored);
+  return stored;
+}
+
+
 /*
   This template adds to the given Base class implementations of Sort_if
   interface methods which specify sorting of a query results.
@@ -497,7 +871,14 @@ protected:
   using direction_t = typename Base::direction_t;
   using string = std::wstring;
 
+  /*
+    Order item is either an expression with explicit sort direction, or
+    a string "<expr> [ASC|DESC]" which is parsed to get the direction.
+    The parsed sort key and its direction are stored in m_key and m_key_dir.
+  */
+
   struct order_item
+    : cdk::api::Order_expr_processor<cdk::Expression>
   {
     enum {
       ASC  = cdk::api::Sort_direction::ASC,
@@ -506,6 +887,9 @@ protected:
     } m_dir;
     string m_expr;
 
+    Stored_expr m_key;
+    cdk::api::Sort_direction::value m_key_dir = cdk::api::Sort_direction::ASC;
+
     order_item(const string &expr)
       : m_dir(PARSE), m_expr(expr)
     {}
@@ -513,23 +897,64 @@ protected:
     order_item(const string &expr, direction_t dir)
       : m_dir(Base::ASC == dir ? ASC : DESC), m_expr(expr)
     {}
+
+    void parse()
+    {
+      if (m_key)
+        return;
+
+      if (PARSE != m_dir)
+      {
+        m_key_dir = cdk::api::Sort_direction::value(m_dir);
+        m_key = parse_expr(PM, m_expr);
+        return;
+      }
+
+      Stored_expr key = std::make_shared<parser::Stored_any>();
+      m_key = key;
+      try {
+        parser::Order_parser order_parser(PM, m_expr);
+        order_parser.process(*this);
+      }
+      catch (...)
+      {
+        m_key.reset();
+        throw;
+      }
+    }
+
+    // Order_expr processor (used when parsing the item)
+
+    Expr_prc* sort_key(cdk::api::Sort_direction::value dir) override
+    {
+      m_key_dir = dir;
+      return m_key.get();
+    }
   };
 
-  std::list<order_item> m_order;
+  /*
+    Note: order items are parsed when the list is processed (which is
+    a const method), hence mutable.
+  */
+
+  mutable std::list<order_item> m_order;
 
   void add_sort(const string &expr, direction_t dir) override
   {
     m_order.emplace_back(expr, dir);
+    Base::reset_prepare();
   }
 
   void add_sort(const string &sort) override
   {
     m_order.emplace_back(sort);
+    Base::reset_prepare();
   }
 
   void clear_sort() override
   {
     m_order.clear();
+    Base::reset_prepare();
   }
 
   Op_sort(Shared_session_impl sess) : Base(sess)
@@ -550,31 +975,14 @@ private:
   {
     prc.list_begin();
 
-    for (const order_item &item : m_order)
+    for (order_item &item : m_order)
     {
       auto *el = prc.list_el();
       if (!el)
         continue;
 
-      switch (item.m_dir)
-      {
-      case order_item::ASC:
-      case order_item::DESC:
-        {
-          parser::Expression_parser parser(PM, item.m_expr);
-          parser.process_if(el->sort_key(
-            cdk::api::Sort_direction::value(item.m_dir)
-          ));
-        }
-        break;
-
-      case order_item::PARSE:
-        {
-          parser::Order_parser order_parser(PM, item.m_expr);
-          order_parser.process_if(el);
-        }
-        break;
-      }
+      item.parse();
+      item.m_key->process_if(el->sort_key(item.m_key_dir));
     }
 
     prc.list_end();
@@ -603,6 +1011,7 @@ protected:
   using string = std::wstring;
 
   string m_having;
+  mutable Stored_expr m_having_expr;
 
 public:
 
@@ -614,11 +1023,15 @@ public:
   void set_having(const string &having) override
   {
     m_having = having;
+    m_having_expr.reset();
+    Base::reset_prepare();
   }
 
   void clear_having() override
   {
     m_having.clear();
+    m_having_expr.reset();
+    Base::reset_prepare();
   }
 
   cdk::Expression* get_having()
@@ -632,8 +1045,9 @@ private:
 
   void process(cdk::Expression::Processor& prc) const override
   {
-    parser::Expression_parser expr_parser(PM, m_having);
-    expr_parser.process(prc);
+    if (!m_having_expr)
+      m_having_expr = parse_expr(PM, m_having);
+    m_having_expr->process(prc);
   }
 };
 
@@ -657,6 +1071,10 @@ class Op_group_by
   using string = std::wstring;
   std::vector<string> m_group_by;
 
+  // Parsed grouping expressions, in the same order as in m_group_by.
+
+  mutable std::vector<Stored_expr> m_group_by_expr;
+
 public:
 
   using Shared_session_impl = typename Base::Shared_session_impl;
@@ -664,11 +1082,14 @@ public:
   void add_group_by(const string &group_by) override
   {
     m_group_by.push_back(group_by);
+    Base::reset_prepare();
   }
 
   void clear_group_by() override
   {
     m_group_by.clear();
+    m_group_by_expr.clear();
+    Base::reset_prepare();
   }
 
   Op_group_by(Shared_session_impl sess) : Base(sess)
@@ -685,13 +1106,13 @@ private:
 
   void process(cdk::Expr_list::Processor& prc) const override
   {
+    for (size_t pos = m_group_by_expr.size(); pos < m_group_by.size(); ++pos)
+      m_group_by_expr.push_back(parse_expr(PM, m_group_by[pos]));
+
     prc.list_begin();
 
-    for (string el : m_group_by)
-    {
-      parser::Expression_parser expr_parser(PM, el);
-      expr_parser.process_if(prc.list_el());
-    }
+    for (const Stored_expr &el : m_group_by_expr)
+      el->process_if(prc.list_el());
 
     prc.list_end();
   }
@@ -723,6 +1144,37 @@ protected:
   std::vector<string> m_projections;
   string  m_doc_proj;
 
+  /*
+    Parsed table projection: the projected expression and its alias
+    (if any).
+  */
+
+  struct Proj_item
+    : cdk::api::Projection_processor<cdk::Expression>
+  {
+    Stored_expr m_expr;
+    bool        m_has_alias = false;
+    cdk::string m_alias;
+
+    Proj_item()
+      : m_expr(std::make_shared<parser::Stored_any>())
+    {}
+
+    Expr_prc* expr() override
+    {
+      return m_expr.get();
+    }
+
+    void alias(const cdk::string &name) override
+    {
+      m_has_alias = true;
+      m_alias = name;
+    }
+  };
+
+  mutable Stored_expr m_doc_proj_expr;
+  mutable std::vector<Proj_item> m_tbl_proj;
+
   using Shared_session_impl = typename Base::Shared_session_impl;
 
 public:
@@ -733,16 +1185,21 @@ public:
   void set_proj(const string& doc) override
   {
     m_doc_proj = doc;
+    m_doc_proj_expr.reset();
+    Base::reset_prepare();
   }
 
   void add_proj(const string& field) override
   {
     m_projections.push_back(field);
+    Base::reset_prepare();
   }
 
   void clear_proj() override
   {
     m_projections.clear();
+    m_tbl_proj.clear();
+    Base::reset_prepare();
   }
 
   cdk::Projection* get_tbl_proj()
@@ -797,11 +1254,10 @@ private:
 
       eprc.m_prc = &prc;
 
-      parser::Expression_parser parser(
-        parser::Parser_mode::DOCUMENT, m_doc_proj
-      );
+      if (!m_doc_proj_expr)
+        m_doc_proj_expr = parse_expr(parser::Parser_mode::DOCUMENT, m_doc_proj);
 
-      parser.process(eprc);
+      m_doc_proj_expr->process(eprc);
 
       return;
     }
@@ -825,16 +1281,26 @@ private:
 
   void process(cdk::Projection::Processor& prc) const override
   {
+    for (size_t pos = m_tbl_proj.size(); pos < m_projections.size(); ++pos)
+    {
+      Proj_item item;
+      parser::Projection_parser proj_parser(
+        parser::Parser_mode::TABLE, m_projections[pos]
+      );
+      proj_parser.process(item);
+      m_tbl_proj.push_back(std::move(item));
+    }
+
     prc.list_begin();
 
-    for (string el : m_projections)
+    for (const Proj_item &item : m_tbl_proj)
     {
-
-      parser::Projection_parser order_parser(parser::Parser_mode::TABLE, el);
       auto prc_el = prc.list_el();
-      if (prc_el)
-        order_parser.process(*prc_el);
-
+      if (!prc_el)
+        continue;
+      item.m_expr->process_if(prc_el->expr());
+      if (item.m_has_alias)
+        prc_el->alias(item.m_alias);
     }
 
     prc.list_end();
@@ -866,16 +1332,16 @@ protected:
 
   string m_where_expr;
   bool   m_where_set = false;
-  std::unique_ptr<parser::Expression_parser> m_expr;
+  mutable Stored_expr m_expr;
   cdk::Lock_mode_value  m_lock_mode = cdk::api::Lock_mode::NONE;
 
-  // Note: we do not copy m_expr to avoid invoking copy ctor
-  // for Expression_parser
+  // Note: parsed selection criteria are shared with the copy.
 
   Op_select(const Op_select &other)
     : Base(other)
     , m_where_expr(other.m_where_expr)
     , m_where_set(other.m_where_set)
+    , m_expr(other.m_expr)
   {}
 
 public:
@@ -887,6 +1353,8 @@ public:
   {
     m_where_expr = expr;
     m_where_set = true;
+    m_expr.reset();
+    Base::reset_prepare();
   }
 
   void set_lock_mode(Lock_mode lm) override
@@ -894,11 +1362,13 @@ public:
     // Note: assumes the cdk::Lock_mode enum uses the same values as
     // common::Select_if::Lock_mode.
     m_lock_mode = cdk::Lock_mode_value(lm);
+    Base::reset_prepare();
   }
 
   void clear_lock_mode() override
   {
     m_lock_mode = cdk::api::Lock_mode::NONE;
+    Base::reset_prepare();
   }
 
   cdk::Expression* get_where() const
@@ -910,9 +1380,8 @@ public:
       return NULL;
     }
 
-    auto *self = const_cast<Op_select*>(this);
-
-    self->m_expr.reset(new parser::Expression_parser(PM, m_where_expr));
+    if (!m_expr)
+      m_expr = parse_expr(PM, m_where_expr);
     return m_expr.get();
   }
 };
@@ -1009,6 +1478,21 @@ struct Op_sql
       )
     );
   }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    return new cdk::Reply(get_cdk_session().sql(m_query, NULL, stmt_id));
+  }
+
+  cdk::Reply* send_prepared_execute(uint32_t stmt_id) override
+  {
+    return new cdk::Reply(
+      get_cdk_session().prepared_execute(
+        stmt_id,
+        m_params.m_values.empty() ? NULL : &m_params
+      )
+    );
+  }
 };
 
 
@@ -1458,7 +1942,7 @@ struct Op_list_objects
   template <Object_type T>
   static bool check_type(const Row_data &row)
   {
-    cdk::bytes  name_col = row.at(1).data();
+    cdk::bytes  name_col = row.at(1);
     std::string name(name_col.begin(), name_col.end()-1);
     return name == obj_name<T>();
   }
@@ -1663,7 +2147,6 @@ public:
     m_json.clear();
   }
 
-
   void execute_prepare() override
   {
     m_pos = 0;
@@ -1687,14 +2170,33 @@ public:
     // Issue coll_add statement where documents are described by list
     // of expressions defined by this instance.
 
-    return new cdk::Reply(
-      get_cdk_session().coll_add(m_coll, *this, NULL, m_upsert)
+    /*
+      If documents do not fit into a single command of the size given by
+      m_max_insert_size, CDK sends only some of them (see next()) and the
+      remaining ones are sent in further chunks.
+    */
+
+    size_t max_size = m_expr ? 0 : m_sess->m_max_insert_size;
+
+    cdk::Reply *reply = new cdk::Reply(
+      get_cdk_session().coll_add(m_coll, *this, NULL, m_upsert, max_size)
     );
+
+    while (!m_expr && m_pos < m_json.size())
+    {
+      add_chunk(reply);
+      reply = new cdk::Reply(
+        get_cdk_session().coll_add(m_coll, *this, NULL, m_upsert, max_size)
+      );
+    }
+
+    return reply;
   }
 
 
   void init_result(Result_impl_base &res) override
   {
+    Op_base::init_result(res);
     res.m_guids = std::move(m_id_list);
   }
 
@@ -1871,37 +2373,72 @@ void Op_collection_add::process(cdk::Expression::Processor &ep) const
   const std::string &json = m_json.at(m_pos-1);
   auto self = const_cast<Op_collection_add*>(this);
 
-  // Parse JSON string to find _id if defined.
-  // TODO: Avoid parsing (if inserted document id is returned by server).
+  /*
+    Look for _id in the JSON string. The quick scan handles common documents
+    without parsing them. Only if it can not decide, the document is processed
+    by the full JSON parser which also reports invalid _id values.
+  */
 
-  cdk::Codec<cdk::TYPE_DOCUMENT> codec;
-  self->m_generated_id = true;
-  codec.from_bytes(cdk::bytes(json), *self);
+  std::string id;
 
-  if (m_generated_id)
+  switch (parser::scan_doc_id(cdk::bytes(json), id))
   {
-    self->m_id.generate();
-    std::string id(m_id);
+  case parser::SCAN_ID:
+    self->m_generated_id = false;
+    self->m_id = id;
+    break;
 
-    struct : cdk::Expression
+  case parser::SCAN_NO_ID:
+    self->m_generated_id = true;
+    break;
+
+  case parser::SCAN_UNKNOWN:
     {
-      const std::string *m_json;
+      cdk::Codec<cdk::TYPE_DOCUMENT> codec;
+      self->m_generated_id = true;
+      codec.from_bytes(cdk::bytes(json), *self);
+    }
+    break;
+  }
 
-      void process(Processor &prc) const override
-      {
-        safe_prc(prc)->scalar()->val()->str(*m_json);
-      }
+  /*
+    The JSON document string, reported as opaque value of type DOCUMENT
+    so that it is sent to the server without converting it.
+  */
+
+  struct Doc
+    : cdk::Expression
+    , cdk::Format_info
+  {
+    const std::string &m_json;
+
+    Doc(const std::string &json)
+      : m_json(json)
+    {}
+
+    void process(Processor &prc) const override
+    {
+      safe_prc(prc)->scalar()->val()->value(
+        cdk::TYPE_DOCUMENT, *this, cdk::bytes(m_json)
+      );
     }
-    doc;
-    doc.m_json = &json;
 
-    Insert_id expr(doc, id);
+    bool for_type(cdk::Type_info ti) const override
+    {
+      return cdk::TYPE_DOCUMENT == ti;
+    }
+  }
+  doc(json);
+
+  if (m_generated_id)
+  {
+    self->m_id.generate();
+    Insert_id expr(doc, m_id);
     expr.process(ep);
   }
   else
   {
-    // TODO: Report as opaque value of type DOCUMENT using JSON format.
-    ep.scalar()->val()->str(json);
+    doc.process(ep);
   }
 
   //Save added "_id" to the list
@@ -1959,6 +2496,21 @@ public:
   }
 
   cdk::Reply* send_command() override
+  {
+    return send_stmt(0);
+  }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    return send_stmt(stmt_id);
+  }
+
+  /*
+    Send the find command or, if stmt_id is not 0, a request to prepare it
+    as a statement with this id.
+  */
+
+  cdk::Reply* send_stmt(uint32_t stmt_id)
   {
     return
       new cdk::Reply(get_cdk_session().coll_find(
@@ -1971,7 +2523,8 @@ public:
                           get_having(),
                           get_limit(),
                           get_params(),
-                          m_lock_mode
+                          m_lock_mode,
+                          stmt_id
                     ));
   }
 
@@ -2017,6 +2570,16 @@ public:
 
 
   cdk::Reply* send_command() override
+  {
+    return send_stmt(0);
+  }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    return send_stmt(stmt_id);
+  }
+
+  cdk::Reply* send_stmt(uint32_t stmt_id)
   {
     return
       new cdk::Reply(get_cdk_session().coll_remove(
@@ -2024,7 +2587,8 @@ public:
                             get_where(),
                             get_order_by(),
                             get_limit(),
-                            get_params()
+                            get_params(),
+                            stmt_id
                     ));
   }
 };
@@ -2118,6 +2682,21 @@ public:
     if (m_update.empty())
       return NULL;
 
+    return send_stmt(0);
+  }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    if (m_update.empty())
+      return NULL;
+
+    return send_stmt(stmt_id);
+  }
+
+  cdk::Reply* send_stmt(uint32_t stmt_id)
+  {
+    m_update_it = m_update.end();
+
     return
       new cdk::Reply(get_cdk_session().coll_update(
                        m_coll,
@@ -2125,15 +2704,22 @@ public:
                        *this,
                        get_order_by(),
                        get_limit(),
-                       get_params()
+                       get_params(),
+                       stmt_id
                      ));
   }
 
 
+  /*
+    Note: values of update operations are stored in the prepared statement,
+    so changing them requires preparing it again.
+  */
+
   void add_operation(typename Impl::Operation op,
                      const string &field) override
   {
     m_update.emplace_back(op, field);
+    reset_prepare();
   }
 
   void add_operation(typename Impl::Operation op,
@@ -2141,6 +2727,7 @@ public:
                      const Value &val) override
   {
     m_update.emplace_back(op, field, val);
+    reset_prepare();
   }
 
   /*
@@ -2153,12 +2740,14 @@ public:
                      cdk::Expression &expr)
   {
     m_update.emplace_back(op, field, expr);
+    reset_prepare();
   }
 
 
   void clear_modifications() override
   {
     m_update.clear();
+    reset_prepare();
   }
 
 
@@ -2292,6 +2881,21 @@ class Op_table_select
   const cdk::View_spec *m_view = nullptr;
 
   cdk::Reply* send_command() override
+  {
+    return send_stmt(0);
+  }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    // Note: select which defines a view is never executed.
+
+    if (m_view)
+      return NULL;
+
+    return send_stmt(stmt_id);
+  }
+
+  cdk::Reply* send_stmt(uint32_t stmt_id)
   {
     return
         new cdk::Reply(get_cdk_session().table_select(
@@ -2304,7 +2908,8 @@ class Op_table_select
                           get_having(),
                           get_limit(),
                           get_params(),
-                          m_lock_mode
+                          m_lock_mode,
+                          stmt_id
                        ));
   }
 
@@ -2419,6 +3024,7 @@ private:
   // Executable
 
   bool m_started = false;
+  bool m_rows_done = false;  // set when next() reached the end of m_rows
 
   cdk::Reply* send_command() override
   {
@@ -2429,20 +3035,38 @@ private:
 
     // Prepare iterators to make a pass through m_rows list.
     m_started = false;
+    m_rows_done = false;
 
     /*
+      Rows that do not fit into a single command of the size given by
+      m_max_insert_size are sent in further chunks. Each chunk continues
+      from the row after the last one sent (see next()). No more chunks are
+      needed if the row source was exhausted, or if the last row sent is
+      the last row in m_rows.
+
       Note: gcc complained if get_cdk_session() was used without Base:: prefix.
       I actually do not understand why...
     */
 
-    return new cdk::Reply(
-      Base::get_cdk_session().table_insert(
-        m_table,
-        *this,
-        m_cols.empty() ? nullptr : this,
-        nullptr
-      )
-    );
+    size_t max_size = Base::m_sess->m_max_insert_size;
+
+    for (;;)
+    {
+      cdk::Reply *reply = new cdk::Reply(
+        Base::get_cdk_session().table_insert(
+          m_table,
+          *this,
+          m_cols.empty() ? nullptr : this,
+          nullptr,
+          max_size
+        )
+      );
+
+      if (m_rows_done || std::next(m_cur_row) == m_rows.end())
+        return reply;
+
+      Base::add_chunk(reply);
+    }
   }
 
 
@@ -2456,7 +3080,8 @@ private:
       ++m_cur_row;
 
     m_started = true;
-    return m_cur_row != m_rows.end();
+    m_rows_done = (m_cur_row == m_rows.end());
+    return !m_rows_done;
   }
 
 
@@ -2549,11 +3174,13 @@ public:
   void add_set(const string &field, const Value &val) override
   {
     m_set_values.emplace(field, val);
+    reset_prepare();
   }
 
   void clear_modifications() override
   {
     m_set_values.clear();
+    reset_prepare();
   }
 
 protected:
@@ -2564,6 +3191,16 @@ protected:
   }
 
   cdk::Reply* send_command() override
+  {
+    return send_stmt(0);
+  }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    return send_stmt(stmt_id);
+  }
+
+  cdk::Reply* send_stmt(uint32_t stmt_id)
   {
     m_set_it = m_set_values.end();
 
@@ -2574,7 +3211,8 @@ protected:
                         *this,
                         get_order_by(),
                         get_limit(),
-                        get_params()
+                        get_params(),
+                        stmt_id
                       ));
   }
 
@@ -2669,6 +3307,16 @@ protected:
   }
 
   cdk::Reply* send_command() override
+  {
+    return send_stmt(0);
+  }
+
+  cdk::Reply* send_prepare(uint32_t stmt_id) override
+  {
+    return send_stmt(stmt_id);
+  }
+
+  cdk::Reply* send_stmt(uint32_t stmt_id)
   {
     return
         new cdk::Reply(Base::get_cdk_session().table_delete(
@@ -2676,7 +3324,8 @@ protected:
                           get_where(),
                           get_order_by(),
                           get_limit(),
-                          get_params()
+                          get_params(),
+                          stmt_id
                       ));
   }
 
@@ -74,6 +74,19 @@ mysqlx::common::convert(cdk::bytes data, Format_descr<cdk::TYPE_STRING> &fd)
   if (fd.m_format.is_set())
     return { raw.begin(), raw.size() };
 
+  /*
+    UTF8 strings are stored as they are (after checking that they are valid).
+    If needed, conversion to a wide string is done later by
+    Value::get_wstring().
+  */
+
+  if (is_utf8(fd.m_format))
+  {
+    if (!cdk::foundation::utf8::is_valid(raw))
+      throw Error("Invalid UTF8 string");
+    return std::string(raw.begin(), raw.end());
+  }
+
   auto &codec = fd.m_codec;
   cdk::string str;
   codec.from_bytes(raw, str);
@@ -114,8 +127,20 @@ mysqlx::common::convert(cdk::bytes data, Format_descr<cdk::TYPE_FLOAT> &fd)
     return Value(val);
   }
 
-  // For other formats (DOUBLE, DECIMAL), try storing in double
-  // TODO: exact representation for DECIMAL values?
+  /*
+    DECIMAL values are stored as exact fixed-point numbers if they fit in
+    128 bits. Otherwise, as for DOUBLE, they are stored as double.
+  */
+
+  if (fmt.DECIMAL == fmt.type())
+  {
+    cdk::Codec<cdk::TYPE_FLOAT>::Decimal val;
+    if (fd.m_codec.from_bytes(data, val))
+      return Value(
+        Decimal(val.m_high, val.m_low, val.m_scale, val.m_negative)
+      );
+  }
+
   {
     double val;
     fd.m_codec.from_bytes(data, val);
@@ -158,11 +183,25 @@ mysqlx::common::convert(cdk::bytes data, Format_descr<cdk::TYPE_DOCUMENT>&)
 */
 
 
+void Chunk_stats::add(cdk::Reply &reply)
+{
+  m_affected_rows += reply.affected_rows();
+
+  if (0 == m_auto_increment)
+    m_auto_increment = reply.last_insert_id();
+
+  for (auto &it = reply.get_entries(cdk::api::Severity::WARNING); it.next();)
+    m_warnings.emplace_back(it.entry().get_error().clone());
+}
+
+
+
 Result_impl_base::Result_impl_base(Result_init &init)
   : m_sess(init.get_session()), m_reply(init.get_reply())
 {
   // Note: init.get_reply() can be NULL in the case of ignored server error
   m_sess->register_result(this);
+  m_prefetch_size = init.get_prefetch_size();
   init.init_result(*this);
 }
 
@@ -185,53 +224,86 @@ Result_impl_base::~Result_impl_base()
 bool Result_impl_base::next_result()
 {
   /*
-    Note: closing cursor discards previous rset. Only then
-    we can move to the next rset (if any).
+    Note: If preparation of the first result was started by store_cont(),
+    it is completed here.
   */
 
-  if (m_pending_rows)
+  if (m_inited)
   {
-    assert(m_cursor);
-    m_cursor->close();
+    /*
+      Note: closing cursor discards previous rset. Only then
+      we can move to the next rset (if any).
+    */
+
+    if (m_pending_rows)
+    {
+      assert(m_cursor);
+      m_cursor->close();
+    }
+
+    // Prepare for reading (next) result
+
+    delete m_cursor;
+    m_cursor = nullptr;
+    m_mdata.reset();
+    clear_cache();
+    m_pending_rows = false;
+    m_loading = false;
+    clear_diagnostics();
+    m_inited = false;
   }
 
-  // Prepare for reading (next) result
-
-  delete m_cursor;
-  m_cursor = nullptr;
-  m_mdata.reset();
-  clear_cache();
-  m_pending_rows = false;
-  clear_diagnostics();
-  m_inited = true;
+  init_result(true);
+  return m_pending_rows;
+}
 
 
+bool Result_impl_base::init_result(bool wait)
+{
   if (!m_reply)
-    return false;
+  {
+    m_inited = true;
+    return true;
+  }
 
-  // Wait for the cdk reply object to become ready.
+  if (!m_cursor)
+  {
+    // Wait for the cdk reply object to become ready.
 
-  m_reply->wait();
+    if (wait)
+      m_reply->wait();
+    else if (!m_reply->cont())
+      return false;
 
-  if (0 < m_reply->entry_count())
-    m_reply->get_error().rethrow();
+    if (0 < m_reply->entry_count())
+    {
+      m_inited = true;
+      m_reply->get_error().rethrow();
+    }
 
-  if (!m_reply->has_results())
-  {
-    m_sess->deregister_result(this);
-    return false;
-  }
+    if (!m_reply->has_results())
+    {
+      m_sess->deregister_result(this);
+      m_inited = true;
+      return true;
+    }
 
-  // Result has row data - create cursor to access it
+    // Result has row data - create cursor to access it
 
-  m_cursor = new cdk::Cursor(*m_reply);
+    m_cursor = new cdk::Cursor(*m_reply);
+  }
 
   // Wait for cursor to fetch result meta-data and copy it to local storage.
 
-  m_cursor->wait();
+  if (wait)
+    m_cursor->wait();
+  else if (!m_cursor->cont())
+    return false;
+
   m_mdata.reset(fetch_meta_data(*m_cursor));
 
   m_pending_rows = true;
+  m_inited = true;
 
   return true;
 }
@@ -239,20 +311,73 @@ bool Result_impl_base::next_result()
 
 const Row_data* Result_impl_base::get_row()
 {
-  // TODO: Session parameter for cache prefetch size
-
-  if (!load_cache(1024))
+  if (!load_cache(get_prefetch_size()))
     return nullptr;
 
   assert(!m_row_cache.empty());
 
-  m_row = m_row_cache.front();
+  m_row = std::move(m_row_cache.front());
   m_row_cache.pop_front();
   m_row_cache_size--;
   return &m_row;
 }
 
 
+row_count_t
+Result_impl_base::get_rows(std::vector<Row_data> &rows, row_count_t max_rows)
+{
+  if (!load_cache(get_prefetch_size()))
+    return 0;
+
+  row_count_t count = m_row_cache_size;
+
+  if (0 < max_rows && max_rows < count)
+    count = max_rows;
+
+  rows.reserve(rows.size() + count);
+
+  for (row_count_t i = 0; i < count; ++i)
+  {
+    rows.emplace_back(std::move(m_row_cache.front()));
+    m_row_cache.pop_front();
+  }
+
+  m_row_cache_size -= count;
+  return count;
+}
+
+
+/*
+  Determine how many rows should be loaded into the cache in one batch.
+
+  In adaptive mode (m_prefetch_size is 0), the first batch is small. After
+  that, the number of rows is chosen so that the batch holds approximately
+  prefetch_bytes of row data, given the average row size seen in the previous
+  batch. This way wide rows (such as large JSON documents) are read in small
+  batches while narrow rows are read in larger ones.
+*/
+
+row_count_t Result_impl_base::get_prefetch_size() const
+{
+  static const row_count_t initial_rows = 128;
+  static const row_count_t max_rows = 64*1024;
+
+  if (0 < m_prefetch_size)
+    return m_prefetch_size;
+
+  if (0 == m_row_width)
+    return initial_rows;
+
+  row_count_t rows = row_count_t(prefetch_bytes / m_row_width);
+
+  if (rows < 1)
+    return 1;
+  if (rows > max_rows)
+    return max_rows;
+  return rows;
+}
+
+
 /*
   Returns true if there are some rows in the cache after returning from
   the call. If cache is empty when this method is called, it loads
@@ -273,12 +398,60 @@ bool Result_impl_base::load_cache(row_count_t prefetch_size)
     return false;
 
   /*
-    Note: if cache is not empty then m_cache_it correctly points at the last
-    element in the cache.
+    Note: If rows are already being read by store_cont(), we wait for that
+    operation to complete.
+  */
+
+  if (!m_loading)
+    start_rows(prefetch_size);
+
+  // Wait for it to complete
+
+  m_cursor->wait();
+  end_rows();
+
+  return !m_row_cache.empty();
+}
+
+
+bool Result_impl_base::store_cont()
+{
+  if (!m_inited && !init_result(false))
+    return false;
+
+  if (!m_pending_rows)
+    return true;
+
+  if (!m_loading)
+    start_rows(0);
+
+  if (!m_cursor->cont())
+    return false;
+
+  end_rows();
+  return true;
+}
+
+
+const cdk::api::Event_info* Result_impl_base::waits_for() const
+{
+  if (m_cursor)
+    return m_cursor->waits_for();
+  if (m_reply && !m_inited)
+    return m_reply->waits_for();
+  return nullptr;
+}
+
+
+void Result_impl_base::start_rows(row_count_t prefetch_size)
+{
+  /*
+    Start new row batch. Rows already in the cache keep referring to
+    the previous batch.
   */
 
-  if (m_row_cache.empty())
-    m_cache_it = m_row_cache.before_begin();
+  m_batch = std::make_shared<Row_batch>();
+  m_batch_rows = 0;
 
   // Initiate row reading operation
 
@@ -287,9 +460,25 @@ bool Result_impl_base::load_cache(row_count_t prefetch_size)
   else
     m_cursor->get_rows(*this);  // this reads all remaining rows
 
-  // Wait for it to complete
+  m_loading = true;
+}
 
-  m_cursor->wait();
+
+void Result_impl_base::end_rows()
+{
+  m_loading = false;
+
+  /*
+    Update the average row size used to determine batch size in adaptive
+    mode. Memory used by field entries is counted as well.
+  */
+
+  if (0 < m_batch_rows)
+  {
+    m_row_width = (m_batch->m_bytes.size()
+                   + m_batch->m_fields.size()*sizeof(Row_batch::Field))
+                  / m_batch_rows;
+  }
 
   /*
     Cleanup after reading all rows.
@@ -301,36 +490,62 @@ bool Result_impl_base::load_cache(row_count_t prefetch_size)
     m_sess->deregister_result(this);
     load_diagnostics();
   }
-
-  return !m_row_cache.empty();
 }
 
 
 //  Row_processor interface implementation
 
 
+bool Result_impl_base::row_begin(row_count_t)
+{
+  assert(m_batch);
+  m_row_begin = m_batch->m_fields.size();
+  m_row_bytes = m_batch->m_bytes.size();
+
+  // Note: all fields are initially null.
+
+  m_batch->m_fields.resize(m_row_begin + get_col_count());
+  return true;
+}
+
 size_t Result_impl_base::field_begin(col_count_t pos, size_t size)
 {
-  //m_row.insert(std::pair<col_count_t, Buffer>(pos, Buffer()));
-  m_row.emplace(pos, Buffer());
+  auto &fields = m_batch->m_fields;
+
+  if (m_row_begin + pos >= fields.size())
+    fields.resize(m_row_begin + pos + 1);
+
+  Row_batch::Field &f = fields[m_row_begin + pos];
+  f.m_offset = m_batch->m_bytes.size();
+  f.m_len = 0;
   // FIX
   return size;
 }
 
 size_t Result_impl_base::field_data(col_count_t pos, bytes data)
 {
-  m_row[(unsigned)pos].append(data);
+  m_batch->m_bytes.insert(m_batch->m_bytes.end(), data.begin(), data.end());
+  m_batch->m_fields[m_row_begin + pos].m_len += data.size();
   // FIX
   return data.size();
 }
 
 void Result_impl_base::row_end(row_count_t)
 {
-  if (!m_row_filter(m_row))
+  Row_data row(m_batch, m_row_begin,
+               col_count_t(m_batch->m_fields.size() - m_row_begin));
+
+  if (!m_row_filter(row))
+  {
+    // Remove the row from the batch.
+    m_batch->m_fields.resize(m_row_begin);
+    m_batch->m_bytes.resize(m_row_bytes);
     return;
+  }
 
-  m_cache_it = m_row_cache.emplace_after(m_cache_it, std::move(m_row));
+  m_row_cache.emplace_back(std::move(row));
   m_row_cache_size++;
+  m_batch_rows++;
 }
 
 void Result_impl_base::end_of_data()
@@ -372,6 +587,9 @@ void Result_impl_base::load_diagnostics()
 
   Diagnostic_arena::clear();
 
+  for (auto &warn : m_chunks.m_warnings)
+    add_entry(cdk::api::Severity::WARNING, warn->clone());
+
   for (auto &it = m_reply->get_entries(cdk::api::Severity::WARNING); it.next();)
   {
     auto &entry = it.entry();
@@ -41,6 +41,13 @@
 #include "session.h"
 #include "value.h"
 
+#include <deque>
+#include <memory>
+
+
+struct ArrowSchema;
+struct ArrowArray;
+
 
 namespace mysqlx {
 namespace common {
@@ -373,6 +380,11 @@ struct Meta_data_base
     return get_format(pos).m_type;
   }
 
+  // Column length and number of decimal digits reported by the server.
+
+  virtual unsigned long  get_length(cdk::col_count_t pos) const = 0;
+  virtual unsigned short get_decimals(cdk::col_count_t pos) const = 0;
+
 protected:
 
   cdk::col_count_t  m_col_count = 0;
@@ -452,6 +464,16 @@ private:
     return m_cols.at(pos);
   }
 
+  unsigned long get_length(cdk::col_count_t pos) const override
+  {
+    return m_cols.at(pos).m_length;
+  }
+
+  unsigned short get_decimals(cdk::col_count_t pos) const override
+  {
+    return m_cols.at(pos).m_decimals;
+  }
+
   friend Result_impl_base;
 };
 
@@ -500,38 +522,96 @@ Meta_data<STR>::Meta_data(cdk::Meta_data &md)
 
 
 /*
-  Convenience wrapper around std container that is used
-  to store incoming raw bytes sequence.
+  Raw data of a batch of rows fetched from the server.
 
-  TODO: More efficient implementation.
+  Bytes of all fields of all rows in the batch are stored in a single arena
+  m_bytes. For each field there is an entry in m_fields which gives offset
+  and length of field data inside the arena. A row occupies a consecutive
+  range of entries in m_fields, one entry per column. Null field is marked
+  with npos offset.
+
+  Note: offsets, not pointers, are stored so that the arena can grow while
+  rows are appended to the batch.
 */
 
-class Buffer
+class Row_batch
 {
-  std::vector<byte> m_impl;
-
 public:
 
-  void append(cdk::bytes data)
+  static const size_t npos = (size_t)-1;
+
+  struct Field
   {
-    m_impl.insert(m_impl.end(), data.begin(), data.end());
-  }
+    size_t m_offset = npos;
+    size_t m_len = 0;
+  };
+
+  std::vector<byte>  m_bytes;
+  std::vector<Field> m_fields;
 
-  size_t size() const { return m_impl.size(); }
+  bool is_null(size_t pos) const
+  {
+    return npos == m_fields[pos].m_offset;
+  }
 
-  cdk::bytes data() const
+  cdk::bytes get(size_t pos) const
   {
-    return cdk::bytes((byte*)m_impl.data(), m_impl.size());
+    const Field &f = m_fields[pos];
+    return cdk::bytes((byte*)m_bytes.data() + f.m_offset, f.m_len);
   }
 };
 
+using Shared_row_batch = std::shared_ptr<const Row_batch>;
+
 
 /*
-  Data structure used to hold raw row data. It holds a Buffer with
-  raw bytes for each non-null field of a row.
+  Data structure used to hold raw row data. It refers to a range of fields
+  inside a row batch (see Row_batch) and shares ownership of the batch, so
+  that copying Row_data instances does not copy the data itself.
 */
 
-typedef std::map<col_count_t, Buffer> Row_data;
+class Row_data
+{
+  Shared_row_batch m_batch;
+  size_t      m_begin = 0;
+  col_count_t m_cols = 0;
+
+public:
+
+  Row_data() {}
+
+  Row_data(const Shared_row_batch &batch, size_t begin, col_count_t cols)
+    : m_batch(batch), m_begin(begin), m_cols(cols)
+  {}
+
+  // Number of columns in the row.
+
+  col_count_t size() const { return m_cols; }
+
+  bool is_null(col_count_t pos) const
+  {
+    return pos >= m_cols || m_batch->is_null(m_begin + pos);
+  }
+
+  /*
+    Return raw bytes of field at given position.
+    @throws std::out_of_range if there is no such field or its value is null.
+  */
+
+  cdk::bytes at(col_count_t pos) const
+  {
+    if (is_null(pos))
+      throw std::out_of_range("row column");
+    return m_batch->get(m_begin + pos);
+  }
+
+  void clear()
+  {
+    m_batch.reset();
+    m_begin = 0;
+    m_cols = 0;
+  }
+};
 
 
 /*
@@ -544,6 +624,25 @@ Value convert(cdk::bytes, Format_descr<cdk::TYPE_INTEGER>&);
 Value convert(cdk::bytes, Format_descr<cdk::TYPE_FLOAT>&);
 Value convert(cdk::bytes, Format_descr<cdk::TYPE_DOCUMENT>&);
 
+
+/*
+  Check if strings in given format are UTF8 encoded. Raw bytes of such
+  strings can be used as UTF8 text without any conversion.
+*/
+
+inline
+bool is_utf8(const cdk::Format<cdk::TYPE_STRING> &fmt)
+{
+  switch (fmt.charset())
+  {
+  case cdk::Charset::utf8:
+  case cdk::Charset::utf8mb4:
+    return true;
+  default:
+    return false;
+  }
+}
+
 /*
   Generic template used when no type-specific specialization is defined.
   It builds a value holding the raw bytes.
@@ -599,8 +698,9 @@ Value Value::Access::mk(bytes data, common::Format_descr<T> &format)
 
 
 /*
-  Implementation for a single Row instance. It holds a copy of row
-  raw data and a shared pointer to row set meta-data.
+  Implementation for a single Row instance. It holds row raw data (which
+  shares the row batch with the result) and a shared pointer to row set
+  meta-data.
 
   It is possible to create an empty Row_impl instance and populate it using
   set() method. Such Row_impl instance does not correspond to a row received
@@ -628,7 +728,7 @@ public:
 
   Row_impl() {};
 
-  // Note: row data is copied into Row_impl instance
+  // Note: row data is not copied, Row_impl shares the row batch
 
   Row_impl(const Row_data &data, const std::shared_ptr<Meta_data_base> &md)
     : m_data(data), m_mdata(md)
@@ -660,14 +760,12 @@ public:
     if (m_mdata && pos >= m_mdata->col_count())
       throw std::out_of_range("row column");
 
-    try {
-      return m_data.at(pos).data();
-    }
-    catch (const std::out_of_range&)
-    {
-      // empty bytes indicate null value
+    // empty bytes indicate null value
+
+    if (m_data.is_null(pos))
       return bytes();
-    }
+
+    return m_data.at(pos);
   }
 
   /*
@@ -693,6 +791,60 @@ public:
     }
   }
 
+  /*
+    Get UTF8 text of a string or document field at given position directly
+    from the raw row data, without converting it to a Value. Returns false
+    if this is not possible (the field is not a UTF8 string or the row was
+    not received from the server). For null field, `data` is set to empty
+    bytes.
+
+    @throws std::out_of_range if given column does not exist in the row.
+  */
+
+  bool get_utf8(col_count_t pos, cdk::bytes &data) const
+  {
+    if (!m_mdata)
+      return false;
+
+    if (pos >= m_mdata->col_count())
+      throw std::out_of_range("row column");
+
+    if (m_data.is_null(pos))
+    {
+      data = cdk::bytes();
+      return true;
+    }
+
+    const Format_info &fi = m_mdata->get_format(pos);
+
+    switch (fi.m_type)
+    {
+    case cdk::TYPE_STRING:
+      if (!is_utf8(fi.get<cdk::TYPE_STRING>().m_format))
+        return false;
+      break;
+
+    case cdk::TYPE_DOCUMENT:
+      // JSON documents are sent as UTF8 strings.
+      break;
+
+    default:
+      return false;
+    }
+
+    /*
+      Note: Trailing '\0' byte is used for NULL value detection and is not
+      part of the data
+    */
+
+    data = m_data.at(pos);
+
+    if (0 < data.size() && 0 == *(data.end() - 1))
+      data = cdk::bytes(data.begin(), data.end() - 1);
+
+    return true;
+  }
+
   void set(col_count_t pos, const Value &val)
   {
     m_vals.emplace(pos, val);
@@ -704,15 +856,7 @@ private:
 
   void convert_at(col_count_t pos, const Format_info &fi)
   {
-    Buffer *raw = nullptr;
-
-    try {
-      raw = &m_data.at(pos);
-    }
-    catch (const std::out_of_range&)
-    {}
-
-    if (!raw || 0 == raw->size())
+    if (m_data.is_null(pos) || 0 == m_data.at(pos).size())
     {
       // Null value
       m_vals.emplace(pos, Value());
@@ -727,7 +871,7 @@ private:
 
 #define CONVERT(T) case cdk::TYPE_##T: \
     m_vals.emplace(pos, \
-      VAL::Access::mk(raw->data(), fi.get<cdk::TYPE_##T>()) \
+      VAL::Access::mk(m_data.at(pos), fi.get<cdk::TYPE_##T>()) \
     ); \
     break;
 
@@ -768,6 +912,32 @@ using Shared_meta_data = std::shared_ptr<Meta_data_base>;
 class Result_impl_base;
 
 
+/*
+  Information collected from replies to commands which send earlier chunks
+  of an operation that was split into several commands (see
+  Op_base::add_chunk()). The result of such operation is built from the reply
+  to the last command and this information is added to it.
+*/
+
+struct Chunk_stats
+{
+  cdk::row_count_t m_affected_rows = 0;
+  cdk::row_count_t m_auto_increment = 0;
+  std::vector<std::unique_ptr<cdk::Error>> m_warnings;
+
+  // Add information from the given reply, which must be completed.
+
+  void add(cdk::Reply&);
+
+  void clear()
+  {
+    m_affected_rows = 0;
+    m_auto_increment = 0;
+    m_warnings.clear();
+  }
+};
+
+
 /*
   An abstract interface used to initialize result of an operation.
 
@@ -789,6 +959,17 @@ public:
 
   virtual cdk::Reply*      get_reply() = 0;
 
+  /*
+    Return the number of rows that the result should fetch from the server
+    in one batch. Value 0 means adaptive batch size. By default, the session
+    setting is used.
+  */
+
+  virtual row_count_t get_prefetch_size()
+  {
+    return get_session()->m_prefetch_size;
+  }
+
   /*
     A hook that can perform additional initialization of the result object
     being constructed from a Result_init instance.
@@ -853,10 +1034,30 @@ public:
 
   const Row_data *get_row();
 
+  /*
+    Move rows from the internal cache to the given vector, at most max_rows
+    of them (0 means all rows in the cache). If the cache is empty, the next
+    batch of rows is loaded first. Returns the number of rows appended to
+    the vector, which is 0 if there are no more rows.
+  */
+
+  row_count_t get_rows(std::vector<Row_data>&, row_count_t max_rows = 0);
+
   // Store all remaining rows in the internal cache.
 
   void store();
 
+  /*
+    Non-blocking variant of store(): push forward reading of the remaining
+    rows into the cache without waiting for data that has not arrived yet.
+    Returns true when all rows are stored. Until then waits_for() returns
+    the event the reading is waiting for (NULL if it can progress without
+    waiting).
+  */
+
+  bool store_cont();
+  const cdk::api::Event_info* waits_for() const;
+
   /*
     Return the number of rows remaining in the result (the rows that have been
     already fetched with get_row() are not counted).
@@ -895,6 +1096,14 @@ public:
 
   std::vector<GUID>   m_guids;
 
+  /*
+    Counts and warnings from earlier chunks of the operation, if it was sent
+    in several commands. They are included in the values reported by
+    get_affected_rows(), get_auto_increment() and get_warning_count().
+  */
+
+  Chunk_stats  m_chunks;
+
 protected:
 
 
@@ -921,6 +1130,14 @@ protected:
 
   bool m_inited = false;
 
+  /*
+    Complete preparation of the result once server reply and result
+    meta-data are available. If wait is false and they are not available
+    yet, it returns false without blocking and should be called again later.
+  */
+
+  bool init_result(bool wait);
+
   // Note: meta-data can be shared with Row instances
 
   Shared_meta_data    m_mdata;
@@ -953,11 +1170,31 @@ protected:
   cdk::Reply  *m_reply;
   cdk::Cursor *m_cursor = nullptr;
 
-  using Row_cache = std::forward_list<Row_data>;
+  /*
+    Rows are read in batches. Data of all rows of a batch is stored in
+    a single Row_batch instance (m_batch) and the cache holds Row_data
+    entries which refer to it.
+  */
+
+  using Row_cache = std::deque<Row_data>;
 
   Row_cache   m_row_cache;
   row_count_t m_row_cache_size = 0;
-  Row_cache::iterator m_cache_it;
+  std::shared_ptr<Row_batch> m_batch;
+
+  /*
+    Number of rows loaded into the cache by get_row(). If it is 0 then batch
+    size is adaptive: it is chosen so that a batch holds roughly
+    prefetch_bytes of data, based on the average row size m_row_width
+    observed in the previous batch.
+  */
+
+  row_count_t m_prefetch_size = 0;
+  size_t      m_row_width = 0;
+
+  static const size_t prefetch_bytes = 1024*1024;
+
+  row_count_t get_prefetch_size() const;
 
   /*
     Ensure some rows are loaded into the cache. If cache is not empty, it
@@ -969,10 +1206,24 @@ protected:
 
   bool load_cache(row_count_t prefetch_size = 0);
 
+  /*
+    Reading a batch of rows is started by start_rows() and, once the cursor
+    operation is completed, finished by end_rows(). Flag m_loading is true
+    in between and m_batch_rows counts rows added to the cache by the
+    current batch.
+  */
+
+  bool        m_loading = false;
+  row_count_t m_batch_rows = 0;
+
+  void start_rows(row_count_t prefetch_size);
+  void end_rows();
+
   void clear_cache()
   {
     m_row_cache.clear();
     m_row_cache_size = 0;
+    m_batch.reset();
   }
 
 
@@ -1004,14 +1255,16 @@ private:
 
   // Row_processor
 
+  // Row returned by get_row().
+
   Row_data    m_row;
 
-  bool row_begin(row_count_t)
-  {
-    m_row.clear();
-    return true;
-  }
+  // Position of the row being read inside m_batch.
+
+  size_t      m_row_begin = 0;
+  size_t      m_row_bytes = 0;
 
+  bool row_begin(row_count_t);
   void row_end(row_count_t);
 
   size_t field_begin(col_count_t pos, size_t);
@@ -1036,7 +1289,7 @@ cdk::row_count_t Result_impl_base::get_affected_rows() const
 {
   if (!m_reply)
     THROW("Attempt to get affected rows count on empty result");
-  return m_reply->affected_rows();
+  return m_chunks.m_affected_rows + m_reply->affected_rows();
 }
 
 inline
@@ -1044,6 +1297,9 @@ cdk::row_count_t Result_impl_base::get_auto_increment() const
 {
   if (!m_reply)
     THROW("Attempt to get auto increment value on empty result");
+  // Note: as for a single insert, report the value for the first chunk.
+  if (0 < m_chunks.m_auto_increment)
+    return m_chunks.m_auto_increment;
   return m_reply->last_insert_id();
 }
 
@@ -1053,7 +1309,8 @@ unsigned Result_impl_base::get_warning_count() const
   if (!m_reply)
     THROW("Attempt to get warning count for empty result");
   const_cast<Result_impl_base*>(this)->load_diagnostics();
-  return m_reply->entry_count(cdk::api::Severity::WARNING);
+  return unsigned(m_chunks.m_warnings.size())
+    + m_reply->entry_count(cdk::api::Severity::WARNING);
 }
 
 inline
@@ -1117,6 +1374,53 @@ public:
 };
 
 
+/*
+  Export of row data in Arrow C Data Interface format
+  ===================================================
+
+  Rows are exported in batches, as an Arrow struct array with one child
+  array for each result column. Values are decoded column by column, by
+  a decoder selected from column's Format_info. Column types are mapped to
+  Arrow types as follows:
+
+  - integer and BIT columns - int64 or uint64,
+  - FLOAT columns - float32, DOUBLE columns - float64,
+  - DECIMAL columns - decimal128 with column's precision and scale, or
+    float64 if the precision is above 38 digits,
+  - DATETIME and TIMESTAMP columns - timestamp with microsecond unit and
+    no time zone, DATE columns - date32, TIME columns - duration with
+    microsecond unit (TIME values can be negative or exceed 24 hours),
+  - strings and documents - utf8 (strings in other character sets are
+    converted to UTF8), SET values are given as comma separated lists
+    of their elements,
+  - other types - binary, holding the same raw bytes as values of these
+    types.
+
+  The exported structures own their data and must be released by the
+  consumer with their release callbacks.
+*/
+
+/*
+  Export schema of the current result set, using given column names.
+*/
+
+void export_arrow_schema(
+  const Meta_data_base&, const std::vector<std::string> &names,
+  ArrowSchema *out
+);
+
+/*
+  Export next batch of at most max_rows rows (0 means rows that are in
+  the cache, see Result_impl_base::get_rows()). Returns the number of
+  exported rows. If there are no more rows, 0 is returned and nothing is
+  exported (out->release is set to NULL).
+*/
+
+row_count_t export_arrow_batch(
+  Result_impl_base&, row_count_t max_rows, ArrowArray *out
+);
+
+
 }}  // mysqlx::common namespace
 
 #endif
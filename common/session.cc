@@ -100,6 +100,25 @@ TLS_options::SSL_MODE get_ssl_mode(unsigned m)
 }
 
 
+TCPIP_options::compression_mode_t get_compression(unsigned m)
+{
+  using DevAPI_type = Settings_impl::Compression_mode;
+
+  switch (DevAPI_type(m))
+  {
+  case DevAPI_type::DISABLED:  return TCPIP_options::COMPRESSION_DISABLED;
+  case DevAPI_type::PREFERRED: return TCPIP_options::COMPRESSION_PREFERRED;
+  case DevAPI_type::REQUIRED:  return TCPIP_options::COMPRESSION_REQUIRED;
+
+  default:
+    // Note: caller should ensure that argument has correct value
+    assert(false);
+  }
+
+  return TCPIP_options::COMPRESSION_DISABLED; // quiet compiler warnings
+}
+
+
 /*
   Initialize CDK connection options based on session settings.
   If socket is true, we are preparing options for a connection
@@ -184,6 +203,13 @@ void prepare_options(
     );
   }
 
+  // Set compression options
+
+  if (settings.has_option(Option::COMPRESSION))
+    opts.set_compression(get_compression(
+      (unsigned)settings.get(Option::COMPRESSION).get_uint()
+    ));
+
 }
 
 
@@ -349,9 +375,275 @@ void Settings_impl::get_data_source(cdk::ds::Multi_source &src)
 
 void Session_impl::prepare_for_cmd()
 {
-  if (m_current_result)
-    m_current_result->store();
-  m_current_result = nullptr;
+  /*
+    Deallocate released prepared statements. Replies are kept in
+    m_dealloc_replies and consumed only when reply to a later command is
+    read (see prepare_for_reply()), so that sending the command does not
+    wait for them.
+  */
+
+  std::vector<uint32_t> stmt_ids;
+  stmt_ids.swap(m_stmt_dealloc);
+
+  for (uint32_t stmt_id : stmt_ids)
+  {
+    m_dealloc_replies.emplace_back(
+      new cdk::Reply(m_sess.prepared_deallocate(stmt_id))
+    );
+  }
+}
+
+
+void Session_impl::prepare_for_reply()
+{
+  /*
+    Note: Result is removed from the list before storing it, so that we do
+    not try to store it again if storing fails.
+  */
+
+  while (!m_results.empty())
+  {
+    Result_impl_base *res = m_results.front();
+    m_results.pop_front();
+    res->store();
+  }
+
+  /*
+    Replies to deallocate requests precede reply to the current command.
+    Deleting them makes CDK skip them when their turn comes - errors are
+    ignored because the statements are not used any more anyway.
+  */
+
+  m_dealloc_replies.clear();
+}
+
+
+bool Session_impl::prepare_for_reply_cont()
+{
+  /*
+    Note: A result de-registers itself when all its rows are read. It is
+    removed from the list also if reading them fails.
+  */
+
+  while (!m_results.empty())
+  {
+    Result_impl_base *res = m_results.front();
+
+    try {
+      if (!res->store_cont())
+        return false;
+    }
+    catch (...)
+    {
+      deregister_result(res);
+      throw;
+    }
+
+    deregister_result(res);
+  }
+
+  m_dealloc_replies.clear();
+  return true;
+}
+
+
+const cdk::api::Event_info* Session_impl::results_waits_for() const
+{
+  if (m_results.empty())
+    return nullptr;
+  return m_results.front()->waits_for();
+}
+
+
+// ---------------------------------------------------------------------------
+
+
+Session_pool::Session_pool(const Settings_impl &settings)
+  : m_settings(settings)
+{
+  using Option = Settings_impl::Option;
+
+  if (m_settings.has_option(Option::POOL_MAX_SIZE))
+    m_max_size = (size_t)m_settings.get(Option::POOL_MAX_SIZE).get_uint();
+
+  if (0 == m_max_size)
+    throw_error("POOL_MAX_SIZE must be greater than 0");
+
+  if (m_settings.has_option(Option::POOL_QUEUE_TIMEOUT))
+    m_queue_timeout = std::chrono::milliseconds(
+      m_settings.get(Option::POOL_QUEUE_TIMEOUT).get_uint()
+    );
+
+  if (m_settings.has_option(Option::POOL_MAX_IDLE_TIME))
+    m_max_idle_time = std::chrono::milliseconds(
+      m_settings.get(Option::POOL_MAX_IDLE_TIME).get_uint()
+    );
+}
+
+
+Session_pool::~Session_pool()
+{
+  try {
+    close();
+  }
+  catch (...)
+  {}
+}
+
+
+void Session_pool::close()
+{
+  std::list<Idle_session> idle;
+
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_closed = true;
+    idle.swap(m_idle);
+  }
+
+  // Wake up threads waiting for a session so that they can report error.
+
+  m_cond.notify_all();
+
+  // Note: idle sessions are closed here, outside of the critical section.
+}
+
+
+/*
+  Move sessions which were idle for too long to the given list. Called with
+  the pool mutex locked. The expired sessions should be deleted after
+  releasing the lock.
+*/
+
+void Session_pool::remove_expired(std::list<Idle_session> &expired)
+{
+  if (0 == m_max_idle_time.count())
+    return;
+
+  auto limit = clock::now() - m_max_idle_time;
+
+  // Note: the least recently used sessions are at the end of the list.
+
+  while (!m_idle.empty() && m_idle.back().m_since < limit)
+    expired.splice(expired.end(), m_idle, std::prev(m_idle.end()));
+}
+
+
+std::shared_ptr<Session_impl> Session_pool::get_session()
+{
+  std::list<Idle_session> expired;
+  std::unique_ptr<Session_impl> sess;
+  cdk::ds::Multi_source source;
+  auto deadline = clock::now() + m_queue_timeout;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+      if (m_closed)
+        throw_error("Client is closed");
+
+      remove_expired(expired);
+
+      if (!m_idle.empty())
+      {
+        sess = std::move(m_idle.front().m_sess);
+        m_idle.pop_front();
+        break;
+      }
+
+      if (m_in_use < m_max_size)
+      {
+        m_settings.get_data_source(source);
+        break;
+      }
+
+      if (0 == m_queue_timeout.count())
+      {
+        m_cond.wait(lock);
+        continue;
+      }
+
+      if (clock::now() >= deadline)
+        throw_error("Timeout reached when getting session from the pool");
+
+      m_cond.wait_until(lock, deadline);
+    }
+
+    ++m_in_use;
+  }
+
+  /*
+    Create new session if there was no idle one. This is done outside of
+    the critical section so that other threads are not blocked while
+    connecting to the server.
+  */
+
+  if (!sess)
+  try {
+    sess.reset(new Session_impl(source, m_settings));
+  }
+  catch (...)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      --m_in_use;
+    }
+    m_cond.notify_one();
+    throw;
+  }
+
+  auto pool = shared_from_this();
+
+  return std::shared_ptr<Session_impl>(
+    sess.release(),
+    [pool](Session_impl *sess) { pool->release(sess); }
+  );
+}
+
+
+/*
+  Called when the last reference to a session obtained from the pool is
+  released. The session is reset and put back into the pool. If reset fails
+  (for example because the connection is broken) or the pool was closed in
+  the meantime, the session is deleted instead.
+*/
+
+void Session_pool::release(Session_impl *ptr)
+{
+  try {
+
+    std::unique_ptr<Session_impl> sess(ptr);
+    bool keep = false;
+
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      keep = !m_closed;
+    }
+
+    if (keep)
+    try {
+      sess->reset();
+    }
+    catch (...)
+    {
+      keep = false;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      --m_in_use;
+      if (keep && !m_closed)
+        m_idle.push_front({ std::move(sess), clock::now() });
+    }
+
+    m_cond.notify_one();
+  }
+  catch (...)
+  {
+    // Note: errors can not be reported from shared pointer deleter.
+  }
 }
 
 
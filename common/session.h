@@ -38,6 +38,13 @@
 #include <mysqlx/common.h>
 #include <mysql/cdk.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 
 namespace mysqlx {
 namespace common {
@@ -60,16 +67,51 @@ public:
   cdk::Session  m_sess;
   string        m_default_db;
 
-  Session_impl(cdk::ds::Multi_source &ms)
+  /*
+    Default number of rows fetched in one batch when reading results, as
+    given by PREFETCH_SIZE session option. Value 0 means adaptive batch
+    size (see Result_impl_base::get_prefetch_size()).
+  */
+
+  cdk::row_count_t m_prefetch_size = 0;
+
+  /*
+    Approximate limit on the size of a single insert message, as given by
+    MAX_INSERT_SIZE session option. Insert operations with more data are sent
+    to the server in several messages. Value 0 (the default) means no limit.
+
+    Note: Messages are executed by the server as independent statements, so
+    splitting is off by default - an insert which fails in a later message
+    leaves rows from earlier messages inserted (unless a transaction is
+    rolled back).
+  */
+
+  size_t m_max_insert_size = 0;
+
+  Session_impl(cdk::ds::Multi_source &ms, const Settings_impl &settings)
     : m_sess(ms)
   {
+    using Option = Settings_impl::Option;
+
+    if (settings.has_option(Option::PREFETCH_SIZE))
+      m_prefetch_size = settings.get(Option::PREFETCH_SIZE).get_uint();
+
+    if (settings.has_option(Option::MAX_INSERT_SIZE))
+      m_max_insert_size =
+        (size_t)settings.get(Option::MAX_INSERT_SIZE).get_uint();
+
     if (m_sess.get_default_schema())
       m_default_db = *m_sess.get_default_schema();
     if (!m_sess.is_valid())
       m_sess.get_error().rethrow();
   }
 
-  Result_impl_base *m_current_result = nullptr;
+  /*
+    Results registered with the session, in the order in which the
+    corresponding commands were sent to the server (see register_result()).
+  */
+
+  std::list<Result_impl_base*> m_results;
 
   virtual ~Session_impl()
   {
@@ -81,7 +123,7 @@ public:
         to it is deleted
       - results de-register themselves before being destroyed.
     */
-    assert(!m_current_result);
+    assert(m_results.empty());
 
     // TODO: rollback an on-going transaction, if any?
   }
@@ -91,33 +133,175 @@ public:
     Result objects should register itself with the session and de-register
     when all result data is consumed (this is also the case when result object
     is deleted).
+
+    Several commands can be sent to the server before replies to earlier
+    commands are consumed. Server replies are read in the same order in
+    which commands were sent, so before reading reply to a new command,
+    results of the earlier commands are cached (see prepare_for_reply()).
   */
 
   void register_result(Result_impl_base *result)
   {
-    assert(!m_current_result);
-    m_current_result = result;
+    m_results.push_back(result);
   }
 
   void deregister_result(Result_impl_base *result)
   {
-    if (result == m_current_result)
-      m_current_result = nullptr;
+    m_results.remove(result);
   }
 
   /*
-    Prepare session for sending new command. This caches the current result,
-    if one is registered with session.
+    Prepare session for sending new command. This does not wait for replies
+    to previous commands, which can be still consumed after the new command
+    was sent.
   */
 
   void prepare_for_cmd();
 
+  /*
+    Prepare session for reading reply to the most recent command. This caches
+    all results registered with the session.
+  */
+
+  void prepare_for_reply();
+
+  /*
+    Non-blocking variant of prepare_for_reply(): push forward caching of
+    the registered results without waiting. Returns true when all of them
+    are cached. Until then results_waits_for() returns the event for which
+    caching is waiting.
+  */
+
+  bool prepare_for_reply_cont();
+
+  bool has_results() const
+  {
+    return !m_results.empty();
+  }
+
+  const cdk::api::Event_info* results_waits_for() const;
+
   unsigned long m_savepoint = 0;
 
   unsigned long next_savepoint()
   {
     return ++m_savepoint;
   }
+
+  /*
+    Server-side prepared statements (see Op_base).
+
+    Statement ids are allocated by the session. Released statements are
+    deallocated on the server when the next command is sent (see
+    prepare_for_cmd()) and replies to these requests are kept in
+    m_dealloc_replies until reply to a later command is read. Flag
+    m_prepare_supported is cleared if server turns out to not support
+    prepared statements.
+  */
+
+  bool     m_prepare_supported = true;
+  uint32_t m_last_stmt_id = 0;
+  std::vector<uint32_t> m_stmt_dealloc;
+  std::list<std::unique_ptr<cdk::Reply>> m_dealloc_replies;
+
+  uint32_t create_stmt_id()
+  {
+    if (0 == ++m_last_stmt_id)
+      ++m_last_stmt_id;
+    return m_last_stmt_id;
+  }
+
+  void release_stmt_id(uint32_t stmt_id)
+  {
+    m_stmt_dealloc.push_back(stmt_id);
+  }
+
+  /*
+    Reset session so that it can be re-used as if it was a new one (see
+    Session_pool). There must be no registered result when this is called.
+  */
+
+  void reset()
+  {
+    assert(m_results.empty());
+    m_dealloc_replies.clear();
+    m_sess.reset();
+    m_savepoint = 0;
+
+    // Server releases all prepared statements when session is reset.
+
+    m_stmt_dealloc.clear();
+  }
+};
+
+
+/*
+  Pool of sessions which share the same settings, used to implement
+  client objects of public APIs.
+
+  Sessions are handed out as shared pointers to Session_impl. When the last
+  reference to such session is released, the session is reset and returned
+  to the pool instead of being closed, so that it can be re-used without
+  creating a new connection. Session_pool methods can be called from
+  different threads.
+
+  Pool parameters are given by POOL_XXX options in the settings used to
+  create the pool. Session pool must be created with std::make_shared<>()
+  because returned sessions keep a reference to it.
+*/
+
+class Session_pool
+  : public std::enable_shared_from_this<Session_pool>
+{
+public:
+
+  using clock = std::chrono::steady_clock;
+
+  Session_pool(const Settings_impl&);
+  ~Session_pool();
+
+  /*
+    Get a session from the pool. The most recently used idle session is
+    re-used if available. Otherwise a new session is created if the pool is
+    not full. If it is full, wait until some session is returned to the pool
+    or until queue timeout expires, in which case error is thrown.
+  */
+
+  std::shared_ptr<Session_impl> get_session();
+
+  /*
+    Close all idle sessions in the pool. Sessions that are in use are closed
+    when they are released. Further attempts to get a session from a closed
+    pool throw error.
+  */
+
+  void close();
+
+private:
+
+  Settings_impl m_settings;
+
+  size_t m_max_size = 25;
+  std::chrono::milliseconds m_queue_timeout{0};
+  std::chrono::milliseconds m_max_idle_time{0};
+
+  struct Idle_session
+  {
+    std::unique_ptr<Session_impl> m_sess;
+    clock::time_point m_since;
+  };
+
+  std::mutex  m_mutex;
+  std::condition_variable m_cond;
+
+  // Idle sessions, the most recently used one first.
+
+  std::list<Idle_session> m_idle;
+  size_t m_in_use = 0;
+  bool   m_closed = false;
+
+  void release(Session_impl*);
+  void remove_expired(std::list<Idle_session>&);
 };
 
 
@@ -161,6 +161,13 @@ private:
     set_option<OPT>((unsigned)val);
   }
 
+  /*
+    Convert string value of a numeric option, such as one given in
+    a connection string, to a number.
+  */
+
+  static unsigned str_to_uint(Option, const std::string&);
+
 
   // Any processor
 
@@ -528,6 +535,143 @@ Settings_impl::Setter::set_option<Settings_impl::Option::AUTH>(
 }
 
 
+// Compression of protocol messages.
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::COMPRESSION>(
+  const unsigned &val
+)
+{
+  if (0 == val || val >= size_t(Compression_mode::LAST))
+    throw_error("Invalid compression mode");
+  add_option(Option::COMPRESSION, val);
+}
+
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::COMPRESSION>(
+  const std::string &val
+)
+{
+  using std::map;
+
+#define COMPRESSION_MAP(X,N) { #X, Compression_mode::X },
+
+  static map< std::string, Compression_mode > mode_map{
+    COMPRESSION_MODE_LIST(COMPRESSION_MAP)
+  };
+
+  try {
+
+    Compression_mode m = mode_map.at(to_upper(val));
+    set_option<Option::COMPRESSION>(unsigned(m));
+    return;
+  }
+  catch (const std::out_of_range&)
+  {
+    std::string msg = "Invalid compression mode: " + val;
+    throw_error(msg.c_str());
+    // Quiet compiler warnings
+    return;
+  }
+}
+
+
+// Numeric options which can be given as strings.
+
+inline unsigned
+Settings_impl::Setter::str_to_uint(Option opt, const std::string &val)
+{
+  if (val.empty() || std::string::npos != val.find_first_not_of("0123456789"))
+  {
+    std::string msg = "Invalid value of option ";
+    msg += option_name(opt);
+    msg += ": " + val;
+    throw_error(msg.c_str());
+  }
+
+  uint64_t num = val.length() > 10 ? UINT64_MAX : std::stoull(val);
+
+  if (!check_num_limits<unsigned>(num))
+  {
+    std::string msg = "Value of option ";
+    msg += option_name(opt);
+    msg += " too big";
+    throw_error(msg.c_str());
+  }
+
+  return unsigned(num);
+}
+
+
+// Row prefetch size.
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::PREFETCH_SIZE>(
+  const std::string &val
+)
+{
+  if ("AUTO" == to_upper(val))
+  {
+    add_option(Option::PREFETCH_SIZE, 0U);
+    return;
+  }
+
+  add_option(Option::PREFETCH_SIZE, str_to_uint(Option::PREFETCH_SIZE, val));
+}
+
+
+// Client pool settings.
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::POOL_MAX_SIZE>(
+  const std::string &val
+)
+{
+  add_option(Option::POOL_MAX_SIZE, str_to_uint(Option::POOL_MAX_SIZE, val));
+}
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::POOL_QUEUE_TIMEOUT>(
+  const std::string &val
+)
+{
+  add_option(
+    Option::POOL_QUEUE_TIMEOUT, str_to_uint(Option::POOL_QUEUE_TIMEOUT, val)
+  );
+}
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::POOL_MAX_IDLE_TIME>(
+  const std::string &val
+)
+{
+  add_option(
+    Option::POOL_MAX_IDLE_TIME, str_to_uint(Option::POOL_MAX_IDLE_TIME, val)
+  );
+}
+
+
+// Insert message size limit.
+
+template<>
+inline void
+Settings_impl::Setter::set_option<Settings_impl::Option::MAX_INSERT_SIZE>(
+  const std::string &val
+)
+{
+  add_option(
+    Option::MAX_INSERT_SIZE, str_to_uint(Option::MAX_INSERT_SIZE, val)
+  );
+}
+
+
 // Other options that need special handling.
 // TODO: support std::string for PWD and other options that are ascii only?
 
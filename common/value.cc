@@ -33,6 +33,8 @@
 #include "value.h"
 
 #include <string>
+#include <sstream>
+#include <locale>
 
 /*
   Implementation of result and row objects and conversion of raw bytes
@@ -55,11 +57,104 @@ void Value::print(std::ostream &out) const
   case STRING: out << (std::string)m_str; return;
   case WSTRING: out << cdk::string(m_wstr); return;
   case RAW: out << "<" << m_str.length() << " raw bytes>"; return;
+  case DECIMAL: out << get_decimal(); return;
   default:  out << "<unknown value>"; return;
   }
 }
 
 
+/*
+  Decimal
+  -------
+  The 128-bit value is split into 32-bit limbs for the decimal conversion,
+  which is then done using 64-bit arithmetic.
+*/
+
+std::string Decimal::str() const
+{
+  uint32_t limbs[4] = {
+    (uint32_t)(m_high >> 32), (uint32_t)m_high,
+    (uint32_t)(m_low >> 32), (uint32_t)m_low
+  };
+
+  // Digits of the value, least significant first.
+
+  std::string digits;
+
+  for (bool non_zero = true; non_zero;)
+  {
+    // Divide by 10^9 and take the remainder as the next 9 digits.
+
+    uint64_t rem = 0;
+    non_zero = false;
+
+    for (uint32_t &limb : limbs)
+    {
+      uint64_t cur = (rem << 32) | limb;
+      limb = (uint32_t)(cur / 1000000000);
+      rem = cur % 1000000000;
+      non_zero = non_zero || (0 != limb);
+    }
+
+    for (unsigned i = 0; i < 9; ++i)
+    {
+      digits.push_back((char)('0' + rem % 10));
+      rem /= 10;
+    }
+  }
+
+  // Strip leading zeros, but keep at least one digit before decimal point.
+
+  size_t len = digits.find_last_not_of('0') + 1;
+  if (len < m_scale + 1)
+    len = m_scale + 1;
+  digits.resize(len, '0');
+
+  std::string out;
+  out.reserve(len + 2);
+
+  if (m_negative)
+    out.push_back('-');
+
+  for (size_t pos = len; pos > 0; --pos)
+  {
+    if (pos == m_scale)
+      out.push_back('.');
+    out.push_back(digits[pos - 1]);
+  }
+
+  return out;
+}
+
+
+double Decimal::get_double() const
+{
+  static const double pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  /*
+    If both the unscaled value and the power of 10 are exactly representable
+    as doubles, a single division gives correctly rounded result. Otherwise
+    the decimal string is parsed.
+  */
+
+  if (0 == m_high && m_low < (1ULL << 53) && m_scale <= 22)
+  {
+    double val = (double)m_low / pow10[m_scale];
+    return m_negative ? -val : val;
+  }
+
+  std::istringstream in(str());
+  in.imbue(std::locale::classic());
+
+  double val;
+  in >> val;
+  return val;
+}
+
+
 // Trivial Format_info for raw byte values
 
 class Raw_format_info
@@ -87,6 +182,7 @@ void Value::Access::process_val(
     case Value::UINT64:    prc.num(val.get_uint()); break;
     case Value::FLOAT:   prc.num(val.get_float()); break;
     case Value::DOUBLE:  prc.num(val.get_double()); break;
+    case Value::DECIMAL: prc.num(val.get_double()); break;
     case Value::BOOL:    prc.yesno(val.get_bool()); break;
     case Value::STRING:  prc.str(val.get_string()); break;
     case Value::WSTRING:  prc.str(val.get_wstring()); break;
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <mysqlx/xdevapi.h>
+#include <mysql/cdk.h>
+
+#include <list>
+
+#include "impl.h"
+
+
+using namespace ::mysqlx;
+
+
+/*
+  Event loop implementation
+  =========================
+
+  Asynchronous executions are registered with the CDK event loop using
+  Async_exec adapters which implement CDK asynchronous operation interface
+  on top of the implementation of the executed operation. The CDK loop calls
+  cont() on the operation only when the event reported by its waits_for()
+  (usually data arriving on the session socket) has happened.
+*/
+
+namespace mysqlx {
+namespace internal {
+
+
+class Event_loop_impl
+{
+  class Async_exec
+    : public cdk::api::Async_op<void>
+  {
+    Shared_async_state m_state;
+
+  public:
+
+    std::function<void()> m_callback;
+
+    Async_exec(const Shared_async_state &state,
+               const std::function<void()> &callback)
+      : m_state(state), m_callback(callback)
+    {}
+
+    bool is_completed() const override
+    {
+      return m_state->m_done;
+    }
+
+    /*
+      Errors thrown by the operation are caught by CDK loop and reported
+      to the loop callback (see add() below).
+    */
+
+    bool do_cont() override
+    {
+      m_state->m_done = m_state->m_impl->cont();
+      return m_state->m_done;
+    }
+
+    void do_wait() override
+    {
+      m_state->wait();
+    }
+
+    void do_cancel() override
+    {
+      THROW("Canceling asynchronous execution is not supported");
+    }
+
+    const cdk::api::Event_info* get_event_info() const override
+    {
+      return m_state->m_impl->waits_for();
+    }
+
+    friend Event_loop_impl;
+  };
+
+  cdk::Event_loop m_loop;
+  std::list<Async_exec> m_ops;
+
+public:
+
+  void add(const Shared_async_state &state,
+           const std::function<void()> &callback)
+  {
+    m_ops.emplace_back(state, callback);
+    auto it = std::prev(m_ops.end());
+
+    /*
+      Note: The adapter is removed from the list before calling the callback
+      because the callback can add new operations to the loop. This is safe
+      because CDK loop does not access the operation after it completed.
+    */
+
+    m_loop.add(*it, [this, it](std::exception_ptr error) {
+
+      std::function<void()> callback = std::move(it->m_callback);
+      Async_state &state = *it->m_state;
+
+      if (error)
+        state.m_error = error;
+      state.m_done = true;
+
+      Shared_async_state keep = it->m_state;
+      m_ops.erase(it);
+
+      callback();
+    });
+  }
+
+  bool run_once(int timeout)
+  {
+    return m_loop.run_once(timeout);
+  }
+
+  void run()
+  {
+    m_loop.run();
+  }
+
+  size_t size() const
+  {
+    return m_loop.size();
+  }
+};
+
+
+Event_loop_detail::Event_loop_detail()
+  : m_impl(std::make_shared<Event_loop_impl>())
+{}
+
+
+void
+Event_loop_detail::add(const Shared_async_state &state,
+                       const std::function<void()> &callback)
+{
+  assert(state);
+  m_impl->add(state, callback);
+}
+
+
+bool Event_loop_detail::run_once(int timeout)
+{
+  return m_impl->run_once(timeout);
+}
+
+
+void Event_loop_detail::run()
+{
+  m_impl->run();
+}
+
+
+size_t Event_loop_detail::size() const
+{
+  return m_impl->size();
+}
+
+
+}}  // mysqlx::internal
@@ -298,19 +298,19 @@ public:
 
   /*
     Callbacks for scalar values store the value under
-    key given by m_key.
+    key given by m_key. If a key is repeated, the last value is used.
   */
 
-  void null() { m_map.emplace(m_key, Value()); }
+  void null() { m_map[m_key] = Value(); }
   void str(const cdk::string &val)
   {
-    m_map.emplace(m_key, mysqlx::string(val));
+    m_map[m_key] = Value(mysqlx::string(val));
   }
-  void num(uint64_t val)  { m_map.emplace(m_key, val); }
-  void num(int64_t val)   { m_map.emplace(m_key, val); }
-  void num(float val)     { m_map.emplace(m_key, val); }
-  void num(double val)    { m_map.emplace(m_key, val); }
-  void yesno(bool val)    { m_map.emplace(m_key, val); }
+  void num(uint64_t val)  { m_map[m_key] = Value(val); }
+  void num(int64_t val)   { m_map[m_key] = Value(val); }
+  void num(float val)     { m_map[m_key] = Value(val); }
+  void num(double val)    { m_map[m_key] = Value(val); }
+  void yesno(bool val)    { m_map[m_key] = Value(val); }
 
 };
 
@@ -320,9 +320,135 @@ void DbDoc::Impl::JSONDoc::prepare()
   if (m_parsed)
     return;
 
+  scan();
+
+  if (m_parsed)
+    return;
+
+  // Load fields which were not accessed yet.
+
+  for (const auto &entry : m_index)
+  {
+    if (m_map.end() == m_map.find(entry.first))
+      load(entry.first, entry.second);
+  }
+
+  m_index.clear();
+  m_parsed = true;
+}
+
+
+bool DbDoc::Impl::JSONDoc::prepare_field(const Field &fld)
+{
+  if (m_map.end() != m_map.find(fld))
+    return true;
+
+  if (m_parsed)
+    return false;
+
+  scan();
+
+  // Note: scan() could fall back to full parsing of the document.
+
+  if (m_parsed)
+    return m_map.end() != m_map.find(fld);
+
+  auto it = m_index.find(fld);
+
+  if (m_index.end() == it)
+    return false;
+
+  load(it->first, it->second);
+  return true;
+}
+
+
+/*
+  Scan the JSON string till the end, adding found fields to m_index. Does
+  nothing if the string was already scanned.
+
+  The whole string must be scanned before a field can be looked up because
+  if a key is repeated, the last value is used (as does the server).
+
+  If there is a problem with scanning the string, the whole document is
+  parsed instead.
+*/
+
+void DbDoc::Impl::JSONDoc::scan()
+{
+  const char *json = m_json.data();
+
+  while (m_scanner.next())
+  {
+    cdk::bytes key = m_scanner.key();
+    cdk::bytes val = m_scanner.value();
+
+    std::string name;
+
+    if (m_scanner.plain_key())
+      name.assign(key.begin(), key.end());
+    else
+    {
+      // Use JSON parser to decode escape sequences in the key.
+
+      std::string quoted((const char*)key.begin() - 1, key.size() + 2);
+      name = Value::Access::mk_from_json(quoted).get<std::string>();
+    }
+
+    m_index[Field(mysqlx::string(name))] =
+      Range((const char*)val.begin() - json, (const char*)val.end() - json);
+  }
+
+  if (m_scanner.failed())
+    parse();
+}
+
+
+/*
+  Parse value of the given field and store it in the map.
+*/
+
+void DbDoc::Impl::JSONDoc::load(const Field &fld, const Range &pos)
+{
+  std::string val(m_json, pos.first, pos.second - pos.first);
+
+  if ('{' == val[0])
+  {
+    m_map.emplace(fld, Value(DbDoc(val)));
+    return;
+  }
+
+  /*
+    String without escape sequences is stored as UTF8 string, without
+    parsing it.
+  */
+
+  if ('"' == val[0] && val.find_first_of("\"\\", 1) == val.size() - 1)
+  {
+    m_map.emplace(fld, Value(val.substr(1, val.size() - 2)));
+    return;
+  }
+
+  m_map.emplace(fld, Value::Access::mk_from_json(val));
+}
+
+
+/*
+  Parse the whole document with the full JSON parser. Fields which were
+  already loaded are not replaced, so that references to them remain valid.
+*/
+
+void DbDoc::Impl::JSONDoc::parse()
+{
+  DbDoc::Impl doc;
   cdk::Codec<cdk::TYPE_DOCUMENT> codec;
-  Builder bld(*this);
+  Builder bld(doc);
   codec.from_bytes(cdk::bytes(m_json), bld);
+
+  for (auto &entry : doc.m_map)
+    m_map.emplace(entry.first, std::move(entry.second));
+
+  m_index.clear();
   m_parsed = true;
 }
 
@@ -39,6 +39,7 @@
 #include <mysql/cdk.h>
 #include <mysql/cdk/converters.h>
 #include <expr_parser.h>
+#include <json_parser.h>
 
 #include <map>
 #include <memory>
@@ -274,6 +275,18 @@ class DbDoc::Impl
 
   virtual void prepare() {}
 
+  /*
+    Make sure that the given field, if present in the document, is stored
+    in the map. Returns false if there is no such field. Unlike prepare(),
+    this does not need to load all fields of the document.
+  */
+
+  virtual bool prepare_field(const Field &fld)
+  {
+    prepare();
+    return m_map.end() != m_map.find(fld);
+  }
+
   // Data storage
 
   typedef std::map<Field, Value> Map;
@@ -281,13 +294,12 @@ class DbDoc::Impl
 
   bool has_field(const Field &fld)
   {
-    prepare();
-    return m_map.end() != m_map.find(fld);
+    return prepare_field(fld);
   }
 
   const Value& get(const Field &fld) const
   {
-    const_cast<Impl*>(this)->prepare();
+    const_cast<Impl*>(this)->prepare_field(fld);
     return m_map.at(fld);
   }
 
@@ -318,6 +330,17 @@ class DbDoc::Impl
 /*
   DbDoc::Impl specialization which takes document data from
   a JSON string.
+
+  The document is not parsed up-front. When a field is looked up for the
+  first time, the JSON string is scanned (using parser::JSON_doc_scanner)
+  and positions of field values are stored in m_index. Only the value of
+  the requested field is parsed and stored in the map. Sub-documents are
+  stored as JSONDoc instances over the corresponding part of the string,
+  so they are also parsed only when accessed.
+
+  Iterating over fields loads all of them (prepare()). If the scanner can
+  not handle the JSON string, the whole document is parsed with the full
+  JSON parser.
 */
 
 class DbDoc::Impl::JSONDoc
@@ -326,14 +349,28 @@ class DbDoc::Impl::JSONDoc
   std::string m_json;
   bool m_parsed;
 
+  // Positions of field values in m_json found so far.
+
+  typedef std::pair<size_t, size_t>  Range;
+  typedef std::map<Field, Range>     Index;
+  Index m_index;
+
+  parser::JSON_doc_scanner m_scanner;
+
+  void scan();
+  void load(const Field&, const Range&);
+  void parse();
+
 public:
 
   JSONDoc(const std::string &json)
     : m_json(json)
     , m_parsed(false)
+    , m_scanner(cdk::bytes(m_json))
   {}
 
   void prepare();
+  bool prepare_field(const Field&);
 
   void print(std::ostream &out) const
   {
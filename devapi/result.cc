@@ -383,11 +383,30 @@ col_count_t internal::Row_detail::col_count() const
 
 bytes internal::Row_detail::get_bytes(col_count_t pos) const
 {
-  cdk::bytes data = get_impl().m_data.at(pos).data();
+  cdk::bytes data = get_impl().m_data.at(pos);
   return mysqlx::bytes::Access::mk(data);
 }
 
 
+utf8_view internal::Row_detail::get_utf8(col_count_t pos) const
+{
+  Impl &impl = const_cast<Row_detail*>(this)->get_impl();
+  cdk::bytes data;
+
+  if (impl.get_utf8(pos, data))
+    return{ (const char*)data.begin(), data.size() };
+
+  // Otherwise get UTF8 string stored in the converted value.
+
+  const Value &val = impl.get(pos);
+
+  if (val.isNull())
+    return{};
+
+  return val.getUtf8();
+}
+
+
 mysqlx::Value& internal::Row_detail::get_val(mysqlx::col_count_t pos)
 {
   return get_impl().get(pos);
@@ -631,6 +650,28 @@ row_count_t internal::Row_result_detail<Columns>::row_count()
 }
 
 
+template<>
+void internal::Row_result_detail<Columns>::export_schema(ArrowSchema *out)
+{
+  auto &impl = get_impl();
+  std::vector<std::string> names;
+
+  for (col_count_t pos = 0; pos < impl.get_col_count(); ++pos)
+    names.emplace_back(impl.get_column(pos).m_label);
+
+  common::export_arrow_schema(*impl.get_mdata(), names, out);
+}
+
+
+template<>
+row_count_t internal::Row_result_detail<Columns>::export_batch(
+  ArrowArray *out, row_count_t max_rows
+)
+{
+  return common::export_arrow_batch(get_impl(), max_rows, out);
+}
+
+
 /*
   DocResult
   =========
@@ -645,7 +686,7 @@ bool internal::Doc_result_detail::iterator_next()
     return false;
 
   // @todo Avoid copying of document string.
-  cdk::foundation::bytes data = row->at(0).data();
+  cdk::foundation::bytes data = row->at(0);
   m_cur_doc = DbDoc(std::string(data.begin(),data.end()-1));
   return true;
 }
@@ -93,13 +93,23 @@ internal::Session_detail::Session_detail(common::Settings_impl &settings)
 
     cdk::ds::Multi_source source;
     settings.get_data_source(source);
-    m_impl = std::make_shared<Impl>(source);
+    m_impl = std::make_shared<Impl>(source, settings);
 
   }
   CATCH_AND_WRAP
 }
 
 
+internal::Session_detail::Session_detail(const Shared_session_pool &pool)
+{
+  try {
+    assert(pool);
+    m_impl = pool->get_session();
+  }
+  CATCH_AND_WRAP
+}
+
+
 //Session::Session(Session* master)
 //{
 //  assert(master);
@@ -148,6 +158,39 @@ void internal::Session_detail::close()
 
 
 
+// ---------------------------------------------------------------------
+
+/*
+  Client implementation
+  =====================
+*/
+
+
+internal::Client_detail::Client_detail(common::Settings_impl &settings)
+{
+  try {
+    m_impl = std::make_shared<common::Session_pool>(settings);
+  }
+  CATCH_AND_WRAP
+}
+
+
+const internal::Shared_session_pool& internal::Client_detail::get_pool()
+{
+  if (!m_impl)
+    throw Error("Client closed");
+  return m_impl;
+}
+
+
+void internal::Client_detail::close()
+{
+  if (m_impl)
+    m_impl->close();
+  m_impl.reset();
+}
+
+
 // ---------------------------------------------------------------------
 
 /*
@@ -320,7 +363,7 @@ internal::Schema_detail::Table_src::iterator_get()
 
   cdk::string type;
   m_res->get_column(1).get<cdk::TYPE_STRING>()
-    .m_codec.from_bytes(row->at(1).data(), type);
+    .m_codec.from_bytes(row->at(1), type);
 
   return Table(m_schema, Name_src::iterator_get(), type == L"VIEW");
 }
@@ -346,7 +389,7 @@ string internal::Query_src::iterator_get()
   auto *row = static_cast<const common::Row_data*>(m_row);
 
   const auto &name_col = m_res->get_column(0);
-  const auto &data = row->at(0).data();
+  const auto data = row->at(0);
   cdk::string name;
 
   // TDOD: Investigate why we get column type other than STRING.
@@ -1669,6 +1669,211 @@ TEST_F(Crud, buffered)
 }
 
 
+/*
+  Rows are fetched in batches whose size is given by PREFETCH_SIZE session
+  option or set per statement. Check that all rows are returned regardless
+  of the batch size.
+*/
+
+TEST_F(Crud, prefetch)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Preparing collection..." << endl;
+
+  Collection coll = get_sess().createSchema("test", true)
+                              .createCollection("coll", true);
+
+  coll.remove("true").execute();
+
+  {
+    CollectionAdd add(coll);
+    for (int i = 0; i < 1000; ++i)
+    {
+      std::stringstream json;
+      json << "{ \"age\": " << i << ", \"data\": \""
+           << std::string(size_t(i), 'x') << "\" }";
+      add.add(json.str());
+    }
+    add.execute();
+  }
+
+  auto check = [](DocResult &&res)
+  {
+    int i = 0;
+    for (DbDoc doc : res)
+    {
+      EXPECT_EQ(i, static_cast<int>(doc["age"]));
+      ++i;
+    }
+    EXPECT_EQ(1000, i);
+  };
+
+  cout << "Default prefetch" << endl;
+  check(coll.find().sort("age").execute());
+
+  cout << "Prefetch 7 rows" << endl;
+  {
+    auto op = coll.find();
+    op.sort("age");
+    op.prefetch(7);
+    check(op.execute());
+  }
+
+  cout << "Prefetch 1 row" << endl;
+  {
+    auto op = coll.find();
+    op.sort("age");
+    op.prefetch(1);
+    check(op.execute());
+  }
+
+  cout << "Session option" << endl;
+  {
+    mysqlx::Session sess(SessionOption::PORT, get_port(),
+                         SessionOption::USER, get_user(),
+                         SessionOption::PWD, get_password(),
+                         SessionOption::PREFETCH_SIZE, 13);
+
+    check(sess.getSchema("test").getCollection("coll")
+              .find().sort("age").execute());
+  }
+
+  {
+    std::stringstream uri;
+    uri << "mysqlx://" << get_user();
+    if (get_password() && *get_password())
+      uri << ":" << get_password();
+    uri << "@localhost:" << get_port() << "/?prefetch-size=auto";
+
+    mysqlx::Session sess(uri.str());
+    check(sess.getSchema("test").getCollection("coll")
+              .find().sort("age").execute());
+  }
+
+  EXPECT_THROW(
+    mysqlx::Session sess("mysqlx://root@localhost/?prefetch-size=lots"),
+    Error
+  );
+
+  cout << "Done!" << endl;
+}
+
+
+/*
+  Inserts larger than MAX_INSERT_SIZE are sent to the server in several
+  chunks. Check that all documents and rows are inserted and that the result
+  reports totals for all chunks.
+*/
+
+TEST_F(Crud, insert_chunks)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  mysqlx::Session sess(SessionOption::PORT, get_port(),
+                       SessionOption::USER, get_user(),
+                       SessionOption::PWD, get_password(),
+                       SessionOption::MAX_INSERT_SIZE, 10000);
+
+  Schema sch = sess.createSchema("test", true);
+
+  cout << "Collection add" << endl;
+  {
+    Collection coll = sch.createCollection("coll", true);
+    coll.remove("true").execute();
+
+    CollectionAdd add(coll);
+    for (int i = 0; i < 100; ++i)
+    {
+      std::stringstream json;
+      json << "{ \"age\": " << i << ", \"data\": \""
+           << std::string(1000, 'x') << "\" }";
+      add.add(json.str());
+    }
+    add.add(R"({ "_id": "chunks", "age": 100 })");
+
+    Result res = add.execute();
+
+    EXPECT_EQ(101U, res.getAffectedItemsCount());
+    std::vector<mysqlx::GUID> ids = res.getDocumentIds();
+    EXPECT_EQ(101U, ids.size());
+
+    EXPECT_EQ(101U, coll.find().execute().count());
+    EXPECT_EQ(1U, coll.find("_id = :id").bind("id", string(ids.front()))
+                      .execute().count());
+    EXPECT_EQ(1U, coll.find("_id = 'chunks'").execute().count());
+  }
+
+  cout << "Table insert" << endl;
+  {
+    sql("DROP TABLE IF EXISTS test.chunks");
+    sql("CREATE TABLE test.chunks(id INT AUTO_INCREMENT PRIMARY KEY,"
+        " data TEXT)");
+
+    Table tbl = sch.getTable("chunks");
+    TableInsert insert = tbl.insert("data");
+    for (int i = 0; i < 100; ++i)
+      insert.values(std::string(1000, 'y'));
+
+    Result res = insert.execute();
+
+    EXPECT_EQ(100U, res.getAffectedItemsCount());
+    EXPECT_EQ(1U, res.getAutoIncrementValue());
+    EXPECT_EQ(100U, tbl.select().execute().count());
+  }
+
+  /*
+    Inserts which fit into a single message, with the limit set or not
+    (the default).
+  */
+
+  cout << "Small insert" << endl;
+  {
+    sql("DELETE FROM test.chunks");
+
+    Table tbl = sch.getTable("chunks");
+    Result res = tbl.insert("data").values("a").values("b").execute();
+
+    EXPECT_EQ(2U, res.getAffectedItemsCount());
+    EXPECT_EQ(2U, tbl.select().execute().count());
+
+    res = tbl.insert("data").values("c").execute();
+    EXPECT_EQ(1U, res.getAffectedItemsCount());
+    EXPECT_EQ(3U, tbl.select().execute().count());
+  }
+
+  cout << "No limit" << endl;
+  {
+    mysqlx::Session sess0(SessionOption::PORT, get_port(),
+                          SessionOption::USER, get_user(),
+                          SessionOption::PWD, get_password(),
+                          SessionOption::MAX_INSERT_SIZE, 0);
+
+    sql("DELETE FROM test.chunks");
+
+    Table tbl = sess0.getSchema("test").getTable("chunks");
+    TableInsert insert = tbl.insert("data");
+    for (int i = 0; i < 100; ++i)
+      insert.values(std::string(1000, 'z'));
+
+    Result res = insert.execute();
+    EXPECT_EQ(100U, res.getAffectedItemsCount());
+
+    res = tbl.insert("data").values("a").values("b").execute();
+    EXPECT_EQ(2U, res.getAffectedItemsCount());
+
+    EXPECT_EQ(102U, tbl.select().execute().count());
+  }
+
+  EXPECT_THROW(
+    mysqlx::Session sess("mysqlx://root@localhost/?max-insert-size=big"),
+    Error
+  );
+
+  cout << "Done!" << endl;
+}
+
+
 TEST_F(Crud, iterators)
 {
   SKIP_IF_NO_XPLUGIN;
@@ -2065,6 +2270,136 @@ TEST_F(Crud, copy_semantics)
 }
 
 
+TEST_F(Crud, reexecute)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Creating collection..." << endl;
+
+  Schema sch = getSchema("test");
+  Collection coll = sch.createCollection("c1", true);
+
+  add_data(coll);
+
+  /*
+    Execute the same statement several times with different parameter
+    values. Expressions are parsed only once, but each execution must use
+    the current bindings.
+  */
+
+  CollectionFind find = coll.find("age > :age");
+  find.fields("name", "age AS age").sort("age DESC");
+
+  auto check = [](DocResult &&docs, unsigned count, int first_age)
+  {
+    DbDoc doc = docs.fetchOne();
+    EXPECT_TRUE((bool)doc);
+    EXPECT_EQ(first_age, (int)doc["age"]);
+    unsigned i = 1;
+    for (; docs.fetchOne(); ++i);
+    EXPECT_EQ(count, i);
+  };
+
+  check(find.bind("age", 5).execute(), 2, 17);
+  check(find.bind("age", 1).execute(), 4, 17);
+
+  // Copy shares parsed expressions with the original statement.
+
+  CollectionFind find2 = find;
+  check(find2.bind("age", 2).execute(), 3, 17);
+
+  check(find.bind("age", 5).execute(), 2, 17);
+
+  cout << "Done!" << endl;
+}
+
+
+TEST_F(Crud, prepared)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Creating collection..." << endl;
+
+  Schema sch = getSchema("test");
+  Collection coll = sch.createCollection("c1", true);
+
+  add_data(coll);
+
+  /*
+    Starting from the second execution statements are prepared on the
+    server (if supported). Results must be the same as for direct execution.
+  */
+
+  auto count = [](DocResult &&docs)
+  {
+    unsigned i = 0;
+    for (; docs.fetchOne(); ++i);
+    return i;
+  };
+
+  CollectionFind find = coll.find("age > :age").sort("age ASC");
+
+  EXPECT_EQ(4U, count(find.bind("age", 1).execute()));
+  EXPECT_EQ(2U, count(find.bind("age", 3).execute()));
+  EXPECT_EQ(1U, count(find.bind("age", 7).execute()));
+
+  // Modifying the statement must not use the old prepared statement.
+
+  find.limit(1);
+  EXPECT_EQ(1U, count(find.bind("age", 1).execute()));
+  EXPECT_EQ(1U, count(find.bind("age", 1).execute()));
+
+  find.limit(2);
+  EXPECT_EQ(2U, count(find.bind("age", 1).execute()));
+  EXPECT_EQ(2U, count(find.bind("age", 1).execute()));
+
+  // Prepared modify and remove.
+
+  CollectionModify modify = coll.modify("name = :name").set("age", 100);
+
+  EXPECT_EQ(3U, modify.bind("name", "foo").execute().getAffectedItemsCount());
+  EXPECT_EQ(1U, modify.bind("name", "bar").execute().getAffectedItemsCount());
+  EXPECT_EQ(1U, modify.bind("name", "baz").execute().getAffectedItemsCount());
+
+  EXPECT_EQ(5U, count(coll.find("age = 100").execute()));
+
+  CollectionRemove remove = coll.remove("name = :name");
+
+  EXPECT_EQ(1U, remove.bind("name", "bar").execute().getAffectedItemsCount());
+  EXPECT_EQ(1U, remove.bind("name", "baz").execute().getAffectedItemsCount());
+  EXPECT_EQ(0U, remove.bind("name", "baz").execute().getAffectedItemsCount());
+
+  // Prepared SQL statement.
+
+  SqlStatement stmt = get_sess().sql(
+    "SELECT count(*) FROM test.c1 WHERE doc->'$.age' >= ?"
+  );
+
+  EXPECT_EQ(3, (int)stmt.bind(100).execute().fetchOne()[0]);
+  EXPECT_EQ(4, (int)stmt.bind(0).execute().fetchOne()[0]);
+  EXPECT_EQ(3, (int)stmt.bind(100).execute().fetchOne()[0]);
+
+  /*
+    Execute request is sent right after the prepare request. If preparing
+    fails, the statement must be executed directly.
+  */
+
+  int max_stmt
+    = (int)sql("SELECT @@global.max_prepared_stmt_count").fetchOne()[0];
+  sql("SET GLOBAL max_prepared_stmt_count = 0");
+
+  SqlStatement inc = get_sess().sql("SELECT ? + 1");
+
+  EXPECT_EQ(2, (int)inc.bind(1).execute().fetchOne()[0]);
+  EXPECT_EQ(3, (int)inc.bind(2).execute().fetchOne()[0]);
+  EXPECT_EQ(4, (int)inc.bind(3).execute().fetchOne()[0]);
+
+  sql("SET GLOBAL max_prepared_stmt_count = " + std::to_string(max_stmt));
+
+  cout << "Done!" << endl;
+}
+
+
 TEST_F(Crud, multi_statment_exec)
 {
   SKIP_IF_NO_XPLUGIN;
@@ -181,10 +181,81 @@ TEST_F(First, value)
     EXPECT_EQ(val.get<mysqlx::string>(), L"foo");
   }
 
+  // UTF-8 access to string values.
+
+  {
+    Value val = L"Mog\u0119";
+    utf8_view str = val.getUtf8();
+    EXPECT_EQ(std::string("Mog\xc4\x99"), (std::string)str);
+    EXPECT_EQ(str.data(), val.getUtf8().data());
+
+    Value val1 = "foo";
+    EXPECT_EQ(3U, val1.getUtf8().size());
+
+    EXPECT_THROW(Value(7).getUtf8(), Error);
+    EXPECT_THROW(Value().getUtf8(), Error);
+  }
+
   // TODO: test other types
 }
 
 
+TEST_F(First, doc)
+{
+  // Document created from JSON string (fields are loaded on demand).
+
+  DbDoc doc(
+    "{ \"name\": \"foo\", \"age\": 1, \"name\": \"bar\","
+    "  \"sub\": { \"arr\": [1, \"}\", {\"x\": true}] },"
+    "  \"a\\\"b\": 2, \"nil\": null }"
+  );
+
+  EXPECT_EQ(1, (int)doc["age"]);
+  EXPECT_TRUE(doc.hasField("name"));
+  EXPECT_FALSE(doc.hasField("none"));
+  EXPECT_THROW(doc["none"], std::out_of_range);
+
+  // Last value of a repeated key is used.
+
+  EXPECT_EQ(string("bar"), (string)doc["name"]);
+
+  Value sub = doc["sub"];
+  EXPECT_EQ(Value::DOCUMENT, sub.getType());
+  EXPECT_EQ(Value::ARRAY, sub["arr"].getType());
+  EXPECT_EQ(string("}"), (string)sub["arr"][1]);
+  EXPECT_TRUE((bool)sub["arr"][2]["x"]);
+  EXPECT_EQ(Value::VNULL, doc["nil"].getType());
+  EXPECT_EQ(2, (int)doc["a\"b"]);
+  EXPECT_EQ(std::string("bar"), (std::string)doc["name"].getUtf8());
+
+  // Iterating over fields loads the rest of the document.
+
+  unsigned cnt = 0;
+  for (Field fld : doc)
+  {
+    cout << fld << ": " << doc[fld] << endl;
+    cnt++;
+  }
+  EXPECT_EQ(5U, cnt);
+
+  // Documents which are not handled by the scanner.
+
+  DbDoc doc1("{ 'name': 'foo', \"age\": 1 }");
+  EXPECT_EQ(1, (int)doc1["age"]);
+  EXPECT_EQ(string("foo"), (string)doc1["name"]);
+
+  // Repeated keys, also when the document is parsed by the full parser.
+
+  DbDoc doc2("{ \"a\": 1, \"b\": 2, \"a\": 3 }");
+  EXPECT_EQ(3, (int)doc2["a"]);
+  EXPECT_EQ(2, (int)doc2["b"]);
+
+  DbDoc doc3("{ 'a': 1, \"b\": 2, 'a': 3 }");
+  EXPECT_EQ(3, (int)doc3["a"]);
+  EXPECT_EQ(2, (int)doc3["b"]);
+}
+
+
 
 TEST_F(First, api)
 {
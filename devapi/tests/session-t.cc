@@ -30,6 +30,7 @@
 
 #include <test.h>
 #include <iostream>
+#include <chrono>
 
 
 using std::cout;
@@ -1040,6 +1041,358 @@ TEST_F(Sess, unix_socket)
 #endif //_WIN32
 
 
+TEST_F(Sess, pool)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  SessionSettings settings(SessionOption::PORT, get_port(),
+                           SessionOption::USER, get_user(),
+                           SessionOption::PWD, get_password(),
+                           SessionOption::POOL_MAX_SIZE, 2,
+                           SessionOption::POOL_QUEUE_TIMEOUT, 500);
+
+  Client client(settings);
+  uint64_t id;
+
+  cout << "Session state is reset when returned to the pool" << endl;
+
+  {
+    mysqlx::Session sess = client.getSession();
+    sess.sql("SET @pool_test = 1").execute();
+    sess.startTransaction();
+    id = sess.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+  }
+
+  {
+    mysqlx::Session sess = client.getSession();
+    Row row = sess.sql("SELECT CONNECTION_ID(), @pool_test")
+                  .execute().fetchOne();
+    EXPECT_EQ(id, (uint64_t)row[0]);
+    EXPECT_TRUE(row[1].isNull());
+
+    // New transaction can be started because the previous one was ended.
+
+    sess.startTransaction();
+    sess.rollback();
+  }
+
+  cout << "Queue timeout when pool is full" << endl;
+
+  {
+    mysqlx::Session s1(client);
+    mysqlx::Session s2(client);
+    EXPECT_THROW(mysqlx::Session s3(client), Error);
+
+    s1.close();
+    mysqlx::Session s3(client);
+    EXPECT_EQ(id,
+      (uint64_t)s3.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0]);
+  }
+
+  cout << "Pool options in connection string" << endl;
+
+  {
+    std::string url = get_user();
+    if (get_password())
+      url = url + ":" + get_password();
+    url = url + "@localhost";
+    if (get_port())
+      url = url + ":" + std::to_string(get_port());
+
+    Client cli(url + "/?pool-max-size=1&pool-max-idle-time=10000");
+    mysqlx::Session sess(cli);
+    sess.sql("SELECT 1").execute();
+
+    EXPECT_THROW(Client(url + "/?pool-max-size=0"), Error);
+    EXPECT_THROW(Client(url + "/?pool-max-size=x"), Error);
+  }
+
+  client.close();
+  EXPECT_THROW(client.getSession(), Error);
+
+  cout << "Done!" << endl;
+}
+
+
+TEST_F(Sess, compression)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  std::string data(10000, 'x');
+
+  cout << "Compression preferred" << endl;
+
+  {
+    mysqlx::Session sess(SessionOption::PORT, get_port(),
+                         SessionOption::USER, get_user(),
+                         SessionOption::PWD, get_password(),
+                         SessionOption::COMPRESSION,
+                         CompressionMode::PREFERRED);
+
+    // Large row is sent by server in a compressed frame (if supported).
+
+    Row row = sess.sql("SELECT REPEAT('x', 10000), 1").execute().fetchOne();
+    EXPECT_EQ(data, row[0].get<std::string>());
+    EXPECT_EQ(1, (int)row[1]);
+
+    // Large query is sent to the server in a compressed frame.
+
+    row = sess.sql("SELECT LENGTH(?)").bind(data).execute().fetchOne();
+    EXPECT_EQ(data.length(), (unsigned)row[0]);
+  }
+
+  cout << "Compression options in connection string" << endl;
+
+  {
+    std::string url = get_user();
+    if (get_password())
+      url = url + ":" + get_password();
+    url = url + "@localhost";
+    if (get_port())
+      url = url + ":" + std::to_string(get_port());
+
+    mysqlx::Session sess(url + "/?compression=disabled");
+    sess.sql("SELECT 1").execute();
+
+    EXPECT_THROW(mysqlx::Session(url + "/?compression=sometimes"), Error);
+  }
+
+  EXPECT_THROW(
+    SessionSettings(SessionOption::COMPRESSION, SSLMode::REQUIRED),
+    Error
+  );
+
+  cout << "Done!" << endl;
+}
+
+
+TEST_F(Sess, async)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Future" << endl;
+
+  {
+    Session sess(this);
+
+    auto stmt = sess.sql("SELECT SLEEP(0.2), ?");
+    Future<SqlResult> fut = stmt.bind(7).executeAsync();
+
+    EXPECT_TRUE(fut.valid());
+
+    // Reply is not ready yet, query is still being executed.
+
+    EXPECT_FALSE(fut.isReady());
+
+    SqlResult res = fut.get();
+    EXPECT_FALSE(fut.valid());
+    EXPECT_THROW(fut.get(), Error);
+
+    Row row = res.fetchOne();
+    EXPECT_EQ(7, (int)row[1]);
+
+    /*
+      The future executed its own copy of the statement, so the statement
+      object is not affected and can be executed again.
+    */
+
+    row = stmt.execute().fetchOne();
+    EXPECT_EQ(7, (int)row[1]);
+
+    // Parameters are cleared after execution, as in synchronous case.
+
+    EXPECT_THROW(stmt.execute(), Error);
+
+    // Errors are reported by get().
+
+    fut = sess.sql("SELECT * FROM no_such_table").executeAsync();
+    fut.wait();
+    EXPECT_TRUE(fut.isReady());
+    EXPECT_THROW(fut.get(), Error);
+
+    /*
+      Rows of an earlier result which were not read yet are cached before
+      reading reply to the asynchronous operation. This is done without
+      blocking, both by isReady() and by the event loop.
+    */
+
+    {
+      SqlResult first = sess.sql("SELECT SLEEP(0.2), 1").execute();
+      fut = sess.sql("SELECT 2").executeAsync();
+
+      unsigned polls = 0;
+      while (!fut.isReady())
+        ++polls;
+      cout << "Future ready after " << polls << " polls" << endl;
+
+      EXPECT_EQ(2, (int)fut.get().fetchOne()[0]);
+      EXPECT_EQ(1, (int)first.fetchOne()[1]);
+    }
+
+    {
+      SqlResult first = sess.sql("SELECT SLEEP(0.2), 1").execute();
+      EventLoop loop;
+      int val = 0;
+
+      loop.add(sess.sql("SELECT 2").executeAsync(),
+        [&val](Future<SqlResult> &fut) {
+          val = (int)fut.get().fetchOne()[0];
+        });
+
+      loop.run();
+
+      EXPECT_EQ(2, val);
+      EXPECT_EQ(1, (int)first.fetchOne()[1]);
+    }
+
+    // CRUD operation.
+
+    sess.dropSchema("async_test");
+    Schema sch = sess.createSchema("async_test");
+    Collection coll = sch.createCollection("c");
+
+    Future<Result> add = coll.add(R"({"a": 1})").add(R"({"a": 2})")
+                             .executeAsync();
+    EXPECT_EQ(2U, add.get().getAffectedItemsCount());
+
+    Future<DocResult> find = coll.find().sort("a").executeAsync();
+    EXPECT_EQ(2U, find.get().count());
+
+    sess.dropSchema("async_test");
+  }
+
+  cout << "Event loop" << endl;
+
+  {
+    const unsigned N = 3;
+    const char *queries[N] = {
+      "SELECT SLEEP(0.6), 0",
+      "SELECT SLEEP(0.2), 1",
+      "SELECT SLEEP(0.4), 2"
+    };
+
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::vector<int> done;
+    EventLoop loop;
+
+    for (unsigned i = 0; i < N; ++i)
+      sessions.emplace_back(new Session(this));
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < N; ++i)
+    {
+      loop.add(sessions[i]->sql(queries[i]).executeAsync(),
+        [&done](Future<SqlResult> &fut) {
+          done.push_back((int)fut.get().fetchOne()[1]);
+        });
+    }
+
+    // Errors are passed to callbacks.
+
+    bool failed = false;
+
+    loop.add(sessions[0]->sql("SELECT * FROM no_such_table").executeAsync(),
+      [&failed](Future<SqlResult> &fut) {
+        EXPECT_THROW(fut.get(), Error);
+        failed = true;
+      });
+
+    EXPECT_EQ(N + 1, loop.count());
+
+    loop.run();
+
+    auto time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start
+    ).count();
+
+    cout << "Queries completed in " << time << "ms" << endl;
+
+    EXPECT_EQ(0U, loop.count());
+    EXPECT_TRUE(failed);
+    ASSERT_EQ(N, done.size());
+    EXPECT_EQ(1, done[0]);
+    EXPECT_EQ(2, done[1]);
+    EXPECT_EQ(0, done[2]);
+
+    // Queries were executed concurrently.
+
+    EXPECT_GT(1100, time);
+  }
+
+  cout << "Done!" << endl;
+}
+
+
+#ifdef MYSQLX_HAVE_COROUTINES
+
+/*
+  Minimal coroutine type used to test awaiting futures.
+*/
+
+struct Task
+{
+  struct promise_type
+  {
+    Task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+
+Task async_query(mysqlx::Session &sess, EventLoop &loop, const char *query,
+                 std::vector<int> &done)
+{
+  SqlResult res = co_await sess.sql(query).executeAsync(loop);
+  done.push_back((int)res.fetchOne()[1]);
+
+  // Future not bound to a loop is awaited without suspending.
+
+  Row row = (co_await sess.sql("SELECT 7").executeAsync()).fetchOne();
+  EXPECT_EQ(7, (int)row[0]);
+}
+
+
+TEST_F(Sess, async_coroutines)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  const unsigned N = 3;
+  const char *queries[N] = {
+    "SELECT SLEEP(0.6), 0",
+    "SELECT SLEEP(0.2), 1",
+    "SELECT SLEEP(0.4), 2"
+  };
+
+  std::vector<std::unique_ptr<Session>> sessions;
+  std::vector<int> done;
+  EventLoop loop;
+
+  for (unsigned i = 0; i < N; ++i)
+  {
+    sessions.emplace_back(new Session(this));
+    async_query(*sessions.back(), loop, queries[i], done);
+  }
+
+  // Coroutines are suspended waiting for query results.
+
+  EXPECT_TRUE(done.empty());
+  EXPECT_EQ(N, loop.count());
+
+  loop.run();
+
+  ASSERT_EQ(N, done.size());
+  EXPECT_EQ(1, done[0]);
+  EXPECT_EQ(2, done[1]);
+  EXPECT_EQ(0, done[2]);
+}
+
+#endif
+
+
 TEST_F(Sess, bugs)
 {
   SKIP_IF_NO_XPLUGIN
@@ -286,7 +286,7 @@ TEST_F(Types, basic)
       cout << "col " << res.getColumn(j) << ": " << row[j] << endl;
     }
 
-    // Note: DECIMAL values are converted to double.
+    // Note: DECIMAL values are reported as DOUBLE.
 
     EXPECT_EQ(Value::INT64,  row[0].getType());
     EXPECT_EQ(Value::DOUBLE, row[1].getType());
@@ -296,6 +296,12 @@ TEST_F(Types, basic)
 
     EXPECT_EQ(data_int[i], (int)row[0]);
     EXPECT_EQ(data_decimal[i], (double)row[1]);
+
+    Decimal dec = row[1].get<Decimal>();
+    EXPECT_EQ(2U, dec.scale());
+    EXPECT_EQ(data_decimal[i] < 0, dec.is_negative());
+    EXPECT_EQ(data_decimal[i], dec.get_double());
+    EXPECT_EQ(std::string(0 == i ? "3.14" : "-2.71"), dec.str());
     EXPECT_EQ(data_float[i], (float)row[2]);
     EXPECT_EQ(data_double[i], (double)row[3]);
     EXPECT_EQ(data_string[i], (string)row[4]);
@@ -461,6 +467,13 @@ TEST_F(Types, string)
   EXPECT_EQ(str0, (string)row[0]);
   EXPECT_EQ(str1, (string)row[1]);
 
+  // UTF-8 text of the utf8 column is taken directly from row data.
+
+  utf8_view c1_utf8 = row.getUtf8(1);
+  EXPECT_EQ((std::string)str1, (std::string)c1_utf8);
+  EXPECT_EQ((const char*)row.getBytes(1).begin(), c1_utf8.data());
+  EXPECT_EQ((std::string)str0, (std::string)row.getUtf8(0));
+
   /*
     FIXME: the third colum contains non-utf8 string which uses non-ascii
     characters. Currently we do not handle such strings and an error is
@@ -470,6 +483,7 @@ TEST_F(Types, string)
   */
 
   EXPECT_THROW((string)row[2], Error);
+  EXPECT_THROW(row.getUtf8(2), Error);
 }
 
 
@@ -838,3 +852,162 @@ TEST_F(Types, int64_conversion)
   EXPECT_ANY_THROW(int_v = value);
 
 }
+
+
+TEST_F(Types, arrow_export)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Preparing test.arrow_types..." << endl;
+
+  sql("DROP TABLE IF EXISTS test.arrow_types");
+  sql(
+    "CREATE TABLE test.arrow_types("
+    "  c0 INT,"
+    "  c1 BIGINT UNSIGNED,"
+    "  c2 DOUBLE,"
+    "  c3 VARCHAR(32)"
+    ")");
+
+  Table types = getSchema("test").getTable("arrow_types");
+
+  types.insert()
+    .values(-7, 7, 3.5, "foo")
+    .values(nullptr, 8, nullptr, "")
+    .values(9, nullptr, -1.0, nullptr)
+    .execute();
+
+  RowResult res = types.select().execute();
+
+  ArrowSchema schema;
+  res.exportArrowSchema(&schema);
+
+  EXPECT_EQ(string("+s"), string(schema.format));
+  ASSERT_EQ(4, schema.n_children);
+  EXPECT_EQ(string("l"), string(schema.children[0]->format));
+  EXPECT_EQ(string("L"), string(schema.children[1]->format));
+  EXPECT_EQ(string("g"), string(schema.children[2]->format));
+  EXPECT_EQ(string("u"), string(schema.children[3]->format));
+  EXPECT_EQ(string("c3"), string(schema.children[3]->name));
+
+  schema.release(&schema);
+  EXPECT_EQ(nullptr, schema.release);
+
+  // Fetch rows in batches of 2.
+
+  ArrowArray batch;
+  EXPECT_EQ(2U, res.fetchArrowBatch(&batch, 2));
+
+  EXPECT_EQ(2, batch.length);
+  ASSERT_EQ(4, batch.n_children);
+
+  {
+    ArrowArray &c0 = *batch.children[0];
+    EXPECT_EQ(1, c0.null_count);
+    const int64_t *vals = static_cast<const int64_t*>(c0.buffers[1]);
+    EXPECT_EQ(-7, vals[0]);
+    const uint8_t *valid = static_cast<const uint8_t*>(c0.buffers[0]);
+    EXPECT_EQ(1, valid[0] & 0x3);
+
+    ArrowArray &c1 = *batch.children[1];
+    EXPECT_EQ(0, c1.null_count);
+    EXPECT_EQ(nullptr, c1.buffers[0]);
+    const uint64_t *uvals = static_cast<const uint64_t*>(c1.buffers[1]);
+    EXPECT_EQ(7U, uvals[0]);
+    EXPECT_EQ(8U, uvals[1]);
+
+    ArrowArray &c2 = *batch.children[2];
+    EXPECT_EQ(3.5, static_cast<const double*>(c2.buffers[1])[0]);
+
+    ArrowArray &c3 = *batch.children[3];
+    EXPECT_EQ(3, c3.n_buffers);
+    const int32_t *offs = static_cast<const int32_t*>(c3.buffers[1]);
+    const char *chars = static_cast<const char*>(c3.buffers[2]);
+    EXPECT_EQ(0, offs[0]);
+    EXPECT_EQ(3, offs[1]);
+    EXPECT_EQ(3, offs[2]);
+    EXPECT_EQ(std::string("foo"), std::string(chars, (size_t)offs[1]));
+  }
+
+  batch.release(&batch);
+  EXPECT_EQ(nullptr, batch.release);
+
+  EXPECT_EQ(1U, res.fetchArrowBatch(&batch));
+  EXPECT_EQ(1, batch.length);
+  EXPECT_EQ(9, static_cast<const int64_t*>(batch.children[0]->buffers[1])[0]);
+  EXPECT_EQ(1, batch.children[1]->null_count);
+  EXPECT_EQ(1, batch.children[3]->null_count);
+  batch.release(&batch);
+
+  EXPECT_EQ(0U, res.fetchArrowBatch(&batch));
+  EXPECT_EQ(nullptr, batch.release);
+  EXPECT_TRUE(res.fetchOne().isNull());
+
+  cout << "Temporal, DECIMAL, BIT and SET columns..." << endl;
+
+  sql("DROP TABLE IF EXISTS test.arrow_types");
+  sql(
+    "CREATE TABLE test.arrow_types("
+    "  c0 DATETIME(6),"
+    "  c1 DATE,"
+    "  c2 TIME,"
+    "  c3 DECIMAL(10,5),"
+    "  c4 BIT(8),"
+    "  c5 SET('a','b','c')"
+    ")");
+  sql(
+    "INSERT INTO test.arrow_types VALUES"
+    " ('2000-03-01 10:20:30.5', '1969-12-31', '-10:30:05', -12.3401,"
+    "  b'101', 'a,c'),"
+    " (NULL, NULL, NULL, 7, NULL, '')");
+
+  res = getSchema("test").getTable("arrow_types").select().execute();
+
+  res.exportArrowSchema(&schema);
+
+  ASSERT_EQ(6, schema.n_children);
+  EXPECT_EQ(string("tsu:"), string(schema.children[0]->format));
+  EXPECT_EQ(string("tdD"), string(schema.children[1]->format));
+  EXPECT_EQ(string("tDu"), string(schema.children[2]->format));
+
+  // Note: precision is given by the column length reported by the server.
+
+  string decimal_fmt = schema.children[3]->format;
+  EXPECT_EQ(string("d:"), decimal_fmt.substr(0, 2));
+  EXPECT_EQ(string(",5"), decimal_fmt.substr(decimal_fmt.size() - 2));
+  EXPECT_EQ(string("L"), string(schema.children[4]->format));
+  EXPECT_EQ(string("u"), string(schema.children[5]->format));
+
+  schema.release(&schema);
+
+  EXPECT_EQ(2U, res.fetchArrowBatch(&batch));
+
+  {
+    const int64_t day = 86400LL * 1000000;
+
+    EXPECT_EQ(11017 * day + (37230LL * 1000000 + 500000),
+              static_cast<const int64_t*>(batch.children[0]->buffers[1])[0]);
+    EXPECT_EQ(1, batch.children[0]->null_count);
+    EXPECT_EQ(-1, static_cast<const int32_t*>(batch.children[1]->buffers[1])[0]);
+    EXPECT_EQ(-37805LL * 1000000,
+              static_cast<const int64_t*>(batch.children[2]->buffers[1])[0]);
+
+    const uint64_t *dec = static_cast<const uint64_t*>(
+      batch.children[3]->buffers[1]
+    );
+    EXPECT_EQ(uint64_t(-1234010), dec[0]);
+    EXPECT_EQ(uint64_t(-1), dec[1]);
+    EXPECT_EQ(700000U, dec[2]);
+    EXPECT_EQ(0U, dec[3]);
+
+    EXPECT_EQ(5U, static_cast<const uint64_t*>(batch.children[4]->buffers[1])[0]);
+
+    ArrowArray &c5 = *batch.children[5];
+    const int32_t *offs = static_cast<const int32_t*>(c5.buffers[1]);
+    const char *chars = static_cast<const char*>(c5.buffers[2]);
+    EXPECT_EQ(std::string("a,c"), std::string(chars, (size_t)offs[1]));
+    EXPECT_EQ(offs[1], offs[2]);
+  }
+
+  batch.release(&batch);
+}
@@ -45,6 +45,15 @@
 #include <string>
 
 
+namespace cdk {
+namespace foundation {
+namespace api {
+
+class Event_info;
+
+}}}  // cdk::foundation::api
+
+
 namespace mysqlx {
 namespace common {
 
@@ -93,6 +102,30 @@ struct Executable_if
 
   virtual Executable_if *clone() const = 0;
 
+  /*
+    Set the number of rows fetched in one batch when reading results of
+    the operation. Value 0 selects adaptive batch size.
+  */
+
+  virtual void set_prefetch_size(unsigned) = 0;
+
+  /*
+    Asynchronous execution. The first call to cont() sends the operation to
+    the server and further calls push forward processing of the server reply
+    without blocking. Method cont() returns true when the reply is ready.
+    Then get_result() returns Result_init object, the same as execute() does.
+    Method wait() blocks until the reply is ready.
+
+    While execution is in progress, waits_for() describes the event (such as
+    data arriving on the session socket) the operation waits for. It returns
+    NULL if the operation can make progress without waiting.
+  */
+
+  virtual bool cont() = 0;
+  virtual void wait() = 0;
+  virtual Result_init& get_result() = 0;
+  virtual const cdk::foundation::api::Event_info* waits_for() = 0;
+
   virtual ~Executable_if() {}
 };
 
@@ -101,6 +101,12 @@ public:
 
   static  const char* auth_method_name(Auth_method method);
 
+
+  enum class Compression_mode {
+    COMPRESSION_MODE_LIST(SETTINGS_VAL_ENUM)
+    LAST
+  };
+
 protected:
 
   using opt_val_t = std::pair<Option, Value>;
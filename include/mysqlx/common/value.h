@@ -43,6 +43,49 @@ namespace common {
 
 class Value_conv;
 
+
+/*
+  Exact value of a DECIMAL number, stored as a fixed-point number.
+
+  The value is M * 10^(-scale), where M is an unsigned 128-bit integer given
+  by its high and low 64-bit halves, with sign given by is_negative().
+*/
+
+class PUBLIC_API Decimal
+  : public Printable
+{
+  uint64_t m_high = 0;
+  uint64_t m_low = 0;
+  unsigned m_scale = 0;
+  bool     m_negative = false;
+
+  void print(std::ostream &out) const override
+  {
+    out << str();
+  }
+
+public:
+
+  Decimal() = default;
+
+  Decimal(uint64_t high, uint64_t low, unsigned scale, bool negative)
+    : m_high(high), m_low(low), m_scale(scale), m_negative(negative)
+  {}
+
+  uint64_t high() const { return m_high; }
+  uint64_t low() const { return m_low; }
+  unsigned scale() const { return m_scale; }
+  bool is_negative() const { return m_negative; }
+
+  // Exact decimal representation, such as "-12.50".
+
+  std::string str() const;
+
+  // Note: this conversion can lose precision.
+
+  double get_double() const;
+};
+
 /*
   Class representing a polymorphic value of one of the supported types.
 
@@ -70,7 +113,8 @@ public:
     WSTRING,    ///< Wide string
     RAW,        ///< Raw bytes
     EXPR,       ///< String to be interpreted as an expression
-    JSON        ///< JSON string
+    JSON,       ///< JSON string
+    DECIMAL     ///< Exact DECIMAL number
   };
 
 protected:
@@ -92,6 +136,12 @@ protected:
     int64_t  v_sint;
     uint64_t v_uint;
     bool     v_bool;
+    struct {
+      uint64_t high;
+      uint64_t low;
+      unsigned scale;
+      bool     negative;
+    } v_decimal;
   } m_val;
 
   void print(std::ostream&) const override;
@@ -141,6 +191,15 @@ public:
   Value(bool v) : m_type(BOOL)
   { m_val.v_bool = v; }
 
+  // Construct an item from a DECIMAL number
+  Value(const Decimal &v) : m_type(DECIMAL)
+  {
+    m_val.v_decimal.high = v.high();
+    m_val.v_decimal.low = v.low();
+    m_val.v_decimal.scale = v.scale();
+    m_val.v_decimal.negative = v.is_negative();
+  }
+
   // Construct an item from bytes
   Value(const byte *ptr, size_t len) : m_type(RAW)
   {
@@ -234,11 +293,30 @@ public:
     case UINT64: return 1.0*m_val.v_uint;
     case FLOAT:  return m_val.v_float;
     case DOUBLE: return m_val.v_double;
+    case DECIMAL: return get_decimal().get_double();
     default:
       throw Error("Value can not be converted to double number");
     }
   }
 
+  Decimal get_decimal() const
+  {
+    switch (m_type)
+    {
+    case DECIMAL:
+      return Decimal(m_val.v_decimal.high, m_val.v_decimal.low,
+                     m_val.v_decimal.scale, m_val.v_decimal.negative);
+    case INT64:
+      return Decimal(0, m_val.v_sint < 0 ? 0 - (uint64_t)m_val.v_sint
+                                         : (uint64_t)m_val.v_sint,
+                     0, m_val.v_sint < 0);
+    case UINT64:
+      return Decimal(0, m_val.v_uint, 0, false);
+    default:
+      throw Error("Value cannot be converted to decimal number");
+    }
+  }
+
   const byte* get_bytes(size_t *size) const
   {
     switch (m_type)
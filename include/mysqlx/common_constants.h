@@ -73,7 +73,27 @@
   /*! path to a PEM file specifying trusted root certificates*/              \
   OPT_STR(x,SSL_CA,9)                                                        \
   OPT_ANY(x,AUTH,10)      /*!< authentication method, PLAIN, MYSQL41, etc.*/ \
-  OPT_STR(x,SOCKET,11)
+  OPT_STR(x,SOCKET,11)                                                       \
+  /*! number of rows fetched from the server in one batch when reading
+      query results; 0 or "auto" (the default) selects batch size based on
+      the observed size of rows */                                           \
+  OPT_ANY(x,PREFETCH_SIZE,12)                                                \
+  /*! maximum number of connections kept open by a client connection pool
+      (default 25); used only when creating a client */                     \
+  OPT_ANY(x,POOL_MAX_SIZE,13)                                                \
+  /*! time in milliseconds to wait for a free connection when all pooled
+      connections are in use; 0 (the default) means wait without limit */   \
+  OPT_ANY(x,POOL_QUEUE_TIMEOUT,14)                                           \
+  /*! time in milliseconds after which an idle pooled connection is closed;
+      0 (the default) means that idle connections are never closed */       \
+  OPT_ANY(x,POOL_MAX_IDLE_TIME,15)                                           \
+  /*! define `CompressionMode` option to be used; compression of protocol
+      messages is disabled by default */                                    \
+  OPT_ANY(x,COMPRESSION,16)                                                  \
+  /*! approximate limit, in bytes, on the size of a single insert message;
+      larger collection add and table insert operations are sent to the
+      server as several messages; 0 means no limit (the default) */         \
+  OPT_ANY(x,MAX_INSERT_SIZE,17)                                              \
   END_LIST
 
 #define OPT_STR(X,Y,N) X##_str(Y,N)
@@ -90,6 +110,12 @@
   X("ssl-mode", SSL_MODE)   \
   X("ssl-ca", SSL_CA)       \
   X("auth", AUTH)           \
+  X("prefetch-size", PREFETCH_SIZE) \
+  X("pool-max-size", POOL_MAX_SIZE) \
+  X("pool-queue-timeout", POOL_QUEUE_TIMEOUT) \
+  X("pool-max-idle-time", POOL_MAX_IDLE_TIME) \
+  X("compression", COMPRESSION) \
+  X("max-insert-size", MAX_INSERT_SIZE) \
   END_LIST
 
 
@@ -110,6 +136,16 @@
   END_LIST
 
 
+#define COMPRESSION_MODE_LIST(x) \
+  x(DISABLED,1)        /*!< Do not compress protocol messages. This is the
+                          default if `COMPRESSION` is not specified. */ \
+  x(PREFERRED,2)       /*!< Compress messages if the server supports
+                          compression, otherwise continue without it. */ \
+  x(REQUIRED,3)        /*!< Compress messages. The connection attempt fails
+                          if the server does not support compression. */ \
+  END_LIST
+
+
 #define AUTH_METHOD_LIST(x)\
   x(PLAIN,1)       /*!< Plain text authentication method. The password is
                       sent as a clear text. This method is used by
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MYSQLX_ASYNC_H
+#define MYSQLX_ASYNC_H
+
+/**
+  @file
+  Classes for asynchronous execution of operations.
+*/
+
+
+#include "common.h"
+#include "detail/async.h"
+
+/*
+  Futures can be awaited in C++20 coroutines if the compiler supports them.
+*/
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define MYSQLX_HAVE_COROUTINES
+#endif
+#endif
+
+
+namespace mysqlx {
+
+template <class Res, class Op> class Executable;
+class EventLoop;
+
+
+/**
+  Represents a result of an operation which is being executed asynchronously.
+
+  A future is returned by `executeAsync()` method of an executable operation.
+  At that moment the operation is already sent to the server. The server
+  reply is processed when the future is asked whether it is ready, when it is
+  waited for or when the future is driven by an `EventLoop`. No additional
+  threads are used for that.
+
+  Server replies are read in the order in which operations were sent. If
+  results of earlier operations of the same session were not consumed yet,
+  their remaining rows are first read into memory. Asking whether the
+  future is ready or driving it by an event loop does that without blocking
+  as well.
+
+  Method `get()` returns the result of the operation, waiting for it if
+  necessary. If the operation failed, `get()` throws the error. After calling
+  `get()` the future is no longer valid.
+
+  When compiled with C++20 coroutine support, a future can be awaited with
+  `co_await`, which gives the result of the operation. If the future was
+  created with `executeAsync(EventLoop&)`, the awaiting coroutine is suspended
+  and resumed by the event loop when the result is ready. Otherwise
+  `co_await` waits for the result without suspending the coroutine.
+
+  @note Operation should not be modified nor executed again until its result
+  is obtained from the future.
+
+  @ingroup devapi
+*/
+
+template <class Res>
+class Future
+{
+  internal::Shared_async_state m_state;
+
+  Future(const internal::Shared_async_state &state)
+    : m_state(state)
+  {}
+
+  void check_if_valid() const
+  {
+    if (!m_state)
+      throw Error("Attempt to use invalid future");
+  }
+
+public:
+
+  Future() = default;
+
+  Future(const Future&) = delete;
+  Future& operator=(const Future&) = delete;
+
+  Future(Future&&) = default;
+  Future& operator=(Future&&) = default;
+
+  /**
+    Check if this future represents an operation whose result was not yet
+    obtained with `get()`.
+  */
+
+  bool valid() const
+  {
+    return (bool)m_state;
+  }
+
+  /**
+    Check if result of the operation is available, in which case `get()`
+    does not block. This pushes forward processing of the server reply
+    without waiting for data that has not arrived yet.
+  */
+
+  bool isReady()
+  {
+    try {
+      check_if_valid();
+      return m_state->cont();
+    }
+    CATCH_AND_WRAP
+  }
+
+  /// Wait until result of the operation is available.
+
+  void wait()
+  {
+    try {
+      check_if_valid();
+      m_state->wait();
+    }
+    CATCH_AND_WRAP
+  }
+
+  /**
+    Return result of the operation, waiting for it if necessary. Throws error
+    if execution of the operation failed.
+  */
+
+  Res get()
+  {
+    try {
+      check_if_valid();
+      internal::Shared_async_state state = std::move(m_state);
+      state->wait();
+      if (state->m_error)
+        std::rethrow_exception(state->m_error);
+      return state->m_impl->get_result();
+    }
+    CATCH_AND_WRAP
+  }
+
+#ifdef MYSQLX_HAVE_COROUTINES
+
+  bool await_ready()
+  {
+    check_if_valid();
+    if (!m_state->m_loop)
+    {
+      m_state->wait();
+      return true;
+    }
+    return m_state->cont();
+  }
+
+  void await_suspend(std::coroutine_handle<> coro)
+  {
+    m_state->m_loop->add(m_state, [coro]() { coro.resume(); });
+  }
+
+  Res await_resume()
+  {
+    return get();
+  }
+
+#endif
+
+  template <class, class> friend class Executable;
+  friend EventLoop;
+};
+
+
+/**
+  Drives asynchronous execution of many operations from a single thread.
+
+  Futures returned by `executeAsync()` are added to the loop together with
+  callbacks. The loop waits for server replies of all the operations at
+  once and calls the callback of an operation, passing its future, when
+  the result is ready. Callbacks can add new futures to the loop.
+
+  Example:
+  ~~~~~~
+    EventLoop loop;
+
+    loop.add(sess1.sql("SELECT ...").executeAsync(),
+             [](Future<SqlResult> &res) { ... res.get() ... });
+    loop.add(sess2.sql("SELECT ...").executeAsync(),
+             [](Future<SqlResult> &res) { ... res.get() ... });
+
+    loop.run();
+  ~~~~~~
+
+  Futures created with `executeAsync(EventLoop&)` are added to the loop
+  when awaited in a coroutine.
+
+  @note Operations executed in the same session can not be driven
+  independently. When several operations of one session are added to the
+  loop, processing of a later one can wait for replies to the earlier
+  operations. It is best to have only one pending operation per session in
+  the loop.
+
+  @ingroup devapi
+*/
+
+class EventLoop
+  : private internal::Event_loop_detail
+{
+public:
+
+  EventLoop()
+  {}
+
+  /**
+    Add future to the loop. The loop takes over the future and passes it
+    to the callback when result of the operation is ready.
+  */
+
+  template <class Res, typename Callback>
+  void add(Future<Res> &&future, Callback callback)
+  {
+    try {
+      future.check_if_valid();
+      auto fut = std::make_shared<Future<Res>>(std::move(future));
+      Event_loop_detail::add(fut->m_state, [fut, callback]() {
+        callback(*fut);
+      });
+    }
+    CATCH_AND_WRAP
+  }
+
+  /**
+    Perform one iteration of the loop: wait at most `timeout` milliseconds
+    (no limit if negative) for server replies and call callbacks of
+    operations whose results are ready. Returns false if there are no more
+    operations in the loop.
+  */
+
+  bool runOnce(int timeout = -1)
+  {
+    try {
+      return Event_loop_detail::run_once(timeout);
+    }
+    CATCH_AND_WRAP
+  }
+
+  /// Run the loop until results of all operations are ready.
+
+  void run()
+  {
+    try {
+      Event_loop_detail::run();
+    }
+    CATCH_AND_WRAP
+  }
+
+  /// Return number of operations in the loop.
+
+  size_t count() const
+  {
+    try {
+      return Event_loop_detail::size();
+    }
+    CATCH_AND_WRAP
+  }
+
+  template <class, class> friend class Executable;
+};
+
+
+}  // mysqlx
+
+#endif
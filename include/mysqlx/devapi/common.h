@@ -41,6 +41,9 @@
 #include <forward_list>
 #include <string.h>  // for memcpy
 #include <utility>   // std::move etc
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 namespace cdk {
 namespace foundation {
@@ -57,6 +60,7 @@ using std::out_of_range;
 
 using common::byte;
 using common::GUID;
+using common::Decimal;
 class Value;
 
 
@@ -216,6 +220,51 @@ public:
 };
 
 
+/**
+  Reference to UTF-8 encoded text stored elsewhere.
+
+  Similar to C++17 `std::string_view`, it holds pointer to the text and its
+  length in bytes, but does not own the data. It is returned by methods such
+  as `Row::getUtf8()` which give access to text data without converting or
+  copying it.
+
+  @ingroup devapi_aux
+*/
+
+class utf8_view : public std::pair<const char*, size_t>
+{
+public:
+
+  utf8_view(const char *beg, size_t len) : pair(beg, len)
+  {}
+
+  utf8_view() : pair(nullptr, 0)
+  {}
+
+  const char* data() const { return first; }
+  const char* begin() const { return first; }
+  const char* end() const { return first + second; }
+
+  size_t length() const { return second; }
+  size_t size() const { return length(); }
+  bool   empty() const { return 0 == second; }
+
+  operator std::string() const
+  {
+    return first ? std::string(first, second) : std::string();
+  }
+
+#if __cplusplus >= 201703L
+
+  operator std::string_view() const
+  {
+    return std::string_view(first, second);
+  }
+
+#endif
+};
+
+
 /**
   Base class for connector errors.
 
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2.0, as
+ * published by the Free Software Foundation.
+ *
+ * This program is also distributed with certain software (including
+ * but not limited to OpenSSL) that is licensed under separate terms,
+ * as designated in a particular file or component or in included license
+ * documentation.  The authors of MySQL hereby grant you an
+ * additional permission to link the program and your derivative works
+ * with the separately licensed software that they have included with
+ * MySQL.
+ *
+ * Without limiting anything contained in the foregoing, this file,
+ * which is part of MySQL Connector/C++, is also subject to the
+ * Universal FOSS Exception, version 1.0, a copy of which can be found at
+ * http://oss.oracle.com/licenses/universal-foss-exception.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License, version 2.0, for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MYSQLX_DETAIL_ASYNC_H
+#define MYSQLX_DETAIL_ASYNC_H
+
+/**
+  @file
+  Details for public API classes supporting asynchronous execution.
+*/
+
+
+#include "../common.h"
+#include "../../common/op_if.h"
+
+#include <functional>
+#include <exception>
+
+
+namespace mysqlx {
+
+namespace internal {
+
+
+/*
+  State of an asynchronous execution of an operation, shared between the
+  future representing the execution and the event loop which drives it.
+
+  Member m_impl is the implementation of the operation being executed.
+  When execution is completed, m_done is set and m_error holds the error
+  thrown during execution, if any. If the future was bound to an event loop
+  when it was created, m_loop points at that loop.
+*/
+
+class Event_loop_detail;
+
+struct Async_state
+{
+  std::shared_ptr<common::Executable_if> m_impl;
+  Event_loop_detail *m_loop = nullptr;
+  bool m_done = false;
+  std::exception_ptr m_error;
+
+  Async_state(const std::shared_ptr<common::Executable_if> &impl,
+              Event_loop_detail *loop)
+    : m_impl(impl), m_loop(loop)
+  {}
+
+  /*
+    Push execution forward without blocking. Errors thrown by the operation
+    are stored in m_error. Returns true if execution is completed.
+  */
+
+  bool cont()
+  {
+    if (m_done)
+      return true;
+    try {
+      m_done = m_impl->cont();
+    }
+    catch (...)
+    {
+      m_error = std::current_exception();
+      m_done = true;
+    }
+    return m_done;
+  }
+
+  // Block until execution is completed.
+
+  void wait()
+  {
+    if (m_done)
+      return;
+    try {
+      m_impl->wait();
+    }
+    catch (...)
+    {
+      m_error = std::current_exception();
+    }
+    m_done = true;
+  }
+};
+
+using Shared_async_state = std::shared_ptr<Async_state>;
+
+
+/*
+  Event loop implementation is based on CDK event loop which waits for
+  socket events of all the operations registered with it (see
+  devapi/async.cc).
+*/
+
+class Event_loop_impl;
+
+class PUBLIC_API Event_loop_detail
+{
+  DLL_WARNINGS_PUSH
+  std::shared_ptr<Event_loop_impl> m_impl;
+  DLL_WARNINGS_POP
+
+protected:
+
+  Event_loop_detail();
+
+  Event_loop_detail(const Event_loop_detail&) = delete;
+  Event_loop_detail& operator=(const Event_loop_detail&) = delete;
+
+  virtual ~Event_loop_detail() {}
+
+public:
+
+  /*
+    Register asynchronous execution with the loop. The callback is called
+    when execution is completed (or failed).
+  */
+
+  void add(const Shared_async_state&, const std::function<void()>&);
+
+  bool run_once(int timeout);
+  void run();
+  size_t size() const;
+};
+
+
+}  // internal
+}  // mysqlx
+
+#endif
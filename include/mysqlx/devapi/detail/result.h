@@ -42,6 +42,7 @@
 #include "../document.h"
 #include "../row.h"
 #include "../collations.h"
+#include "../../common/arrow.h"
 
 #include <deque>
 
@@ -370,6 +371,11 @@ protected:
     return iterator_get();
   }
 
+  // Export of result data in Arrow C Data Interface format.
+
+  void export_schema(ArrowSchema*);
+  row_count_t export_batch(ArrowArray*, row_count_t max_rows);
+
 private:
 
   // Storage for result column information.
@@ -71,6 +71,7 @@ protected:
 
   col_count_t col_count() const;
   bytes       get_bytes(col_count_t) const;
+  utf8_view   get_utf8(col_count_t) const;
   Value&      get_val(col_count_t);
 
   void clear()
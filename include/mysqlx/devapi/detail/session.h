@@ -51,6 +51,7 @@ class Collection;
 
 namespace common {
   class Session_impl;
+  class Session_pool;
   class Result_init;
 }
 
@@ -59,6 +60,7 @@ namespace internal {
 class Schema_detail;
 using Session_impl = common::Session_impl;
 using Shared_session_impl = std::shared_ptr<common::Session_impl>;
+using Shared_session_pool = std::shared_ptr<common::Session_pool>;
 
 /*
   Base class for database objects. Can't be used alone.
@@ -258,6 +260,8 @@ struct PUBLIC_API Session_detail
   Session_detail(const Session_detail&) = delete;
   Session_detail& operator=(const Session_detail&) = delete;
 
+  Session_detail(Session_detail&&) = default;
+
   /*
     Sources for lists of schemata and schema names. Only schemata matching
     the given SQL-style pattern are listed.
@@ -310,6 +314,7 @@ protected:
   DLL_WARNINGS_POP
 
   Session_detail(common::Settings_impl&);
+  Session_detail(const Shared_session_pool&);
 
   virtual ~Session_detail()
   {
@@ -380,6 +385,34 @@ public:
   /// @endcond
 };
 
+
+/*
+  Client keeps a pool of sessions (see common::Session_pool). The pool is
+  shared between all copies of a client object and the sessions obtained
+  from it.
+*/
+
+class PUBLIC_API Client_detail
+{
+protected:
+
+  DLL_WARNINGS_PUSH
+  Shared_session_pool  m_impl = NULL;
+  DLL_WARNINGS_POP
+
+  Client_detail(common::Settings_impl&);
+
+  const Shared_session_pool& get_pool();
+
+  void close();
+
+public:
+
+  /// @cond IGNORED
+  friend Session;
+  /// @endcond
+};
+
 }  // internal namespace
 }  // mysqlx namespace
 
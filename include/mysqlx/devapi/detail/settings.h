@@ -52,6 +52,7 @@ class Settings_detail
   using SOption    = typename Traits::Options;
   using SSLMode    = typename Traits::SSLMode;
   using AuthMethod = typename Traits::AuthMethod;
+  using CompressionMode = typename Traits::CompressionMode;
 
 public:
 
@@ -72,7 +73,8 @@ protected:
 
 #define OPT_VAL_TYPE(X) \
   X(SSL_MODE,SSLMode) \
-  X(AUTH,AuthMethod)
+  X(AUTH,AuthMethod) \
+  X(COMPRESSION,CompressionMode)
 
 #define CHECK_OPT(Opt,Type) \
   if (opt == Option::Opt) \
@@ -123,6 +125,16 @@ protected:
     return unsigned(m);
   }
 
+  static Value opt_val(Option opt, CompressionMode m)
+  {
+    if (opt != Option::COMPRESSION)
+      throw Error(
+        "SessionSettings::CompressionMode value can only be used on"
+        " COMPRESSION setting."
+      );
+    return unsigned(m);
+  }
+
 
   using opt_val_t = std::pair<Option, Value>;
   using opt_list_t = std::list<opt_val_t>;
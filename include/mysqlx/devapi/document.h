@@ -248,6 +248,10 @@ public:
   Values of type RAW can refer to a region of memory containing raw bytes.
   Such values are created from `bytes` and can by casted to `bytes` type.
 
+  Values of DECIMAL columns are reported as DOUBLE values and can be
+  converted to `double`. Their exact value can be obtained with
+  `get<Decimal>()` (unless it has too many digits to fit in a `Decimal`).
+
   @note Value object copies the values it stores. Thus, after storing value
   in Value object, the original value can be destroyed without invalidating
   the copy. This includes RAW Values which hold a copy of bytes.
@@ -434,6 +438,28 @@ public:
   }
 
 
+  /**
+    Get UTF-8 representation of a string value without copying it.
+
+    The returned view points to data stored inside this Value instance and
+    is valid as long as the instance is not modified or destroyed. Values
+    which hold wide strings are converted to UTF-8 on the first call.
+
+    @throws Error if this is not a string value.
+  */
+
+  utf8_view getUtf8() const
+  {
+    try {
+      if (VAL != m_type)
+        throw Error("Value cannot be converted to string");
+      const std::string &str = get_string();
+      return{ str.data(), str.length() };
+    }
+    CATCH_AND_WRAP
+  }
+
+
   /**
     Return type of the value stored in this instance (or VNULL if no
     value is stored).
@@ -653,6 +679,7 @@ Value::Type Value::getType() const
     case common::Value::RAW:      return RAW;
     case common::Value::EXPR:     return STRING;
     case common::Value::JSON:     return DOCUMENT;
+    case common::Value::DECIMAL:  return DOUBLE;
     default: break;
     }
   default: assert(false); return VNULL; // quiet compiler warning
@@ -856,6 +883,17 @@ Value::operator double() const
 }
 
 
+template<>
+inline
+Decimal Value::get<Decimal>() const
+{
+  try {
+    return get_decimal();
+  }
+  CATCH_AND_WRAP
+}
+
+
 inline Value::Value(bool val)
 try
   : common::Value(val)
@@ -39,6 +39,7 @@
 
 #include "common.h"
 #include "result.h"
+#include "async.h"
 #include "../common/op_if.h"
 
 
@@ -141,6 +142,25 @@ public:
   }
 
 
+  /**
+    Set the number of rows fetched from the server in one batch when
+    reading results of this operation.
+
+    If not set, the value of `SessionOption::PREFETCH_SIZE` is used.
+    Value 0 selects adaptive batch size based on the observed size of
+    result rows.
+  */
+
+  Executable& prefetch(unsigned rows)
+  {
+    try {
+      get_impl()->set_prefetch_size(rows);
+      return *this;
+    }
+    CATCH_AND_WRAP
+  }
+
+
   /// Execute given operation and return its result.
 
   virtual Res execute()
@@ -158,6 +178,65 @@ public:
     CATCH_AND_WRAP
   }
 
+
+  /**
+    Start asynchronous execution of the operation and return a future
+    which gives its result.
+
+    The operation is sent to the server before this method returns but
+    the reply is processed only when the future is waited for or asked
+    whether it is ready.
+  */
+
+  Future<Res> executeAsync()
+  {
+    try {
+      return Future<Res>(start_async(nullptr));
+    }
+    CATCH_AND_WRAP
+  }
+
+
+  /**
+    Start asynchronous execution of the operation and return a future bound
+    to the given event loop. When awaited in a coroutine, the future is
+    added to the loop which resumes the coroutine once the result is ready.
+  */
+
+  Future<Res> executeAsync(EventLoop &loop)
+  {
+    try {
+      return Future<Res>(
+        start_async(static_cast<internal::Event_loop_detail*>(&loop))
+      );
+    }
+    CATCH_AND_WRAP
+  }
+
+private:
+
+  internal::Shared_async_state start_async(internal::Event_loop_detail *loop)
+  {
+    check_if_valid();
+
+    /*
+      The future gets its own copy of the implementation object, so that
+      this executable can be modified and executed again while the
+      asynchronous execution is in progress.
+    */
+
+    auto state = std::make_shared<internal::Async_state>(
+      std::shared_ptr<Impl>(m_impl->clone()), loop
+    );
+
+    // Note: this sends the operation to the server.
+
+    state->cont();
+    return state;
+  }
+
+public:
+
   struct Access;
   friend Access;
 };
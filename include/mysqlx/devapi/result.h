@@ -58,6 +58,7 @@ class DbDoc;
 class DocResult;
 
 template <class Res, class Op> class Executable;
+template <class Res> class Future;
 
 
 namespace internal {
@@ -225,6 +226,8 @@ private:
 
   template <class Res, class Op>
   friend class Executable;
+  template <class Res>
+  friend class Future;
   friend Collection;
 };
 
@@ -525,6 +528,14 @@ auto internal::Row_result_detail<Columns>::get_columns() const
 template<> PUBLIC_API
 row_count_t internal::Row_result_detail<Columns>::row_count();
 
+template<> PUBLIC_API
+void internal::Row_result_detail<Columns>::export_schema(ArrowSchema*);
+
+template<> PUBLIC_API
+row_count_t internal::Row_result_detail<Columns>::export_batch(
+  ArrowArray*, row_count_t
+);
+
 } // internal
 
 
@@ -630,6 +641,42 @@ public:
     CATCH_AND_WRAP
   }
 
+  /**
+    Describe columns of this result as an Arrow schema.
+
+    The schema is a struct (format "+s") with one child for each result
+    column. It is filled using the Arrow C Data Interface and must be released
+    by calling its `release` callback.
+  */
+
+  void exportArrowSchema(ArrowSchema *schema)
+  {
+    try {
+      Row_result_detail::export_schema(schema);
+    }
+    CATCH_AND_WRAP
+  }
+
+  /**
+    Fetch next batch of rows as an Arrow array.
+
+    At most `maxRows` rows are fetched (all remaining rows if `maxRows` is 0).
+    The array is a struct array matching the schema returned by
+    `exportArrowSchema()`, with one child array per column. It must be
+    released by calling its `release` callback. If there are no more rows,
+    returns 0 and the array is not filled (its `release` member is null).
+
+    Rows fetched this way are not available to `fetchOne()` or `fetchAll()`.
+  */
+
+  row_count_t fetchArrowBatch(ArrowArray *array, row_count_t maxRows = 0)
+  {
+    try {
+      return Row_result_detail::export_batch(array, maxRows);
+    }
+    CATCH_AND_WRAP
+  }
+
   /*
    Iterate over rows (range-for support).
 
@@ -663,6 +710,7 @@ private:
 public:
 
   template <class Res, class Op> friend class Executable;
+  template <class Res> friend class Future;
   friend SqlResult;
   friend DocResult;
 };
@@ -756,6 +804,8 @@ private:
 
   template <class Res, class Op>
   friend class Executable;
+  template <class Res>
+  friend class Future;
 };
 
 
@@ -862,6 +912,8 @@ private:
   friend DbDoc;
   template <class Res,class Op>
   friend class Executable;
+  template <class Res>
+  friend class Future;
 };
 
 
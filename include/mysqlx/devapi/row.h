@@ -116,6 +116,28 @@ public:
   }
 
 
+  /**
+    Get UTF-8 text of a string field at position `pos`.
+
+    If the field is stored in UTF-8 encoding in the data received from the
+    server, the returned view points directly into that data and no
+    conversion or copy is done. Otherwise the field value is converted first.
+    In either case the view is valid as long as this row exists.
+
+    @returns null view if given field is NULL.
+    @throws out_of_range if given field does not exist in the row.
+    @throws Error if given field is not a string.
+  */
+
+  utf8_view getUtf8(col_count_t pos) const
+  {
+    try {
+      return Row_detail::get_utf8(pos);
+    }
+    CATCH_AND_WRAP
+  }
+
+
   /**
     Get reference to row field at position `pos`.
 
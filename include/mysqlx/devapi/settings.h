@@ -127,6 +127,40 @@ std::string SSLModeName(SSLMode m)
 /// @endcond
 
 
+/**
+  Modes to be used with `COMPRESSION` option
+*/
+
+enum_class CompressionMode
+{
+#define COMPRESSION_ENUM(X,N) X = N,
+
+  COMPRESSION_MODE_LIST(COMPRESSION_ENUM)
+};
+
+
+/// @cond DISABLED
+
+inline
+std::string CompressionModeName(CompressionMode m)
+{
+#define COMPRESSION_NAME(X,N) case CompressionMode::X: return #X;
+
+  switch(m)
+  {
+    COMPRESSION_MODE_LIST(COMPRESSION_NAME)
+    default:
+    {
+      std::ostringstream buf;
+      buf << "<UKNOWN (" << unsigned(m) << ")>" << std::ends;
+      return buf.str();
+    }
+  };
+}
+
+/// @endcond
+
+
 /**
   Authentication methods to be used with `AUTH` option.
 */
@@ -173,6 +207,7 @@ struct Settings_traits
   using Options    = mysqlx::SessionOption;
   using SSLMode    = mysqlx::SSLMode;
   using AuthMethod = mysqlx::AuthMethod;
+  using CompressionMode = mysqlx::CompressionMode;
 
   static std::string get_mode_name(SSLMode mode)
   {
@@ -188,6 +223,11 @@ struct Settings_traits
   {
     return AuthMethodName(m);
   }
+
+  static std::string get_compression_name(CompressionMode m)
+  {
+    return CompressionModeName(m);
+  }
 };
 
 
@@ -201,6 +241,7 @@ internal::Settings_detail<internal::Settings_traits>::do_set(opt_list_t &&opts);
 
 
 class Session;
+class Client;
 
 /**
   Represents session options to be passed at session creation time.
@@ -285,6 +326,7 @@ public:
 
     - `ssl-mode` : define `SSLMode` option to be used
     - `ssl-ca=`path : path to a PEM file specifying trusted root certificates
+    - `compression` : define `CompressionMode` option to be used
   */
 
   SessionSettings(const string &uri)
@@ -544,6 +586,7 @@ public:
 private:
 
   friend Session;
+  friend Client;
 };
 
 
@@ -219,6 +219,18 @@ typedef struct mysqlx_session_struct mysqlx_session_t;
 typedef struct mysqlx_session_options_struct mysqlx_session_options_t;
 
 
+/**
+  Type of client handles.
+
+  A client keeps a pool of connections from which sessions can be
+  obtained.
+
+  @see mysqlx_get_client_from_url(), mysqlx_get_session_from_client()
+*/
+
+typedef struct mysqlx_client_struct mysqlx_client_t;
+
+
 /**
   Type of database schema handles.
 
@@ -349,6 +361,17 @@ typedef enum mysqlx_sort_direction_enum
   value of `SSL_MODE_VERIFY_CA` or `SSL_MODE_VERIFY_IDENTITY`.
   If `MYSQLX_OPT_SSL_MODE` is not explicitly given then setting
   `MYSQLX_OPT_SSL_CA` implies `SSL_MODE_VERIFY_CA`.
+
+  @note `MYSQLX_OPT_PREFETCH_SIZE` value 0 (the default) selects adaptive
+  batch size based on the observed size of result rows. It can be changed
+  for individual statements with `mysqlx_set_prefetch_size()`.
+
+  @note If `MYSQLX_OPT_MAX_INSERT_SIZE` is set, documents or rows inserted
+  by a single statement are sent to the server in several insert messages,
+  each of about that many bytes. The statement result reports totals for all
+  the messages. The messages are executed as separate statements: if one
+  of them fails, the earlier ones are not undone unless the insert is done
+  inside a transaction. By default inserts are not split.
 */
 
 typedef enum mysqlx_opt_type_enum
@@ -375,6 +398,12 @@ mysqlx_opt_type_t;
 #define OPT_SSL_CA(A)   MYSQLX_OPT_SSL_CA, (A)
 #define OPT_PRIORITY(A) MYSQLX_OPT_PRIORITY, (unsigned int)(A)
 #define OPT_AUTH(A)     MYSQLX_OPT_AUTH, (unsigned int)(A)
+#define OPT_PREFETCH_SIZE(A) MYSQLX_OPT_PREFETCH_SIZE, (unsigned int)(A)
+#define OPT_POOL_MAX_SIZE(A) MYSQLX_OPT_POOL_MAX_SIZE, (unsigned int)(A)
+#define OPT_POOL_QUEUE_TIMEOUT(A) MYSQLX_OPT_POOL_QUEUE_TIMEOUT, (unsigned int)(A)
+#define OPT_POOL_MAX_IDLE_TIME(A) MYSQLX_OPT_POOL_MAX_IDLE_TIME, (unsigned int)(A)
+#define OPT_COMPRESSION(A) MYSQLX_OPT_COMPRESSION, (unsigned int)(A)
+#define OPT_MAX_INSERT_SIZE(A) MYSQLX_OPT_MAX_INSERT_SIZE, (unsigned int)(A)
 
 /**
   Session SSL mode values for use with `mysqlx_session_option_get()`
@@ -404,6 +433,20 @@ typedef enum mysqlx_auth_method_enum
 }
 mysqlx_auth_method_t;
 
+/**
+  Compression mode values for use with `mysqlx_session_option_get()`
+  and `mysqlx_session_option_set()` functions setting or getting
+  MYSQLX_OPT_COMPRESSION option.
+*/
+
+typedef enum mysqlx_compression_mode_enum
+{
+#define XAPI_COMPRESSION_ENUM(X,N)  MYSQLX_COMPRESSION_##X = N,
+
+  COMPRESSION_MODE_LIST(XAPI_COMPRESSION_ENUM)
+}
+mysqlx_compression_mode_t;
+
 
 /**
   Constants for defining the row locking options for
@@ -546,6 +589,107 @@ PUBLIC_API void mysqlx_session_close(mysqlx_session_t *session);
 
 PUBLIC_API int mysqlx_session_valid(mysqlx_session_t *sess);
 
+
+/**
+  Create a client with a pool of connections specified by connection
+  string or URL.
+
+  Connection string has the same form as for `mysqlx_get_session_from_url()`.
+  The pool is configured with the following options:
+
+  - `pool-max-size=`N : maximum number of connections in the pool
+    (default 25)
+  - `pool-queue-timeout=`T : time in milliseconds to wait for a free
+    connection if all connections are in use; 0 (the default) means no limit
+  - `pool-max-idle-time=`T : time in milliseconds after which an idle
+    connection is closed; 0 (the default) means never
+
+  No connection is made when the client is created.
+
+  @param conn_string    connection string
+  @param[out] out_error if error happens the error message is returned
+                        through this parameter
+  @param[out] err_code  if error happens the error code is returned through
+                        this parameter
+
+  @return client handle or NULL in case of error
+
+  @note The client returned by the function must be closed using
+        `mysqlx_client_close()`.
+
+  @ingroup xapi_sess
+*/
+
+PUBLIC_API mysqlx_client_t *
+mysqlx_get_client_from_url(const char *conn_string,
+                     char out_error[MYSQLX_MAX_ERROR_LEN], int *err_code);
+
+
+/**
+  Create a client with a pool of connections using session configuration
+  data.
+
+  Pool is configured with `MYSQLX_OPT_POOL_MAX_SIZE`,
+  `MYSQLX_OPT_POOL_QUEUE_TIMEOUT` and `MYSQLX_OPT_POOL_MAX_IDLE_TIME`
+  options (see `mysqlx_get_client_from_url()`).
+
+  @param opt  handle to session configuration data
+  @param[out] out_error if error happens the error message is returned
+                        through this parameter
+  @param[out] err_code  if error happens the error code is returned through
+                        this parameter
+
+  @return client handle or NULL in case of error
+
+  @note The client returned by the function must be closed using
+        `mysqlx_client_close()`.
+
+  @ingroup xapi_sess
+*/
+
+PUBLIC_API mysqlx_client_t *
+mysqlx_get_client_from_options(mysqlx_session_options_t *opt,
+                       char out_error[MYSQLX_MAX_ERROR_LEN], int *err_code);
+
+
+/**
+  Get a session from the connection pool of a client.
+
+  An idle connection from the pool is re-used if available. Otherwise a new
+  connection is made, unless the pool is full. In that case the function
+  waits until a connection is returned to the pool.
+
+  @param cli  client handle
+
+  @return session handle or NULL in case of error. The error can be
+          examined with `mysqlx_error()` called for the client handle.
+
+  @note The session must be closed with `mysqlx_session_close()`, which
+        returns its connection to the pool. The connection is reset so that
+        the next session using it starts with a clean state.
+
+  @ingroup xapi_sess
+*/
+
+PUBLIC_API mysqlx_session_t *
+mysqlx_get_session_from_client(mysqlx_client_t *cli);
+
+
+/**
+  Close the client.
+
+  Idle connections in the pool are closed immediately. Connections used by
+  sessions obtained from the client are closed when these sessions are
+  closed.
+
+  @param cli  client handle
+
+  @ingroup xapi_sess
+*/
+
+PUBLIC_API void mysqlx_client_close(mysqlx_client_t *cli);
+
+
 /**
   Get a list of schemas.
 
@@ -2231,6 +2375,27 @@ mysqlx_set_limit_and_offset(mysqlx_stmt_t *stmt, uint64_t row_count,
 PUBLIC_API int
 mysqlx_set_row_locking(mysqlx_stmt_t *stmt, int locking);
 
+
+/**
+  Set the number of rows fetched from the server in one batch when reading
+  results of the statement.
+
+  Rows are read from the server and cached in batches. Larger batches
+  reduce per-row overheads but use more memory for the row cache. If not
+  set, the value of `MYSQLX_OPT_PREFETCH_SIZE` session option is used.
+
+  @param stmt statement handle
+  @param row_count the number of rows in one batch; 0 selects adaptive batch
+         size based on the observed size of result rows
+
+  @return `RESULT_OK` - on success; `RESULT_ERR` - on error
+
+  @ingroup xapi_stmt
+*/
+
+PUBLIC_API int
+mysqlx_set_prefetch_size(mysqlx_stmt_t *stmt, uint32_t row_count);
+
 /**
   Free the statement handle explicitly.
 
@@ -2262,7 +2427,8 @@ PUBLIC_API void mysqlx_free(mysqlx_stmt_t *stmt);
           occurred. In case of an error it can be retrieved from
           the result using `mysqlx_error()` or `mysqlx_error_message()`.
 
-  @note The previously fetched row and its data will become invalid.
+  @note If `mysqlx_stream_result()` was called for the result, the previously
+        fetched row and its data will become invalid.
 
   @ingroup xapi_res
 */
@@ -2282,7 +2448,8 @@ PUBLIC_API mysqlx_row_t * mysqlx_row_fetch_one(mysqlx_result_t *res);
 
   @return pointer to character JSON string or NULL if no more documents left
           in the result. No need to free this data as it is tied and freed
-          with the result handle.
+          with the result handle (or with the next fetch call if
+          `mysqlx_stream_result()` was called).
 
   @ingroup xapi_res
 */
@@ -2353,6 +2520,119 @@ PUBLIC_API int
 mysqlx_store_result(mysqlx_result_t *result, size_t *num);
 
 
+/**
+  Stream result data without keeping fetched rows
+
+  By default, row handles returned by `mysqlx_row_fetch_one()` and strings
+  returned by `mysqlx_json_fetch_one()` stay valid until the result handle
+  is freed. All fetched rows are kept in memory until then. After calling
+  this function only the most recently fetched row is kept. It is released
+  by the next fetch call. Then the memory used by the result does not grow
+  with the number of rows fetched from it.
+
+  @param result result handle
+
+  @return `RESULT_OK` - on success; `RESULT_ERR` - on error. If the error
+          occurred it can be retrieved by `mysqlx_error()` function.
+
+  @note The mode remains in effect for the following result sets of the
+        same result (see `mysqlx_next_result()`).
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_stream_result(mysqlx_result_t *result);
+
+
+/**
+  Free a row handle explicitly
+
+  Row handles are freed automatically when the result handle is freed
+  (or, if `mysqlx_stream_result()` was called, when the next row is
+  fetched). This function can be used to release a row earlier. After
+  this call the row handle and data obtained from it become invalid.
+
+  @param row row handle returned by `mysqlx_row_fetch_one()`
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API void mysqlx_row_free(mysqlx_row_t *row);
+
+
+/**
+  Bind an output buffer to a result column
+
+  Bound buffers are filled by `mysqlx_fetch_bound()` which reads many rows
+  at once and decodes column values directly into the buffers. This avoids
+  calling `mysqlx_get_sint()` and other accessors for each field.
+
+  The buffer is an array with one element for each row fetched by a single
+  `mysqlx_fetch_bound()` call. Type of array elements is given by `type`:
+
+  - `MYSQLX_TYPE_SINT` - `int64_t`, for integer columns,
+  - `MYSQLX_TYPE_UINT` - `uint64_t`, for integer columns,
+  - `MYSQLX_TYPE_DOUBLE` - `double`, for numeric columns,
+  - `MYSQLX_TYPE_FLOAT` - `float`, for numeric columns,
+  - `MYSQLX_TYPE_BYTES` - slots of `elem_size` bytes, for columns of any
+    type; raw bytes are stored as with `mysqlx_get_bytes()` and truncated
+    if they do not fit into a slot.
+
+  @param res result handle
+  @param col zero-based column number
+  @param type type of buffer elements (see above)
+  @param buf the buffer; NULL removes earlier binding of the column
+  @param elem_size size of a single slot for `MYSQLX_TYPE_BYTES` buffers,
+         ignored for other types
+  @param[out] lengths optional array which receives the length of each
+              value; for `MYSQLX_TYPE_BYTES` this is the full length of the
+              value, which is bigger than `elem_size` if it was truncated;
+              0 for NULL values
+  @param[out] is_null optional array which receives null indicators
+
+  @return `RESULT_OK` - on success; `RESULT_ERR` - on error
+
+  @note Bindings are removed when the result moves to the next result set
+        (see `mysqlx_next_result()`).
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_bind_column(mysqlx_result_t *res, uint32_t col, uint16_t type,
+                   void *buf, size_t elem_size,
+                   size_t *lengths, bool *is_null);
+
+
+/**
+  Fetch rows into the bound buffers
+
+  Reads at most `max_rows` rows from the result and stores values of
+  columns bound with `mysqlx_bind_column()` in the bound buffers. Values of
+  the i-th fetched row are stored at position i of the buffers.
+
+  @param res result handle
+  @param max_rows maximum number of rows to fetch; bound buffers must have
+         room for that many elements
+  @param[out] rows the number of rows fetched
+
+  @return `RESULT_OK` - on success; `RESULT_NULL` when no rows were fetched
+          because there are no more rows; `RESULT_ERR` - on error
+
+  @note If a value of a row can not be stored in its bound buffer (for
+        example, because of numeric overflow), fetching stops before that
+        row. If some rows were fetched already, `RESULT_OK` is returned
+        with their count and the error is reported by the next call. The
+        row which caused the error is skipped.
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_fetch_bound(mysqlx_result_t *res, uint32_t max_rows, uint32_t *rows);
+
+
 /**
   Get identifiers of the documents added to the collection.
 
@@ -2510,6 +2790,48 @@ PUBLIC_API int
 mysqlx_get_double(mysqlx_row_t* row, uint32_t col, double *val);
 
 
+/**
+  Exact value of a DECIMAL number.
+
+  The value is stored as a fixed-point number: it equals `M * 10^(-scale)`,
+  where `M` is the unsigned 128-bit integer whose higher and lower 64 bits
+  are `high` and `low`. The value is negative if `negative` is true.
+
+  @ingroup xapi_res
+*/
+
+typedef struct mysqlx_decimal_struct
+{
+  uint64_t high;
+  uint64_t low;
+  uint8_t  scale;
+  bool     negative;
+} mysqlx_decimal_t;
+
+
+/**
+  Get the exact value of a DECIMAL number from a row.
+
+  Unlike `mysqlx_get_double()`, the value is not rounded. The column must
+  be of type `MYSQLX_TYPE_DECIMAL` or an integer type. DECIMAL values that
+  do not fit in 128 bits (possible for columns with more than 38 digits)
+  are reported as errors - use `mysqlx_get_double()` to get them.
+
+  @param row row handle
+  @param col zero-based column number
+  @param[out] val the pointer to a `mysqlx_decimal_t` structure in which
+                  to write the data
+
+  @return `RESULT_OK` - on success; `RESULT_NULL` when the column is NULL;
+          `RESULT_ERR` - on error
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_get_decimal(mysqlx_row_t* row, uint32_t col, mysqlx_decimal_t *val);
+
+
 /**
   Free the result explicitly.
 
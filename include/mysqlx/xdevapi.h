@@ -1056,6 +1056,8 @@ uint64_t Collection::count()
 
 using SqlStatement = internal::SQL_statement;
 
+class Client;
+
 
 /**
   Represents a session which gives access to data stored in a data store.
@@ -1137,6 +1139,25 @@ public:
   {}
 
 
+  /**
+    Get a session from the connection pool of the given client.
+
+    An idle session from the pool is re-used if available. When this session
+    is closed or destroyed, it is returned to the pool.
+
+    @see `Client`
+  */
+
+  Session(Client &client);
+
+
+  Session(Session &&other)
+  try
+    : Session_detail(std::move(other))
+  {}
+  CATCH_AND_WRAP
+
+
   /**
     Create a new schema.
 
@@ -1412,6 +1433,98 @@ public:
 };
 
 
+/**
+  A client which keeps a pool of connections to the data store.
+
+  A `Client` is created from the same settings as a `Session`. Sessions
+  obtained from a client with `getSession()` re-use connections from the
+  pool. When such session is closed, its connection is reset and returned
+  to the pool instead of being closed. Resetting a connection clears its
+  session state, such as an open transaction or session variables.
+
+  The pool is configured with the following options (all optional):
+
+  - `SessionOption::POOL_MAX_SIZE` : maximum number of connections in
+    the pool (default 25),
+  - `SessionOption::POOL_QUEUE_TIMEOUT` : time in milliseconds to wait for
+    a free connection when the pool is full; 0 (the default) means no limit,
+  - `SessionOption::POOL_MAX_IDLE_TIME` : time in milliseconds after which
+    an idle connection is closed; 0 (the default) means never.
+
+  The same options can be given in a connection string as `pool-max-size`,
+  `pool-queue-timeout` and `pool-max-idle-time`.
+
+  A client can be used from several threads, but each session obtained
+  from it should be used by one thread at a time.
+
+  @ingroup devapi
+*/
+
+class Client
+  : private internal::Client_detail
+{
+public:
+
+  /**
+    Create a client specified by a `SessionSettings` object.
+  */
+
+  Client(SessionSettings settings)
+  try
+    : Client_detail(settings)
+  {}
+  CATCH_AND_WRAP
+
+  /**
+    Create a client using given settings.
+
+    This constructor forwards arguments to a `SessionSettings` constructor.
+  */
+
+  template<typename...T>
+  Client(T...options)
+    : Client(SessionSettings(options...))
+  {}
+
+  /**
+    Get a session which uses a connection from the pool.
+  */
+
+  Session getSession()
+  {
+    return Session(*this);
+  }
+
+  /**
+    Close the client.
+
+    Idle connections in the pool are closed immediately, connections used by
+    existing sessions are closed when these sessions are closed. After
+    closing the client it is not possible to get new sessions from it.
+  */
+
+  void close()
+  {
+    try {
+      Client_detail::close();
+    }
+    CATCH_AND_WRAP
+  }
+
+  ///@cond IGNORE
+  friend Session;
+  ///@endcond
+};
+
+
+inline
+Session::Session(Client &client)
+try
+  : Session_detail(client.get_pool())
+{}
+CATCH_AND_WRAP
+
+
 inline
 Schema::Schema(Session &sess, const string &name)
   : Schema_detail(sess.m_impl, name)
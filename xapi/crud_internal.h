@@ -60,6 +60,40 @@ public:
   std::vector<std::string> m_doc_id_list;
   size_t m_current_id_index = 0;
 
+  /*
+    In streaming mode only the most recently fetched row is kept in
+    m_row_set and it is released when the next row is fetched.
+  */
+
+  bool m_streaming = false;
+
+  /*
+    Output buffers bound to columns of the current result set with
+    bind_column(). They are filled by fetch_bound().
+  */
+
+  struct Column_bind
+  {
+    const common::Format_info *m_fmt = nullptr;
+    uint16_t m_type = MYSQLX_TYPE_UNDEFINED;
+    void    *m_buf = nullptr;
+    size_t   m_elem_size = 0;
+    size_t  *m_lengths = nullptr;
+    bool    *m_is_null = nullptr;
+
+    void store(uint32_t row, const common::Row_data&, cdk::col_count_t);
+  };
+
+  std::vector<Column_bind> m_binds;
+
+  /*
+    Error in converting a row which was found by fetch_bound() after some
+    rows were already fetched. It is reported by the next fetch_bound()
+    call.
+  */
+
+  std::exception_ptr m_fetch_error;
+
 public:
 
 
@@ -81,20 +115,58 @@ public:
 
   mysqlx_error_struct *get_next_warning();
 
+  bool next_result()
+  {
+    // Note: bindings refer to meta-data of the current result set.
+    m_binds.clear();
+    m_fetch_error = nullptr;
+    return Impl::next_result();
+  }
+
   /*
     Read the next row from the result set and advance the cursor position
   */
   mysqlx_row_struct *read_row()
   {
+    /*
+      Note: Release the previous row before reading the next one so that
+      its row batch can be freed when the cache moves to the next batch.
+    */
+
+    if (m_streaming)
+      m_row_set.clear();
+
     const common::Row_data *data = get_row();
     check_errors();
     if (!data)
       return nullptr;
 
-    m_row_set.emplace_back(*data, m_mdata);
+    m_row_set.emplace_back(this, *data, m_mdata);
     return &m_row_set.back();
   }
 
+  /*
+    Release a row returned by read_row(). Returns false if the row does
+    not belong to this result.
+  */
+
+  bool free_row(mysqlx_row_struct*);
+
+  /*
+    Bind output buffer for values of the given column. Passing NULL buffer
+    removes the binding.
+  */
+
+  void bind_column(uint32_t col, uint16_t type, void *buf, size_t elem_size,
+                   size_t *lengths, bool *is_null);
+
+  /*
+    Read at most max_rows rows and store their values in the bound buffers.
+    Returns the number of rows read.
+  */
+
+  uint32_t fetch_bound(uint32_t max_rows);
+
 
   const char * read_json(size_t *json_byte_size);
 
@@ -215,6 +215,88 @@ mysqlx_get_session_from_options(mysqlx_session_options_t *opt,
 }
 
 
+/*
+  Create client with a pool of sessions.
+
+  Note: HANDLE_SESSION_EXCEPTIONS deletes the object pointed by `sess` if
+  an error is reported, so this name is used for the client handle.
+*/
+
+static mysqlx_client_struct *
+_get_client(const char *conn_str, mysqlx_session_options_t *opt,
+            char out_error[MYSQLX_MAX_ERROR_LEN], int *err_code)
+{
+  mysqlx_client_struct *sess = NULL;
+  try
+  {
+    if (conn_str)
+    {
+      mysqlx_session_options_struct uri_opt(conn_str);
+      sess = new mysqlx_client_struct(&uri_opt);
+    }
+    else
+    {
+      if (!opt)
+        throw cdk::Error(0, "Session options structure not initialized");
+      sess = new mysqlx_client_struct(opt);
+    }
+  }
+  HANDLE_SESSION_EXCEPTIONS
+  return sess;
+}
+
+
+mysqlx_client_struct * STDCALL
+mysqlx_get_client_from_url(const char *conn_string,
+                   char out_error[MYSQLX_MAX_ERROR_LEN], int *err_code)
+{
+  if (!conn_string)
+  {
+    const char *msg = "Connection string not specified";
+    mysqlx_client_struct *sess = NULL;
+    MYSQLX_HANDLE_ERROR(0, msg);
+    return NULL;
+  }
+
+  return _get_client(conn_string, NULL, out_error, err_code);
+}
+
+
+mysqlx_client_struct * STDCALL
+mysqlx_get_client_from_options(mysqlx_session_options_t *opt,
+                   char out_error[MYSQLX_MAX_ERROR_LEN], int *err_code)
+{
+  return _get_client(NULL, opt, out_error, err_code);
+}
+
+
+mysqlx_session_struct * STDCALL
+mysqlx_get_session_from_client(mysqlx_client_struct *cli)
+{
+  SAFE_EXCEPTION_BEGIN(cli, NULL)
+
+  cli->clear();
+  return new mysqlx_session_struct(cli);
+
+  SAFE_EXCEPTION_END(cli, NULL)
+}
+
+
+void STDCALL mysqlx_client_close(mysqlx_client_struct *cli)
+{
+  if (cli)
+  {
+    try {
+      delete cli;
+    }
+    catch (...)
+    {
+      // Ignore errors that might happen during client destruction.
+    }
+  }
+}
+
+
 /*
   Execute a plain SQL query (supports parameters and placeholders)
   PARAMETERS:
@@ -444,6 +526,16 @@ int mysqlx_set_row_locking(mysqlx_stmt_t *stmt, int locking)
 }
 
 
+int STDCALL
+mysqlx_set_prefetch_size(mysqlx_stmt_t *stmt, uint32_t row_count)
+{
+  SAFE_EXCEPTION_BEGIN(stmt, RESULT_ERROR)
+  stmt->m_impl->set_prefetch_size(row_count);
+  return RESULT_OK;
+  SAFE_EXCEPTION_END(stmt, RESULT_ERROR)
+}
+
+
 /*
   Set ORDER BY clause for statement operation
   Operations supported by this function:
@@ -699,6 +791,55 @@ mysqlx_store_result(mysqlx_result_struct *result, size_t *num)
 }
 
 
+int STDCALL
+mysqlx_stream_result(mysqlx_result_struct *result)
+{
+  SAFE_EXCEPTION_BEGIN(result, RESULT_ERROR)
+    if (!result->has_data())
+      throw Mysqlx_exception("Attempt to stream data for result without a data set");
+    result->m_streaming = true;
+    return RESULT_OK;
+  SAFE_EXCEPTION_END(result, RESULT_ERROR)
+}
+
+
+void STDCALL mysqlx_row_free(mysqlx_row_struct *row)
+{
+  if (row && row->m_result)
+  {
+    try {
+      row->m_result->free_row(row);
+    }
+    catch (...) {}
+  }
+}
+
+
+int STDCALL
+mysqlx_bind_column(mysqlx_result_struct *res, uint32_t col, uint16_t type,
+                   void *buf, size_t elem_size,
+                   size_t *lengths, bool *is_null)
+{
+  SAFE_EXCEPTION_BEGIN(res, RESULT_ERROR)
+  res->bind_column(col, type, buf, elem_size, lengths, is_null);
+  return RESULT_OK;
+  SAFE_EXCEPTION_END(res, RESULT_ERROR)
+}
+
+
+int STDCALL
+mysqlx_fetch_bound(mysqlx_result_struct *res, uint32_t max_rows,
+                   uint32_t *rows)
+{
+  SAFE_EXCEPTION_BEGIN(res, RESULT_ERROR)
+  OUT_BUF_CHECK(rows, res, MYSQLX_ERROR_OUTPUT_BUFFER_NULL, RESULT_ERROR)
+
+  *rows = res->fetch_bound(max_rows);
+  return 0 == *rows && 0 < max_rows ? RESULT_NULL : RESULT_OK;
+  SAFE_EXCEPTION_END(res, RESULT_ERROR)
+}
+
+
 /*
   Accessing row fields
   -------------------------------------------------------------------------
@@ -835,6 +976,29 @@ int STDCALL mysqlx_get_double(mysqlx_row_struct* row, uint32_t col, double *val)
 }
 
 
+int STDCALL
+mysqlx_get_decimal(mysqlx_row_struct* row, uint32_t col, mysqlx_decimal_t *val)
+{
+  SAFE_EXCEPTION_BEGIN(row, RESULT_ERROR)
+  OUT_BUF_CHECK(val, row, MYSQLX_ERROR_OUTPUT_BUFFER_NULL, RESULT_ERROR)
+  CHECK_COLUMN_RANGE(col, row)
+
+  Value &v = row->get(col);
+  if (v.is_null())
+    return RESULT_NULL;
+
+  common::Decimal dec = v.get_decimal();
+
+  val->high = dec.high();
+  val->low = dec.low();
+  val->scale = (uint8_t)dec.scale();
+  val->negative = dec.is_negative();
+  return RESULT_OK;
+
+  SAFE_EXCEPTION_END(row, RESULT_ERROR)
+}
+
+
 /*
   Get the number of columns in the result
   PARAMETERS:
@@ -147,6 +147,26 @@ handle_t* check_existence(bool check, handle_t *obj)
 }
 
 
+/*
+  Client handle which keeps a pool of sessions (see common::Session_pool).
+*/
+
+struct mysqlx_client_struct
+  : public Mysqlx_diag
+{
+  std::shared_ptr<mysqlx::common::Session_pool> m_impl;
+
+  mysqlx_client_struct(mysqlx_session_options_struct *opt)
+    : m_impl(std::make_shared<mysqlx::common::Session_pool>(*opt))
+  {}
+
+  ~mysqlx_client_struct()
+  {
+    m_impl->close();
+  }
+};
+
+
 struct mysqlx_session_struct
   : public Mysqlx_diag
 {
@@ -196,6 +216,8 @@ public:
     : mysqlx_session_struct(&opt)
   {}
 
+  mysqlx_session_struct(mysqlx_client_struct *cli);
+
 
   mysqlx::common::Session_impl& get_impl()
   {
@@ -450,7 +472,17 @@ struct mysqlx_row_struct
   : public Mysqlx_diag
   , public mysqlx::common::Row_impl<>
 {
-  using mysqlx::common::Row_impl<>::Row_impl;
+  // The result from which this row was fetched.
+
+  mysqlx_result_struct *m_result;
+
+  mysqlx_row_struct(
+    mysqlx_result_struct *res,
+    const mysqlx::common::Row_data &data,
+    const std::shared_ptr<mysqlx::common::Meta_data_base> &md
+  )
+    : Row_impl(data, md), m_result(res)
+  {}
 };
 
 
@@ -147,6 +147,237 @@ const char * mysqlx_result_struct::read_json(size_t *json_byte_size)
 }
 
 
+bool mysqlx_result_struct::free_row(mysqlx_row_struct *row)
+{
+  /*
+    Note: Rows are usually released soon after they were fetched, so we
+    look for the row starting from the most recent one.
+  */
+
+  for (auto it = m_row_set.end(); it != m_row_set.begin();)
+  {
+    --it;
+    if (&(*it) != row)
+      continue;
+    m_row_set.erase(it);
+    return true;
+  }
+
+  return false;
+}
+
+
+/*
+  Binding output buffers
+  ----------------------
+  Values of bound columns are decoded directly from raw row data, without
+  creating row handles or Value objects for the fields.
+*/
+
+void mysqlx_result_struct::bind_column(
+  uint32_t col, uint16_t type, void *buf, size_t elem_size,
+  size_t *lengths, bool *is_null
+)
+{
+  if (!has_data())
+    throw Mysqlx_exception("Attempt to bind columns of result without a data set");
+
+  if (col >= get_col_count())
+    throw Mysqlx_exception(MYSQLX_ERROR_INDEX_OUT_OF_RANGE_MSG);
+
+  m_binds.resize(get_col_count());
+
+  Column_bind &bind = m_binds[col];
+
+  if (!buf)
+  {
+    bind = Column_bind();
+    return;
+  }
+
+  const common::Format_info &fi = get_mdata()->get_format(col);
+
+  switch (type)
+  {
+  case MYSQLX_TYPE_SINT:
+  case MYSQLX_TYPE_UINT:
+    if (cdk::TYPE_INTEGER != fi.m_type)
+      throw Mysqlx_exception("Column can not be bound to an integer buffer");
+    elem_size = sizeof(int64_t);
+    break;
+
+  case MYSQLX_TYPE_FLOAT:
+  case MYSQLX_TYPE_DOUBLE:
+    if (cdk::TYPE_FLOAT != fi.m_type && cdk::TYPE_INTEGER != fi.m_type)
+      throw Mysqlx_exception(
+        "Column can not be bound to a floating point buffer"
+      );
+    elem_size = (MYSQLX_TYPE_FLOAT == type ? sizeof(float) : sizeof(double));
+    break;
+
+  case MYSQLX_TYPE_BYTES:
+    if (0 == elem_size)
+      throw Mysqlx_exception(MYSQLX_ERROR_OUTPUT_BUFFER_ZERO);
+    break;
+
+  default:
+    throw Mysqlx_exception("Unsupported type of bound buffer");
+  }
+
+  bind.m_fmt = &fi;
+  bind.m_type = type;
+  bind.m_buf = buf;
+  bind.m_elem_size = elem_size;
+  bind.m_lengths = lengths;
+  bind.m_is_null = is_null;
+}
+
+
+/*
+  If a value of some row can not be stored in its buffer, fetching stops
+  at that row. If some rows were fetched before, their count is returned
+  and the error is reported by the next call. The failing row is skipped.
+*/
+
+uint32_t mysqlx_result_struct::fetch_bound(uint32_t max_rows)
+{
+  if (m_fetch_error)
+  {
+    std::exception_ptr error = m_fetch_error;
+    m_fetch_error = nullptr;
+    std::rethrow_exception(error);
+  }
+
+  uint32_t row = 0;
+
+  for (; row < max_rows; ++row)
+  {
+    const common::Row_data *data = get_row();
+
+    if (!data)
+      break;
+
+    try {
+      for (cdk::col_count_t col = 0; col < m_binds.size(); ++col)
+      {
+        if (m_binds[col].m_buf)
+          m_binds[col].store(row, *data, col);
+      }
+    }
+    catch (...)
+    {
+      if (0 == row)
+        throw;
+      m_fetch_error = std::current_exception();
+      break;
+    }
+  }
+
+  check_errors();
+  return row;
+}
+
+
+void mysqlx_result_struct::Column_bind::store(
+  uint32_t row, const common::Row_data &data, cdk::col_count_t col
+)
+{
+  bool null = data.is_null(col);
+
+  if (m_is_null)
+    m_is_null[row] = null;
+
+  if (null)
+  {
+    if (m_lengths)
+      m_lengths[row] = 0;
+    return;
+  }
+
+  cdk::bytes raw = data.at(col);
+
+  if (MYSQLX_TYPE_BYTES == m_type)
+  {
+    /*
+      Note: Bytes are stored as by mysqlx_get_bytes(), and the reported
+      length can be bigger than the slot size if the value was truncated.
+    */
+
+    size_t len = std::min(raw.size(), m_elem_size);
+    memcpy((cdk::byte*)m_buf + row * m_elem_size, raw.begin(), len);
+    if (m_lengths)
+      m_lengths[row] = raw.size();
+    return;
+  }
+
+  double val_d = 0;
+  int64_t val_s = 0;
+  uint64_t val_u = 0;
+  bool is_unsigned = false;
+
+  switch (m_fmt->m_type)
+  {
+  case cdk::TYPE_INTEGER:
+  {
+    auto &fd = m_fmt->get<cdk::TYPE_INTEGER>();
+    is_unsigned = fd.m_format.is_unsigned();
+    if (is_unsigned)
+      fd.m_codec.from_bytes(raw, val_u);
+    else
+      fd.m_codec.from_bytes(raw, val_s);
+    val_d = is_unsigned ? (double)val_u : (double)val_s;
+    break;
+  }
+
+  case cdk::TYPE_FLOAT:
+    m_fmt->get<cdk::TYPE_FLOAT>().m_codec.from_bytes(raw, val_d);
+    break;
+
+  default:
+    assert(false);
+  }
+
+  switch (m_type)
+  {
+  case MYSQLX_TYPE_SINT:
+    if (is_unsigned)
+    {
+      if (val_u > (uint64_t)std::numeric_limits<int64_t>::max())
+        throw Mysqlx_exception("Numeric overflow");
+      val_s = (int64_t)val_u;
+    }
+    ((int64_t*)m_buf)[row] = val_s;
+    break;
+
+  case MYSQLX_TYPE_UINT:
+    if (!is_unsigned)
+    {
+      if (val_s < 0)
+        throw Mysqlx_exception("Numeric overflow");
+      val_u = (uint64_t)val_s;
+    }
+    ((uint64_t*)m_buf)[row] = val_u;
+    break;
+
+  case MYSQLX_TYPE_DOUBLE:
+    ((double*)m_buf)[row] = val_d;
+    break;
+
+  case MYSQLX_TYPE_FLOAT:
+    if (
+      val_d > std::numeric_limits<float>::max()
+      || val_d < std::numeric_limits<float>::lowest()
+    )
+      throw Mysqlx_exception("Numeric overflow");
+    ((float*)m_buf)[row] = (float)val_d;
+    break;
+  }
+
+  if (m_lengths)
+    m_lengths[row] = m_elem_size;
+}
+
+
 const char * mysqlx_result_struct::get_next_doc_id()
 {
   if (m_current_id_index >= m_guids.size())
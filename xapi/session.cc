@@ -43,7 +43,14 @@ mysqlx_session_struct::mysqlx_session_struct(
 {
   cdk::ds::Multi_source ds;
   opt->get_data_source(ds);
-  m_impl = std::make_shared<common::Session_impl>(ds);
+  m_impl = std::make_shared<common::Session_impl>(ds, *opt);
+}
+
+
+mysqlx_session_struct::mysqlx_session_struct(mysqlx_client_struct *cli)
+{
+  assert(cli);
+  m_impl = cli->m_impl->get_session();
 }
 
 
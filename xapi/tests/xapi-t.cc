@@ -152,6 +152,156 @@ TEST_F(xapi, store_result_find)
 }
 
 
+TEST_F(xapi, stream_result)
+{
+  SKIP_IF_NO_XPLUGIN
+
+  mysqlx_stmt_t *stmt;
+  mysqlx_result_t *res;
+  mysqlx_row_t *row;
+  const char *query = "SELECT 1 UNION SELECT 2 UNION SELECT 3";
+
+  AUTHENTICATE();
+
+  // Rows released explicitly with mysqlx_row_free()
+
+  RESULT_CHECK(stmt = mysqlx_sql_new(get_session(), query, strlen(query)));
+  CRUD_CHECK(res = mysqlx_execute(stmt), stmt);
+
+  int64_t expected = 1;
+  while ((row = mysqlx_row_fetch_one(res)) != NULL)
+  {
+    int64_t val = 0;
+    EXPECT_EQ(RESULT_OK, mysqlx_get_sint(row, 0, &val));
+    EXPECT_EQ(expected++, val);
+    mysqlx_row_free(row);
+  }
+  EXPECT_EQ(4, expected);
+
+  // Streaming mode
+
+  CRUD_CHECK(res = mysqlx_execute(stmt), stmt);
+  EXPECT_EQ(RESULT_OK, mysqlx_stream_result(res));
+
+  expected = 1;
+  while ((row = mysqlx_row_fetch_one(res)) != NULL)
+  {
+    int64_t val = 0;
+    EXPECT_EQ(RESULT_OK, mysqlx_get_sint(row, 0, &val));
+    EXPECT_EQ(expected++, val);
+  }
+  EXPECT_EQ(4, expected);
+
+  // Streaming mode requires a data set
+
+  query = "DO 1";
+  RESULT_CHECK(stmt = mysqlx_sql_new(get_session(), query, strlen(query)));
+  CRUD_CHECK(res = mysqlx_execute(stmt), stmt);
+  EXPECT_EQ(RESULT_ERROR, mysqlx_stream_result(res));
+  printf("\n Expected error: %s", mysqlx_error_message(res));
+}
+
+
+TEST_F(xapi, fetch_bound)
+{
+  SKIP_IF_NO_XPLUGIN
+
+  mysqlx_stmt_t *stmt;
+  mysqlx_result_t *res;
+  const char *query =
+    "SELECT 1, 'abc', 1.5e0 UNION SELECT -2, 'defghi', NULL "
+    "UNION SELECT 3, NULL, 3.25e0";
+
+  AUTHENTICATE();
+
+  RESULT_CHECK(stmt = mysqlx_sql_new(get_session(), query, strlen(query)));
+  CRUD_CHECK(res = mysqlx_execute(stmt), stmt);
+
+  int64_t col1[2];
+  char col2[2][5];
+  size_t col2_len[2];
+  bool col2_null[2];
+  double col3[2];
+  bool col3_null[2];
+
+  EXPECT_EQ(RESULT_OK, mysqlx_bind_column(res, 0, MYSQLX_TYPE_SINT,
+                                          col1, 0, NULL, NULL));
+  EXPECT_EQ(RESULT_OK, mysqlx_bind_column(res, 1, MYSQLX_TYPE_BYTES,
+                                          col2, sizeof(col2[0]),
+                                          col2_len, col2_null));
+  EXPECT_EQ(RESULT_OK, mysqlx_bind_column(res, 2, MYSQLX_TYPE_DOUBLE,
+                                          col3, 0, NULL, col3_null));
+
+  // Unsupported bindings
+
+  EXPECT_EQ(RESULT_ERROR, mysqlx_bind_column(res, 1, MYSQLX_TYPE_SINT,
+                                             col1, 0, NULL, NULL));
+  printf("\n Expected error: %s", mysqlx_error_message(res));
+  EXPECT_EQ(RESULT_ERROR, mysqlx_bind_column(res, 3, MYSQLX_TYPE_SINT,
+                                             col1, 0, NULL, NULL));
+  printf("\n Expected error: %s", mysqlx_error_message(res));
+
+  uint32_t rows = 0;
+
+  EXPECT_EQ(RESULT_OK, mysqlx_fetch_bound(res, 2, &rows));
+  EXPECT_EQ(2U, rows);
+
+  EXPECT_EQ(1, col1[0]);
+  EXPECT_EQ(-2, col1[1]);
+  EXPECT_FALSE(col2_null[0]);
+  EXPECT_EQ(4U, col2_len[0]);  // Note: includes the '\0' terminator
+  EXPECT_STREQ("abc", col2[0]);
+  EXPECT_FALSE(col2_null[1]);
+  EXPECT_EQ(7U, col2_len[1]);  // truncated
+  EXPECT_EQ(0, strncmp("defgh", col2[1], 5));
+  EXPECT_FALSE(col3_null[0]);
+  EXPECT_EQ(1.5, col3[0]);
+  EXPECT_TRUE(col3_null[1]);
+
+  EXPECT_EQ(RESULT_OK, mysqlx_fetch_bound(res, 2, &rows));
+  EXPECT_EQ(1U, rows);
+
+  EXPECT_EQ(3, col1[0]);
+  EXPECT_TRUE(col2_null[0]);
+  EXPECT_EQ(0U, col2_len[0]);
+  EXPECT_EQ(3.25, col3[0]);
+
+  EXPECT_EQ(RESULT_NULL, mysqlx_fetch_bound(res, 2, &rows));
+  EXPECT_EQ(0U, rows);
+
+  /*
+    Conversion error in the middle of a batch: rows before the failing one
+    are returned and the error is reported by the next call.
+  */
+
+  query =
+    "SELECT CAST(1 AS UNSIGNED) UNION ALL "
+    "SELECT CAST(18446744073709551615 AS UNSIGNED) UNION ALL "
+    "SELECT CAST(3 AS UNSIGNED)";
+
+  RESULT_CHECK(stmt = mysqlx_sql_new(get_session(), query, strlen(query)));
+  CRUD_CHECK(res = mysqlx_execute(stmt), stmt);
+
+  int64_t val[3];
+
+  EXPECT_EQ(RESULT_OK, mysqlx_bind_column(res, 0, MYSQLX_TYPE_SINT,
+                                          val, 0, NULL, NULL));
+
+  EXPECT_EQ(RESULT_OK, mysqlx_fetch_bound(res, 3, &rows));
+  EXPECT_EQ(1U, rows);
+  EXPECT_EQ(1, val[0]);
+
+  EXPECT_EQ(RESULT_ERROR, mysqlx_fetch_bound(res, 3, &rows));
+  printf("\n Expected error: %s", mysqlx_error_message(res));
+
+  EXPECT_EQ(RESULT_OK, mysqlx_fetch_bound(res, 3, &rows));
+  EXPECT_EQ(1U, rows);
+  EXPECT_EQ(3, val[0]);
+
+  EXPECT_EQ(RESULT_NULL, mysqlx_fetch_bound(res, 3, &rows));
+}
+
+
 TEST_F(xapi, next_result)
 {
   SKIP_IF_NO_XPLUGIN
@@ -1144,6 +1294,66 @@ TEST_F(xapi, conn_options_atomic)
 }
 
 
+TEST_F(xapi, client_pool)
+{
+  SKIP_IF_NO_XPLUGIN
+
+  char conn_error[MYSQLX_MAX_ERROR_LEN] = { 0 };
+  int conn_err_code = 0;
+  mysqlx_session_options_t *opt = mysqlx_session_options_new();
+  mysqlx_client_t *cli;
+  mysqlx_session_t *sess1, *sess2;
+  mysqlx_result_t *res;
+  mysqlx_row_t *row;
+  uint64_t id1 = 0, id2 = 0;
+
+  EXPECT_EQ(RESULT_OK, mysqlx_session_option_set(opt,
+                       OPT_HOST(m_xplugin_host),
+                       OPT_PORT(m_port),
+                       OPT_USER(m_xplugin_usr),
+                       OPT_POOL_MAX_SIZE(1),
+                       OPT_POOL_QUEUE_TIMEOUT(500),
+                       PARAM_END));
+
+  if (m_xplugin_pwd)
+    EXPECT_EQ(RESULT_OK, mysqlx_session_option_set(opt,
+                         OPT_PWD(m_xplugin_pwd), PARAM_END));
+
+  cli = mysqlx_get_client_from_options(opt, conn_error, &conn_err_code);
+  mysqlx_free_options(opt);
+
+  if (!cli)
+    FAIL() << "Could not create client: " << conn_error;
+
+  EXPECT_TRUE((sess1 = mysqlx_get_session_from_client(cli)) != NULL);
+  EXPECT_TRUE((res = mysqlx_sql(sess1, "SET @pool_var = 1",
+                                MYSQLX_NULL_TERMINATED)) != NULL);
+  EXPECT_TRUE((res = mysqlx_sql(sess1, "SELECT CONNECTION_ID()",
+                                MYSQLX_NULL_TERMINATED)) != NULL);
+  EXPECT_TRUE((row = mysqlx_row_fetch_one(res)) != NULL);
+  EXPECT_EQ(RESULT_OK, mysqlx_get_uint(row, 0, &id1));
+
+  // Pool is full, the queue timeout expires.
+
+  EXPECT_EQ(NULL, mysqlx_get_session_from_client(cli));
+  printf("\nExpected error: %s\n", mysqlx_error_message(cli));
+
+  // Connection is re-used after session is closed, with reset state.
+
+  mysqlx_session_close(sess1);
+  EXPECT_TRUE((sess2 = mysqlx_get_session_from_client(cli)) != NULL);
+  EXPECT_TRUE((res = mysqlx_sql(sess2, "SELECT CONNECTION_ID(), @pool_var",
+                                MYSQLX_NULL_TERMINATED)) != NULL);
+  EXPECT_TRUE((row = mysqlx_row_fetch_one(res)) != NULL);
+  EXPECT_EQ(RESULT_OK, mysqlx_get_uint(row, 0, &id2));
+  EXPECT_EQ(id1, id2);
+  EXPECT_EQ(RESULT_NULL, mysqlx_get_sint(row, 1, NULL));
+
+  mysqlx_session_close(sess2);
+  mysqlx_client_close(cli);
+}
+
+
 TEST_F(xapi, default_db_test)
 {
   SKIP_IF_NO_XPLUGIN
@@ -2641,17 +2641,40 @@ TEST_F(xapi, test_decimal_type)
       EXPECT_EQ(RESULT_ERROR, mysqlx_get_float(row, 2, &f2));
 
     EXPECT_EQ(RESULT_OK, mysqlx_get_double(row, 2, &d2));
+
+    // Exact values
+
+    mysqlx_decimal_t dec;
+    EXPECT_EQ(RESULT_OK, mysqlx_get_decimal(row, 1, &dec));
+    EXPECT_EQ(10, dec.scale);
+
+    if (row_num < 5)
+      EXPECT_EQ(RESULT_OK, mysqlx_get_decimal(row, 2, &dec));
+    else
+      EXPECT_EQ(RESULT_ERROR, mysqlx_get_decimal(row, 2, &dec));
+
+    EXPECT_EQ(RESULT_OK, mysqlx_get_decimal(row, 1, &dec));
+
     switch (row_num)
     {
     case 1:
+      EXPECT_TRUE(dec.negative);
+      EXPECT_EQ(0U, dec.high);
+      EXPECT_EQ(7869876543219ULL, dec.low);
       EXPECT_TRUE(f == -786.9876543219F);
       EXPECT_TRUE(d > -786.987654322L && d < -786.987654321L);
       break;
     case 2:
+      EXPECT_FALSE(dec.negative);
+      EXPECT_EQ(0U, dec.high);
+      EXPECT_EQ(100000012340ULL, dec.low);
       EXPECT_TRUE(f == 10.000001234F);
       EXPECT_TRUE(d > 10.000001230L && d < 10.000001240L);
       break;
     case 3:
+      // 25 digits which do not fit in 64 bits
+      EXPECT_FALSE(dec.negative);
+      EXPECT_NE(0U, dec.high);
       EXPECT_TRUE(f == 999999999999999.5F);
       EXPECT_TRUE(d > 999999999999999.4L && d < 999999999999999.6L);
       break;